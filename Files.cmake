@@ -1,5 +1,7 @@
 LIST (APPEND msgpackc_SOURCES
+    src/memory_pool.c
     src/objectc.c
+    src/sbuffer.c
     src/unpack.c
     src/version.c
     src/vrefbuffer.c
@@ -161,6 +163,7 @@ IF (NOT MSGPACK_CXX_ONLY)
     LIST (APPEND msgpackc_HEADERS
         include/msgpack.h
         include/msgpack/gcc_atomic.h
+        include/msgpack/memory_pool.h
         include/msgpack/pack.h
         include/msgpack/pack_define.h
         include/msgpack/pack_template.h
@@ -208,6 +211,7 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/adaptor/cpp17/byte.hpp
         include/msgpack/adaptor/cpp17/carray_byte.hpp
         include/msgpack/adaptor/cpp17/optional.hpp
+        include/msgpack/adaptor/cpp17/pmr.hpp
         include/msgpack/adaptor/cpp17/string_view.hpp
         include/msgpack/adaptor/cpp17/vector_byte.hpp
         include/msgpack/adaptor/define.hpp
@@ -247,13 +251,21 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/cpp_config_decl.hpp
         include/msgpack/create_object_visitor.hpp
         include/msgpack/create_object_visitor_decl.hpp
+        include/msgpack/decode.hpp
+        include/msgpack/decode_decl.hpp
         include/msgpack/fbuffer.hpp
         include/msgpack/fbuffer_decl.hpp
+        include/msgpack/fdbuffer.hpp
+        include/msgpack/fdbuffer_decl.hpp
         include/msgpack/gcc_atomic.hpp
         include/msgpack/iterator.hpp
         include/msgpack/iterator_decl.hpp
+        include/msgpack/memory_pool.hpp
+        include/msgpack/memory_pool_decl.hpp
         include/msgpack/meta.hpp
         include/msgpack/meta_decl.hpp
+        include/msgpack/mmap_unpacker.hpp
+        include/msgpack/mmap_unpacker_decl.hpp
         include/msgpack/null_visitor.hpp
         include/msgpack/null_visitor_decl.hpp
         include/msgpack/object.hpp
@@ -262,9 +274,17 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/object_fwd_decl.hpp
         include/msgpack/pack.hpp
         include/msgpack/pack_decl.hpp
+        include/msgpack/packed_size.hpp
+        include/msgpack/packed_size_decl.hpp
+        include/msgpack/parallel_unpack.hpp
+        include/msgpack/parallel_unpack_decl.hpp
+        include/msgpack/parallel_zbuffer.hpp
+        include/msgpack/parallel_zbuffer_decl.hpp
         include/msgpack/parse.hpp
         include/msgpack/parse_decl.hpp
         include/msgpack/parse_return.hpp
+        include/msgpack/pmr.hpp
+        include/msgpack/pmr_decl.hpp
         include/msgpack/preprocessor.hpp
         include/msgpack/preprocessor/arithmetic.hpp
         include/msgpack/preprocessor/arithmetic/add.hpp
@@ -535,11 +555,17 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/preprocessor/variadic/to_tuple.hpp
         include/msgpack/preprocessor/while.hpp
         include/msgpack/preprocessor/wstringize.hpp
+        include/msgpack/projection.hpp
+        include/msgpack/projection_decl.hpp
         include/msgpack/sbuffer.hpp
         include/msgpack/sbuffer_decl.hpp
         include/msgpack/type.hpp
+        include/msgpack/typed_array.hpp
+        include/msgpack/typed_array_decl.hpp
         include/msgpack/unpack.hpp
         include/msgpack/unpack_decl.hpp
+        include/msgpack/unpack_exact.hpp
+        include/msgpack/unpack_exact_decl.hpp
         include/msgpack/unpack_exception.hpp
         include/msgpack/v1/adaptor/adaptor_base.hpp
         include/msgpack/v1/adaptor/adaptor_base_decl.hpp
@@ -571,6 +597,7 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/v1/adaptor/cpp17/byte.hpp
         include/msgpack/v1/adaptor/cpp17/carray_byte.hpp
         include/msgpack/v1/adaptor/cpp17/optional.hpp
+        include/msgpack/v1/adaptor/cpp17/pmr.hpp
         include/msgpack/v1/adaptor/cpp17/string_view.hpp
         include/msgpack/v1/adaptor/cpp17/vector_byte.hpp
         include/msgpack/v1/adaptor/define.hpp
@@ -625,10 +652,15 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/v1/detail/cpp03_zone_decl.hpp
         include/msgpack/v1/detail/cpp11_zone.hpp
         include/msgpack/v1/detail/cpp11_zone_decl.hpp
+        include/msgpack/v1/detail/embed_stack.hpp
         include/msgpack/v1/fbuffer.hpp
         include/msgpack/v1/fbuffer_decl.hpp
+        include/msgpack/v1/fdbuffer.hpp
+        include/msgpack/v1/fdbuffer_decl.hpp
         include/msgpack/v1/iterator.hpp
         include/msgpack/v1/iterator_decl.hpp
+        include/msgpack/v1/memory_pool.hpp
+        include/msgpack/v1/memory_pool_decl.hpp
         include/msgpack/v1/meta.hpp
         include/msgpack/v1/meta_decl.hpp
         include/msgpack/v1/object.hpp
@@ -637,7 +669,13 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/v1/object_fwd_decl.hpp
         include/msgpack/v1/pack.hpp
         include/msgpack/v1/pack_decl.hpp
+        include/msgpack/v1/packed_size.hpp
+        include/msgpack/v1/packed_size_decl.hpp
+        include/msgpack/v1/parallel_zbuffer.hpp
+        include/msgpack/v1/parallel_zbuffer_decl.hpp
         include/msgpack/v1/parse_return.hpp
+        include/msgpack/v1/pmr.hpp
+        include/msgpack/v1/pmr_decl.hpp
         include/msgpack/v1/preprocessor.hpp
         include/msgpack/v1/sbuffer.hpp
         include/msgpack/v1/sbuffer_decl.hpp
@@ -652,6 +690,8 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/v1/zbuffer_decl.hpp
         include/msgpack/v1/zone.hpp
         include/msgpack/v1/zone_decl.hpp
+        include/msgpack/v1/zunpacker.hpp
+        include/msgpack/v1/zunpacker_decl.hpp
         include/msgpack/v2/adaptor/adaptor_base.hpp
         include/msgpack/v2/adaptor/adaptor_base_decl.hpp
         include/msgpack/v2/adaptor/array_ref_decl.hpp
@@ -676,11 +716,17 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/v2/cpp_config_decl.hpp
         include/msgpack/v2/create_object_visitor.hpp
         include/msgpack/v2/create_object_visitor_decl.hpp
+        include/msgpack/v2/decode.hpp
+        include/msgpack/v2/decode_decl.hpp
         include/msgpack/v2/detail/cpp03_zone_decl.hpp
         include/msgpack/v2/detail/cpp11_zone_decl.hpp
         include/msgpack/v2/fbuffer_decl.hpp
+        include/msgpack/v2/fdbuffer_decl.hpp
         include/msgpack/v2/iterator_decl.hpp
+        include/msgpack/v2/memory_pool_decl.hpp
         include/msgpack/v2/meta_decl.hpp
+        include/msgpack/v2/mmap_unpacker.hpp
+        include/msgpack/v2/mmap_unpacker_decl.hpp
         include/msgpack/v2/null_visitor.hpp
         include/msgpack/v2/null_visitor_decl.hpp
         include/msgpack/v2/object.hpp
@@ -688,12 +734,26 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/v2/object_fwd.hpp
         include/msgpack/v2/object_fwd_decl.hpp
         include/msgpack/v2/pack_decl.hpp
+        include/msgpack/v2/packed_size_decl.hpp
+        include/msgpack/v2/parallel_unpack.hpp
+        include/msgpack/v2/parallel_unpack_decl.hpp
+        include/msgpack/v2/parallel_zbuffer_decl.hpp
         include/msgpack/v2/parse.hpp
         include/msgpack/v2/parse_decl.hpp
         include/msgpack/v2/parse_return.hpp
+        include/msgpack/v2/pmr_decl.hpp
+        include/msgpack/v2/projection.hpp
+        include/msgpack/v2/projection_decl.hpp
+        include/msgpack/v2/sbuffer.hpp
         include/msgpack/v2/sbuffer_decl.hpp
+        include/msgpack/v2/typed_array.hpp
+        include/msgpack/v2/typed_array_decl.hpp
         include/msgpack/v2/unpack.hpp
         include/msgpack/v2/unpack_decl.hpp
+        include/msgpack/v2/unpack_exact.hpp
+        include/msgpack/v2/unpack_exact_decl.hpp
+        include/msgpack/v2/view.hpp
+        include/msgpack/v2/view_decl.hpp
         include/msgpack/v2/vrefbuffer_decl.hpp
         include/msgpack/v2/x3_parse.hpp
         include/msgpack/v2/x3_parse_decl.hpp
@@ -701,6 +761,7 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/v2/x3_unpack_decl.hpp
         include/msgpack/v2/zbuffer_decl.hpp
         include/msgpack/v2/zone_decl.hpp
+        include/msgpack/v2/zunpacker_decl.hpp
         include/msgpack/v3/adaptor/adaptor_base.hpp
         include/msgpack/v3/adaptor/adaptor_base_decl.hpp
         include/msgpack/v3/adaptor/array_ref_decl.hpp
@@ -724,30 +785,46 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/v3/adaptor/v4raw_decl.hpp
         include/msgpack/v3/cpp_config_decl.hpp
         include/msgpack/v3/create_object_visitor_decl.hpp
+        include/msgpack/v3/decode_decl.hpp
         include/msgpack/v3/detail/cpp03_zone_decl.hpp
         include/msgpack/v3/detail/cpp11_zone_decl.hpp
         include/msgpack/v3/fbuffer_decl.hpp
+        include/msgpack/v3/fdbuffer_decl.hpp
         include/msgpack/v3/iterator_decl.hpp
+        include/msgpack/v3/memory_pool_decl.hpp
         include/msgpack/v3/meta_decl.hpp
+        include/msgpack/v3/mmap_unpacker_decl.hpp
         include/msgpack/v3/null_visitor_decl.hpp
         include/msgpack/v3/object_decl.hpp
         include/msgpack/v3/object_fwd.hpp
         include/msgpack/v3/object_fwd_decl.hpp
         include/msgpack/v3/pack_decl.hpp
+        include/msgpack/v3/packed_size_decl.hpp
+        include/msgpack/v3/parallel_unpack_decl.hpp
+        include/msgpack/v3/parallel_zbuffer_decl.hpp
         include/msgpack/v3/parse.hpp
         include/msgpack/v3/parse_decl.hpp
         include/msgpack/v3/parse_return.hpp
+        include/msgpack/v3/pmr_decl.hpp
+        include/msgpack/v3/projection_decl.hpp
+        include/msgpack/v3/sbuffer.hpp
         include/msgpack/v3/sbuffer_decl.hpp
+        include/msgpack/v3/typed_array_decl.hpp
         include/msgpack/v3/unpack.hpp
         include/msgpack/v3/unpack_decl.hpp
+        include/msgpack/v3/unpack_exact_decl.hpp
+        include/msgpack/v3/view_decl.hpp
         include/msgpack/v3/vrefbuffer_decl.hpp
         include/msgpack/v3/x3_parse_decl.hpp
         include/msgpack/v3/x3_unpack.hpp
         include/msgpack/v3/x3_unpack_decl.hpp
         include/msgpack/v3/zbuffer_decl.hpp
         include/msgpack/v3/zone_decl.hpp
+        include/msgpack/v3/zunpacker_decl.hpp
         include/msgpack/version.hpp
         include/msgpack/versioning.hpp
+        include/msgpack/view.hpp
+        include/msgpack/view_decl.hpp
         include/msgpack/vrefbuffer.hpp
         include/msgpack/vrefbuffer_decl.hpp
         include/msgpack/x3_parse.hpp
@@ -758,5 +835,7 @@ IF (MSGPACK_ENABLE_CXX)
         include/msgpack/zbuffer_decl.hpp
         include/msgpack/zone.hpp
         include/msgpack/zone_decl.hpp
+        include/msgpack/zunpacker.hpp
+        include/msgpack/zunpacker_decl.hpp
     )
 ENDIF ()
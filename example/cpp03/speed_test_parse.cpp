@@ -0,0 +1,280 @@
+// MessagePack for C++ example
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+
+// g++ -std=c++11 -O3 -g -Ipath_to_msgpack_src -Ipath_to_boost speed_test_parse.cpp -Lpath_to_boost_lib -lboost_timer -lboost_system
+// export LD_LIBRARY_PATH=path_to_boost_lib
+//
+// ./speed_test_parse [path_to/cases.mpac]
+//
+// bench() measures msgpack::unpack(), msgpack::parse() with null_visitor
+// and msgpack::skip() that parses without a visitor.
+// On C++11 or later, float64_visitor and typed_array_visitor compare
+// visit_float64() for each element with visit_float64_array().
+// bench_projection() compares msgpack::unpack() with projection_visitor
+// that creates only 3 fields of a map that has 200 keys.
+// On C++11 or later, bench_decode() compares msgpack::unpack() and as<T>()
+// with msgpack::decode() that writes to T directly.
+
+#include <msgpack.hpp>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <vector>
+#include <boost/timer/timer.hpp>
+
+static std::size_t const loop = 200;
+
+void bench(std::string const& name, std::string const& str) {
+    std::cout << "[TEST][" << name << "] " << str.size() << " bytes x " << loop << std::endl;
+
+    std::cout << "Start unpacking...by msgpack::unpack()" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != loop; ++i) {
+            std::size_t off = 0;
+            while (off != str.size()) {
+                msgpack::object_handle oh;
+                msgpack::unpack(oh, str.data(), str.size(), off);
+            }
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+    std::cout << "Start parsing...by msgpack::parse() with null_visitor" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != loop; ++i) {
+            std::size_t off = 0;
+            while (off != str.size()) {
+                msgpack::null_visitor v;
+                msgpack::parse(str.data(), str.size(), off, v);
+            }
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+    std::cout << "Start skipping...by msgpack::skip()" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != loop; ++i) {
+            std::size_t off = 0;
+            while (off != str.size()) {
+                msgpack::skip(str.data(), str.size(), off);
+            }
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+}
+
+#if !defined(MSGPACK_USE_CPP03)
+
+struct float64_visitor : msgpack::null_visitor {
+    bool start_array(uint32_t num_elements) {
+        v.clear();
+        v.reserve(num_elements);
+        return true;
+    }
+    bool visit_float64(double d) {
+        v.push_back(d);
+        return true;
+    }
+    std::vector<double> v;
+};
+
+struct typed_array_visitor : float64_visitor {
+    bool visit_float64_array(const char* data, uint32_t num_elements) {
+        v.resize(num_elements);
+        msgpack::decode_float64_array(&v[0], data, num_elements);
+        return true;
+    }
+};
+
+void bench_float64_array() {
+    std::vector<double> v(1000000);
+    for (std::size_t i = 0; i != v.size(); ++i) {
+        v[i] = static_cast<double>(i) * 0.5;
+    }
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string str = ss.str();
+    std::size_t const loop = 20;
+    std::cout << "[TEST][float64_array] " << str.size() << " bytes x " << loop << std::endl;
+
+    std::cout << "Start unpacking...by msgpack::unpack() and as<std::vector<double> >()" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != loop; ++i) {
+            msgpack::object_handle oh = msgpack::unpack(str.data(), str.size());
+            std::vector<double> result = oh.get().as<std::vector<double> >();
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+    std::cout << "Start parsing...by msgpack::parse() with visit_float64()" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != loop; ++i) {
+            float64_visitor fv;
+            msgpack::parse(str.data(), str.size(), fv);
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+    std::cout << "Start parsing...by msgpack::parse() with visit_float64_array()" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != loop; ++i) {
+            typed_array_visitor tv;
+            msgpack::parse(str.data(), str.size(), tv);
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+}
+
+struct record {
+    int id;
+    std::string name;
+    std::vector<double> values;
+    std::map<std::string, int> attrs;
+    MSGPACK_DEFINE_MAP(id, name, values, attrs);
+};
+
+void bench_decode() {
+    std::vector<record> v(10000);
+    for (std::size_t i = 0; i != v.size(); ++i) {
+        v[i].id = static_cast<int>(i);
+        v[i].name = "record";
+        v[i].values.assign(8, 0.5 * static_cast<double>(i));
+        v[i].attrs["a"] = 1;
+        v[i].attrs["b"] = 2;
+    }
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string str = ss.str();
+    std::size_t const num = 20;
+    std::cout << "[TEST][decode] " << str.size() << " bytes x " << num << std::endl;
+
+    std::cout << "Start unpacking...by msgpack::unpack() and as<std::vector<record> >()" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != num; ++i) {
+            msgpack::object_handle oh = msgpack::unpack(str.data(), str.size());
+            std::vector<record> r = oh.get().as<std::vector<record> >();
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+    std::cout << "Start decoding...by msgpack::decode()" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != num; ++i) {
+            std::vector<record> r;
+            msgpack::decode(str.data(), str.size(), r);
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+struct field_counter {
+    field_counter(std::size_t& count):m_count(count) {}
+    void operator()(std::size_t, msgpack::object const&) const { ++m_count; }
+    std::size_t& m_count;
+};
+
+void bench_projection() {
+    std::map<std::string, std::vector<int> > m;
+    for (int i = 0; i != 200; ++i) {
+        std::stringstream key;
+        key << "key" << i;
+        m[key.str()] = std::vector<int>(8, i);
+    }
+    std::stringstream ss;
+    msgpack::pack(ss, m);
+    std::string str = ss.str();
+    std::size_t const num = 10000;
+    std::cout << "[TEST][projection] " << str.size() << " bytes x " << num << std::endl;
+
+    std::cout << "Start unpacking...by msgpack::unpack()" << std::endl;
+    {
+        boost::timer::cpu_timer timer;
+        for (std::size_t i = 0; i != num; ++i) {
+            msgpack::object_handle oh = msgpack::unpack(str.data(), str.size());
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+    std::cout << "Start parsing...by msgpack::parse() with projection_visitor" << std::endl;
+    {
+        msgpack::projection p;
+        p.add("key10");
+        p.add("key100[0]");
+        p.add("key150");
+        boost::timer::cpu_timer timer;
+        std::size_t count = 0;
+        msgpack::zone z;
+        for (std::size_t i = 0; i != num; ++i) {
+            z.clear();
+            msgpack::projection_visitor<field_counter> v(p, z, field_counter(count));
+            msgpack::parse(str.data(), str.size(), v);
+        }
+        std::string result = timer.format();
+        std::cout << result << std::endl;
+    }
+}
+
+std::string make_int_map() {
+    std::vector<std::map<int, int> > v(10000);
+    for (std::size_t i = 0; i != v.size(); ++i) {
+        for (int j = 0; j != 8; ++j) {
+            v[i][j] = static_cast<int>(i) * j - 1000;
+        }
+    }
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    return ss.str();
+}
+
+std::string make_str_map() {
+    std::vector<std::map<std::string, std::string> > v(10000);
+    for (std::size_t i = 0; i != v.size(); ++i) {
+        v[i]["id"] = "0123456789";
+        v[i]["name"] = "msgpack";
+        v[i]["kind"] = "short";
+        v[i]["note"] = "";
+    }
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    return ss.str();
+}
+
+int main(int argc, char* argv[])
+{
+    char const* path = argc > 1 ? argv[1] : "cases.mpac";
+    std::ifstream ifs(path, std::ios::binary);
+    if (ifs) {
+        std::stringstream ss;
+        ss << ifs.rdbuf();
+        bench(path, ss.str());
+    }
+    else {
+        std::cout << path << " is not found. skipped." << std::endl;
+    }
+    bench("int_map", make_int_map());
+    bench("str_map", make_str_map());
+    bench_projection();
+#if !defined(MSGPACK_USE_CPP03)
+    bench_float64_array();
+    bench_decode();
+#endif // !defined(MSGPACK_USE_CPP03)
+}
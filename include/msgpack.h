@@ -15,6 +15,7 @@
 
 #include "msgpack/util.h"
 #include "msgpack/object.h"
+#include "msgpack/memory_pool.h"
 #include "msgpack/zone.h"
 #include "msgpack/pack.h"
 #include "msgpack/unpack.h"
@@ -9,11 +9,19 @@
 //
 #include "msgpack/object.hpp"
 #include "msgpack/iterator.hpp"
+#include "msgpack/memory_pool.hpp"
 #include "msgpack/zone.hpp"
+#include "msgpack/pmr.hpp"
 #include "msgpack/pack.hpp"
+#include "msgpack/packed_size.hpp"
 #include "msgpack/null_visitor.hpp"
+#include "msgpack/typed_array.hpp"
 #include "msgpack/parse.hpp"
 #include "msgpack/unpack.hpp"
+#include "msgpack/unpack_exact.hpp"
+#include "msgpack/view.hpp"
+#include "msgpack/projection.hpp"
+#include "msgpack/decode.hpp"
 #include "msgpack/x3_parse.hpp"
 #include "msgpack/x3_unpack.hpp"
 #include "msgpack/sbuffer.hpp"
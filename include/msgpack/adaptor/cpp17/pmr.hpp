@@ -0,0 +1,14 @@
+//
+// MessagePack for C++ static resolution routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+
+#ifndef MSGPACK_TYPE_CPP17_PMR_HPP
+#define MSGPACK_TYPE_CPP17_PMR_HPP
+
+#include "msgpack/v1/adaptor/cpp17/pmr.hpp"
+
+#endif // MSGPACK_TYPE_CPP17_PMR_HPP
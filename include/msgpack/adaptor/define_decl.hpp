@@ -39,6 +39,11 @@
     void msgpack_object(MSGPACK_OBJECT* msgpack_o, msgpack::zone& msgpack_z) const \
     { \
         msgpack::type::make_define_array(__VA_ARGS__).msgpack_object(msgpack_o, msgpack_z); \
+    } \
+    template <typename MSGPACK_DECODER> \
+    void msgpack_decode(MSGPACK_DECODER& msgpack_d) \
+    { \
+        msgpack_d.decode_define(msgpack::type::make_define_array(__VA_ARGS__)); \
     }
 
 #define MSGPACK_BASE_ARRAY(base) (*const_cast<base *>(static_cast<base const*>(this)))
@@ -80,6 +85,13 @@
         msgpack::type::make_define_map \
             MSGPACK_DEFINE_MAP_IMPL(__VA_ARGS__) \
             .msgpack_object(msgpack_o, msgpack_z); \
+    } \
+    template <typename MSGPACK_DECODER> \
+    void msgpack_decode(MSGPACK_DECODER& msgpack_d) \
+    { \
+        msgpack_d.decode_define( \
+            msgpack::type::make_define_map \
+                MSGPACK_DEFINE_MAP_IMPL(__VA_ARGS__)); \
     }
 
 #define MSGPACK_BASE_MAP(base) \
@@ -0,0 +1,14 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_DECODE_DECL_HPP
+#define MSGPACK_DECODE_DECL_HPP
+
+#include "msgpack/v2/decode_decl.hpp"
+#include "msgpack/v3/decode_decl.hpp"
+
+#endif // MSGPACK_DECODE_DECL_HPP
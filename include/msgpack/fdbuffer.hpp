@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ file descriptor buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_FDBUFFER_HPP
+#define MSGPACK_FDBUFFER_HPP
+
+#include "msgpack/fdbuffer_decl.hpp"
+
+#include "msgpack/v1/fdbuffer.hpp"
+
+#endif // MSGPACK_FDBUFFER_HPP
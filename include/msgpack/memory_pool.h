@@ -0,0 +1,111 @@
+/*
+ * MessagePack for C memory pool
+ *
+ *    Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *    http://www.boost.org/LICENSE_1_0.txt)
+ */
+#ifndef MSGPACK_MEMORY_POOL_H
+#define MSGPACK_MEMORY_POOL_H
+
+#include "sysdep.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/**
+ * @defgroup msgpack_memory_pool Memory pool
+ * @ingroup msgpack
+ * The per-thread pool of memory blocks. The blocks are grouped by size
+ * classes of powers of 2 from MSGPACK_MEMORY_POOL_MIN_SIZE to
+ * MSGPACK_MEMORY_POOL_MAX_SIZE. While the pool is enabled on a thread,
+ * msgpack_zone_new(), msgpack_zone_free() and the chunks of the zones reuse
+ * the blocks that were freed on the same thread.
+ * The blocks are allocated by malloc(), so they can be freed on any thread.
+ * The pooled blocks are freed when the thread exits if the library is built
+ * with POSIX threads. Otherwise, call msgpack_memory_pool_disable() before
+ * the thread exits, or the pooled blocks are leaked.
+ * If the compiler doesn't support thread local storage, the pool can't be enabled.
+ * @{
+ */
+
+#ifndef MSGPACK_MEMORY_POOL_MIN_SIZE
+#define MSGPACK_MEMORY_POOL_MIN_SIZE 64
+#endif
+
+#ifndef MSGPACK_MEMORY_POOL_MAX_SIZE
+#define MSGPACK_MEMORY_POOL_MAX_SIZE (1024 * 1024)
+#endif
+
+#ifndef MSGPACK_MEMORY_POOL_MAX_BLOCKS
+#define MSGPACK_MEMORY_POOL_MAX_BLOCKS 16
+#endif
+
+typedef struct msgpack_memory_pool_stats {
+    /* allocations that reused a pooled block */
+    size_t hits;
+    /* allocations that called malloc() */
+    size_t misses;
+    /* deallocations that kept the block in the pool */
+    size_t returns;
+    /* deallocations that called free() */
+    size_t discards;
+} msgpack_memory_pool_stats;
+
+/**
+ * Enables the pool on the current thread. Each size class keeps at most
+ * max_blocks blocks. Returns false if the pool isn't supported.
+ */
+MSGPACK_DLLEXPORT
+bool msgpack_memory_pool_enable(size_t max_blocks);
+
+/**
+ * Disables the pool on the current thread and frees the pooled blocks.
+ */
+MSGPACK_DLLEXPORT
+void msgpack_memory_pool_disable(void);
+
+MSGPACK_DLLEXPORT
+bool msgpack_memory_pool_enabled(void);
+
+/**
+ * Returns the counters of the current thread. They are updated only
+ * while the pool is enabled.
+ */
+MSGPACK_DLLEXPORT
+msgpack_memory_pool_stats msgpack_memory_pool_get_stats(void);
+
+MSGPACK_DLLEXPORT
+void msgpack_memory_pool_reset_stats(void);
+
+/**
+ * Returns the smallest size class that is not less than size, or size
+ * itself if it is larger than MSGPACK_MEMORY_POOL_MAX_SIZE.
+ */
+MSGPACK_DLLEXPORT
+size_t msgpack_memory_pool_block_size(size_t size);
+
+/**
+ * Allocates a block of msgpack_memory_pool_block_size(size) bytes.
+ * Returns NULL on failure.
+ */
+MSGPACK_DLLEXPORT
+void* msgpack_memory_pool_malloc(size_t size);
+
+/**
+ * Frees the block that msgpack_memory_pool_malloc() returned. size is
+ * the size that was passed to msgpack_memory_pool_malloc() or a smaller size.
+ */
+MSGPACK_DLLEXPORT
+void msgpack_memory_pool_free(void* p, size_t size);
+
+/** @} */
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* msgpack/memory_pool.h */
@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ memory pool
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_MEMORY_POOL_HPP
+#define MSGPACK_MEMORY_POOL_HPP
+
+#include "msgpack/memory_pool_decl.hpp"
+
+#include "msgpack/v1/memory_pool.hpp"
+
+#endif // MSGPACK_MEMORY_POOL_HPP
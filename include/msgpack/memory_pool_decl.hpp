@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ memory pool
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_MEMORY_POOL_DECL_HPP
+#define MSGPACK_MEMORY_POOL_DECL_HPP
+
+#include "msgpack/v1/memory_pool_decl.hpp"
+#include "msgpack/v2/memory_pool_decl.hpp"
+#include "msgpack/v3/memory_pool_decl.hpp"
+
+#endif // MSGPACK_MEMORY_POOL_DECL_HPP
@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ memory mapped file unpacker
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_MMAP_UNPACKER_HPP
+#define MSGPACK_MMAP_UNPACKER_HPP
+
+#include "msgpack/mmap_unpacker_decl.hpp"
+
+#include "msgpack/v2/mmap_unpacker.hpp"
+
+#endif // MSGPACK_MMAP_UNPACKER_HPP
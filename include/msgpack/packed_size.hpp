@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ serializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_PACKED_SIZE_HPP
+#define MSGPACK_PACKED_SIZE_HPP
+
+#include "msgpack/packed_size_decl.hpp"
+
+#include "msgpack/v1/packed_size.hpp"
+
+#endif // MSGPACK_PACKED_SIZE_HPP
@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_PARALLEL_UNPACK_HPP
+#define MSGPACK_PARALLEL_UNPACK_HPP
+
+#include "msgpack/parallel_unpack_decl.hpp"
+
+#include "msgpack/v2/parallel_unpack.hpp"
+
+#endif // MSGPACK_PARALLEL_UNPACK_HPP
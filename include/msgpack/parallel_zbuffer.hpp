@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ parallel deflate buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_PARALLEL_ZBUFFER_HPP
+#define MSGPACK_PARALLEL_ZBUFFER_HPP
+
+#include "msgpack/parallel_zbuffer_decl.hpp"
+
+#include "msgpack/v1/parallel_zbuffer.hpp"
+
+#endif // MSGPACK_PARALLEL_ZBUFFER_HPP
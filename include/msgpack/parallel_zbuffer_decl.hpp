@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ parallel deflate buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_PARALLEL_ZBUFFER_DECL_HPP
+#define MSGPACK_PARALLEL_ZBUFFER_DECL_HPP
+
+#include "msgpack/v1/parallel_zbuffer_decl.hpp"
+#include "msgpack/v2/parallel_zbuffer_decl.hpp"
+#include "msgpack/v3/parallel_zbuffer_decl.hpp"
+
+#endif // MSGPACK_PARALLEL_ZBUFFER_DECL_HPP
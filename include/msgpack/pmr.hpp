@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ std::pmr::memory_resource adapter
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_PMR_HPP
+#define MSGPACK_PMR_HPP
+
+#include "msgpack/pmr_decl.hpp"
+
+#include "msgpack/v1/pmr.hpp"
+
+#endif // MSGPACK_PMR_HPP
@@ -10,6 +10,7 @@
 #ifndef MSGPACK_SBUFFER_H
 #define MSGPACK_SBUFFER_H
 
+#include "sysdep.h"
 #include <stdlib.h>
 #include <string.h>
 
@@ -56,17 +57,90 @@ static inline void msgpack_sbuffer_free(msgpack_sbuffer* sbuf)
 #define MSGPACK_SBUFFER_INIT_SIZE 8192
 #endif
 
-static inline int msgpack_sbuffer_write(void* data, const char* buf, size_t len)
+/**
+ * The memory allocator of msgpack_sbuffer_ex.
+ * reallocate resizes the memory at ptr from old_size bytes to new_size bytes
+ * keeping the contents, and returns the new address. ptr is NULL and old_size
+ * is 0 at the first allocation. It returns NULL on failure and the memory is kept.
+ * deallocate frees the memory of size bytes at ptr, that is not NULL.
+ */
+typedef struct msgpack_sbuffer_allocator {
+    void* (*reallocate)(void* data, void* ptr, size_t old_size, size_t new_size);
+    void (*deallocate)(void* data, void* ptr, size_t size);
+    void* data;
+} msgpack_sbuffer_allocator;
+
+/**
+ * Returns the allocator that uses anonymous mappings. The buffer is grown
+ * by mremap(), so the contents are not copied. Huge pages are requested by
+ * madvise() if they are supported. Each allocation takes at least a page.
+ * Returns NULL if the library is built without mremap() support.
+ */
+MSGPACK_DLLEXPORT
+const msgpack_sbuffer_allocator* msgpack_sbuffer_mmap_allocator(void);
+
+/**
+ * The simple buffer with a growth policy and an allocator.
+ * buf is accessed in the same way as msgpack_sbuffer, and
+ * msgpack_sbuffer_release() and msgpack_sbuffer_clear() can be applied to it.
+ * The buffer released from it should be freed by the allocator.
+ */
+typedef struct msgpack_sbuffer_ex {
+    msgpack_sbuffer buf;
+    /* The maximum bytes that an expansion adds. 0 means no limit. */
+    size_t grow_limit;
+    /* NULL means realloc() and free(). */
+    const msgpack_sbuffer_allocator* allocator;
+} msgpack_sbuffer_ex;
+
+static inline void msgpack_sbuffer_deallocate_with(msgpack_sbuffer* sbuf,
+        const msgpack_sbuffer_allocator* allocator)
+{
+    if(allocator == NULL) {
+        free(sbuf->data);
+    } else if(sbuf->data != NULL) {
+        allocator->deallocate(allocator->data, sbuf->data, sbuf->alloc);
+    }
+}
+
+static inline int msgpack_sbuffer_reallocate_with(msgpack_sbuffer* sbuf,
+        const msgpack_sbuffer_allocator* allocator, size_t nsize)
 {
-    msgpack_sbuffer* sbuf = (msgpack_sbuffer*)data;
+    void* tmp;
+
+    if(nsize == 0) {
+        msgpack_sbuffer_deallocate_with(sbuf, allocator);
+        sbuf->data = NULL;
+        sbuf->alloc = 0;
+        return 0;
+    }
 
+    if(allocator == NULL) {
+        tmp = realloc(sbuf->data, nsize);
+    } else {
+        tmp = allocator->reallocate(allocator->data, sbuf->data, sbuf->alloc, nsize);
+    }
+    if(!tmp) { return -1; }
+
+    sbuf->data = (char*)tmp;
+    sbuf->alloc = nsize;
+    return 0;
+}
+
+static inline size_t msgpack_sbuffer_next_size(size_t grow_limit, size_t n)
+{
+    return n + ((grow_limit != 0 && n > grow_limit) ? grow_limit : n);
+}
+
+static inline int msgpack_sbuffer_write_with(msgpack_sbuffer* sbuf, size_t grow_limit,
+        const msgpack_sbuffer_allocator* allocator, const char* buf, size_t len)
+{
     if(sbuf->alloc - sbuf->size < len) {
-        void* tmp;
         size_t nsize = (sbuf->alloc) ?
-                sbuf->alloc * 2 : MSGPACK_SBUFFER_INIT_SIZE;
+                msgpack_sbuffer_next_size(grow_limit, sbuf->alloc) : MSGPACK_SBUFFER_INIT_SIZE;
 
         while(nsize < sbuf->size + len) {
-            size_t tmp_nsize = nsize * 2;
+            size_t tmp_nsize = msgpack_sbuffer_next_size(grow_limit, nsize);
             if (tmp_nsize <= nsize) {
                 nsize = sbuf->size + len;
                 break;
@@ -74,11 +148,7 @@ static inline int msgpack_sbuffer_write(void* data, const char* buf, size_t len)
             nsize = tmp_nsize;
         }
 
-        tmp = realloc(sbuf->data, nsize);
-        if(!tmp) { return -1; }
-
-        sbuf->data = (char*)tmp;
-        sbuf->alloc = nsize;
+        if(msgpack_sbuffer_reallocate_with(sbuf, allocator, nsize) != 0) { return -1; }
     }
 
     memcpy(sbuf->data + sbuf->size, buf, len);
@@ -86,6 +156,31 @@ static inline int msgpack_sbuffer_write(void* data, const char* buf, size_t len)
     return 0;
 }
 
+static inline int msgpack_sbuffer_write(void* data, const char* buf, size_t len)
+{
+    return msgpack_sbuffer_write_with((msgpack_sbuffer*)data, 0, NULL, buf, len);
+}
+
+/**
+ * Allocates the memory for at least n bytes. Unlike the expansion by
+ * msgpack_sbuffer_write(), exactly n bytes are allocated if the capacity
+ * is less than n. Returns 0 on success and -1 on failure.
+ */
+static inline int msgpack_sbuffer_reserve(msgpack_sbuffer* sbuf, size_t n)
+{
+    if(sbuf->alloc >= n) { return 0; }
+    return msgpack_sbuffer_reallocate_with(sbuf, NULL, n);
+}
+
+/**
+ * Reduces the capacity to the size. Returns 0 on success and -1 on failure.
+ */
+static inline int msgpack_sbuffer_shrink_to_fit(msgpack_sbuffer* sbuf)
+{
+    if(sbuf->alloc == sbuf->size) { return 0; }
+    return msgpack_sbuffer_reallocate_with(sbuf, NULL, sbuf->size);
+}
+
 static inline char* msgpack_sbuffer_release(msgpack_sbuffer* sbuf)
 {
     char* tmp = sbuf->data;
@@ -100,6 +195,49 @@ static inline void msgpack_sbuffer_clear(msgpack_sbuffer* sbuf)
     sbuf->size = 0;
 }
 
+/**
+ * Initializes the buffer with the growth policy and the allocator.
+ * The capacity is doubled until it reaches grow_limit, and then grows by
+ * grow_limit. grow_limit 0 means no limit. allocator NULL means realloc() and free().
+ * The allocator must live until the buffer is destroyed.
+ */
+static inline void msgpack_sbuffer_ex_init(msgpack_sbuffer_ex* sbuf,
+        size_t grow_limit, const msgpack_sbuffer_allocator* allocator)
+{
+    msgpack_sbuffer_init(&sbuf->buf);
+    sbuf->grow_limit = grow_limit;
+    sbuf->allocator = allocator;
+}
+
+static inline void msgpack_sbuffer_ex_destroy(msgpack_sbuffer_ex* sbuf)
+{
+    msgpack_sbuffer_deallocate_with(&sbuf->buf, sbuf->allocator);
+}
+
+static inline int msgpack_sbuffer_ex_write(void* data, const char* buf, size_t len)
+{
+    msgpack_sbuffer_ex* sbuf = (msgpack_sbuffer_ex*)data;
+    return msgpack_sbuffer_write_with(&sbuf->buf, sbuf->grow_limit, sbuf->allocator, buf, len);
+}
+
+/**
+ * The same as msgpack_sbuffer_reserve(), but uses the allocator of the buffer.
+ */
+static inline int msgpack_sbuffer_ex_reserve(msgpack_sbuffer_ex* sbuf, size_t n)
+{
+    if(sbuf->buf.alloc >= n) { return 0; }
+    return msgpack_sbuffer_reallocate_with(&sbuf->buf, sbuf->allocator, n);
+}
+
+/**
+ * The same as msgpack_sbuffer_shrink_to_fit(), but uses the allocator of the buffer.
+ */
+static inline int msgpack_sbuffer_ex_shrink_to_fit(msgpack_sbuffer_ex* sbuf)
+{
+    if(sbuf->buf.alloc == sbuf->buf.size) { return 0; }
+    return msgpack_sbuffer_reallocate_with(&sbuf->buf, sbuf->allocator, sbuf->buf.size);
+}
+
 /** @} */
 
 
@@ -13,5 +13,7 @@
 #include "msgpack/sbuffer_decl.hpp"
 
 #include "msgpack/v1/sbuffer.hpp"
+#include "msgpack/v2/sbuffer.hpp"
+#include "msgpack/v3/sbuffer.hpp"
 
 #endif // MSGPACK_SBUFFER_HPP
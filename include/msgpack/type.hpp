@@ -53,6 +53,10 @@
 #include "adaptor/cpp17/string_view.hpp"
 #endif // MSGPACK_HAS_INCLUDE(<string_view>)
 
+#if MSGPACK_HAS_INCLUDE(<memory_resource>)
+#include "adaptor/cpp17/pmr.hpp"
+#endif // MSGPACK_HAS_INCLUDE(<memory_resource>)
+
 #include "adaptor/cpp17/byte.hpp"
 #include "adaptor/cpp17/carray_byte.hpp"
 #include "adaptor/cpp17/vector_byte.hpp"
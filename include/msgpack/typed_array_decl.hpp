@@ -0,0 +1,14 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_TYPED_ARRAY_DECL_HPP
+#define MSGPACK_TYPED_ARRAY_DECL_HPP
+
+#include "msgpack/v2/typed_array_decl.hpp"
+#include "msgpack/v3/typed_array_decl.hpp"
+
+#endif // MSGPACK_TYPED_ARRAY_DECL_HPP
@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_UNPACK_EXACT_HPP
+#define MSGPACK_UNPACK_EXACT_HPP
+
+#include "msgpack/unpack_exact_decl.hpp"
+
+#include "msgpack/v2/unpack_exact.hpp"
+
+#endif // MSGPACK_UNPACK_EXACT_HPP
@@ -88,8 +88,7 @@ struct pack<T[N]> {
     msgpack::packer<Stream>& operator()(msgpack::packer<Stream>& o, const T(&v)[N]) const {
         uint32_t size = checked_get_container_size(N);
         o.pack_array(size);
-        const T* ptr = v;
-        for (; ptr != &v[N]; ++ptr) o.pack(*ptr);
+        o.pack_array_body(v, size);
         return o;
     }
 };
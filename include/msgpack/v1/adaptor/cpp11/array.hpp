@@ -105,7 +105,7 @@ struct pack<std::array<T, N>> {
     msgpack::packer<Stream>& operator()(msgpack::packer<Stream>& o, const std::array<T, N>& v) const {
         uint32_t size = checked_get_container_size(v.size());
         o.pack_array(size);
-        for(auto const& e : v) o.pack(e);
+        o.pack_array_body(v.data(), size);
         return o;
     }
 };
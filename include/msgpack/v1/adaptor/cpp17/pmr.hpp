@@ -0,0 +1,167 @@
+//
+// MessagePack for C++ static resolution routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_TYPE_PMR_HPP
+#define MSGPACK_V1_TYPE_PMR_HPP
+
+#include "msgpack/v1/pmr_decl.hpp"
+
+#if defined(MSGPACK_PMR)
+
+#include "msgpack/versioning.hpp"
+#include "msgpack/adaptor/adaptor_base.hpp"
+#include "msgpack/adaptor/check_container_size.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+namespace detail {
+
+// Constructs T with the allocator if T uses it, as the uses allocator
+// construction does. std::pmr::vector and std::pmr::string are constructed
+// by T(a), and std::pair and std::tuple by T(std::allocator_arg, a).
+template <typename T, typename Alloc>
+inline T make_with_allocator(Alloc const& a)
+{
+    if constexpr (std::uses_allocator_v<T, Alloc>) {
+        if constexpr (std::is_constructible_v<T, std::allocator_arg_t, Alloc const&>) {
+            return T(std::allocator_arg, a);
+        }
+        else {
+            return T(a);
+        }
+    }
+    else {
+        return T();
+    }
+}
+
+} // namespace detail
+
+namespace adaptor {
+
+// std::pmr::string
+// The generic std::basic_string adaptor is not used because the std::string
+// one is a full specialization. assign() keeps the allocator of v.
+
+template <>
+struct convert<std::pmr::string> {
+    msgpack::object const& operator()(msgpack::object const& o, std::pmr::string& v) const {
+        switch (o.type) {
+        case msgpack::type::BIN:
+            v.assign(o.via.bin.ptr, o.via.bin.size);
+            break;
+        case msgpack::type::STR:
+            v.assign(o.via.str.ptr, o.via.str.size);
+            break;
+        default:
+            throw msgpack::type_error();
+            break;
+        }
+        return o;
+    }
+};
+
+template <>
+struct pack<std::pmr::string> {
+    template <typename Stream>
+    msgpack::packer<Stream>& operator()(msgpack::packer<Stream>& o, const std::pmr::string& v) const {
+        uint32_t size = checked_get_container_size(v.size());
+        o.pack_str(size);
+        o.pack_str_body(v.data(), size);
+        return o;
+    }
+};
+
+template <>
+struct object<std::pmr::string> {
+    void operator()(msgpack::object& o, const std::pmr::string& v) const {
+        uint32_t size = checked_get_container_size(v.size());
+        o.type = msgpack::type::STR;
+        o.via.str.ptr = v.data();
+        o.via.str.size = size;
+    }
+};
+
+template <>
+struct object_with_zone<std::pmr::string> {
+    void operator()(msgpack::object::with_zone& o, const std::pmr::string& v) const {
+        uint32_t size = checked_get_container_size(v.size());
+        o.type = msgpack::type::STR;
+        char* ptr = static_cast<char*>(o.zone.allocate_align(size, MSGPACK_ZONE_ALIGNOF(char)));
+        o.via.str.ptr = ptr;
+        o.via.str.size = size;
+        std::memcpy(ptr, v.data(), v.size());
+    }
+};
+
+// std::pmr::map and std::pmr::unordered_map
+// The temporary container and the keys are allocated from the resource of v.
+// The mapped values get it by the uses allocator construction of operator[].
+// std::pmr::vector needs no specialization because resize() constructs the
+// elements in the same way.
+
+template <typename K, typename V, typename Compare>
+struct convert<std::map<K, V, Compare, std::pmr::polymorphic_allocator<std::pair<const K, V>>>> {
+    typedef std::map<K, V, Compare, std::pmr::polymorphic_allocator<std::pair<const K, V>>> map_type;
+    msgpack::object const& operator()(msgpack::object const& o, map_type& v) const {
+        if (o.type != msgpack::type::MAP) { throw msgpack::type_error(); }
+        msgpack::object_kv* p(o.via.map.ptr);
+        msgpack::object_kv* const pend(o.via.map.ptr + o.via.map.size);
+        map_type tmp(v.key_comp(), v.get_allocator());
+        for (; p != pend; ++p) {
+            K key = msgpack::v1::detail::make_with_allocator<K>(v.get_allocator());
+            p->key.convert(key);
+            p->val.convert(tmp[std::move(key)]);
+        }
+        v = std::move(tmp);
+        return o;
+    }
+};
+
+template <typename K, typename V, typename Hash, typename Pred>
+struct convert<std::unordered_map<K, V, Hash, Pred, std::pmr::polymorphic_allocator<std::pair<const K, V>>>> {
+    typedef std::unordered_map<K, V, Hash, Pred, std::pmr::polymorphic_allocator<std::pair<const K, V>>> map_type;
+    msgpack::object const& operator()(msgpack::object const& o, map_type& v) const {
+        if (o.type != msgpack::type::MAP) { throw msgpack::type_error(); }
+        msgpack::object_kv* p(o.via.map.ptr);
+        msgpack::object_kv* const pend(o.via.map.ptr + o.via.map.size);
+        map_type tmp(o.via.map.size, v.hash_function(), v.key_eq(), v.get_allocator());
+        for (; p != pend; ++p) {
+            K key = msgpack::v1::detail::make_with_allocator<K>(v.get_allocator());
+            p->key.convert(key);
+            p->val.convert(tmp[std::move(key)]);
+        }
+        v = std::move(tmp);
+        return o;
+    }
+};
+
+} // namespace adaptor
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_PMR)
+
+#endif // MSGPACK_V1_TYPE_PMR_HPP
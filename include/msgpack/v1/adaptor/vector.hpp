@@ -71,9 +71,8 @@ struct pack<std::vector<T, Alloc> > {
     msgpack::packer<Stream>& operator()(msgpack::packer<Stream>& o, const std::vector<T, Alloc>& v) const {
         uint32_t size = checked_get_container_size(v.size());
         o.pack_array(size);
-        for (typename std::vector<T, Alloc>::const_iterator it(v.begin()), it_end(v.end());
-            it != it_end; ++it) {
-            o.pack(*it);
+        if (size != 0) {
+            o.pack_array_body(&v.front(), size);
         }
         return o;
     }
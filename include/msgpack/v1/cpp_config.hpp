@@ -117,6 +117,23 @@ struct is_pointer_helper<T*> : true_type {};
 
 template<class T> struct is_pointer : detail::is_pointer_helper<typename remove_cv<T>::type> {};
 
+// by the compiler intrinsic, or false if it is not available
+#if defined(__clang__) && defined(__has_builtin)
+#if __has_builtin(__is_trivially_destructible)
+#define MSGPACK_HAS_TRIVIAL_DESTRUCTOR(T) __is_trivially_destructible(T)
+#endif
+#endif
+#if !defined(MSGPACK_HAS_TRIVIAL_DESTRUCTOR) && (defined(__GNUC__) || defined(_MSC_VER))
+#define MSGPACK_HAS_TRIVIAL_DESTRUCTOR(T) __has_trivial_destructor(T)
+#endif
+
+#if defined(MSGPACK_HAS_TRIVIAL_DESTRUCTOR)
+template<class T> struct is_trivially_destructible
+    : integral_constant<bool, MSGPACK_HAS_TRIVIAL_DESTRUCTOR(T)> {};
+#else  // defined(MSGPACK_HAS_TRIVIAL_DESTRUCTOR)
+template<class T> struct is_trivially_destructible : false_type {};
+#endif // defined(MSGPACK_HAS_TRIVIAL_DESTRUCTOR)
+
 
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v1)
@@ -80,6 +80,9 @@ struct remove_cv;
 template<class T>
 struct is_pointer;
 
+template<class T>
+struct is_trivially_destructible;
+
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v1)
 /// @endcond
@@ -119,6 +122,7 @@ MSGPACK_API_VERSION_NAMESPACE(v1) {
     using std::remove_volatile;
     using std::remove_cv;
     using std::is_pointer;
+    using std::is_trivially_destructible;
 
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v1)
@@ -11,6 +11,9 @@
 #define MSGPACK_V1_CPP03_ZONE_HPP
 
 #include "msgpack/zone_decl.hpp"
+#include "msgpack/memory_pool.hpp"
+
+#include <stdexcept>
 
 
 namespace msgpack {
@@ -19,6 +22,37 @@ namespace msgpack {
 MSGPACK_API_VERSION_NAMESPACE(v1) {
 /// @endcond
 
+/// The functions that the zone allocates its chunks by.
+/**
+ * allocate returns a block of size bytes or null, and deallocate frees the
+ * block with the same size. user_data is passed to them.
+ */
+struct zone_allocator {
+    zone_allocator()
+        :allocate(MSGPACK_NULLPTR), deallocate(MSGPACK_NULLPTR), user_data(MSGPACK_NULLPTR) {}
+    zone_allocator(void* (*a)(void* user_data, size_t size),
+                   void (*d)(void* user_data, void* p, size_t size),
+                   void* u = MSGPACK_NULLPTR)
+        :allocate(a), deallocate(d), user_data(u) {}
+    void* (*allocate)(void* user_data, size_t size);
+    void (*deallocate)(void* user_data, void* p, size_t size);
+    void* user_data;
+};
+
+/// The memory usage of a zone.
+struct zone_stats {
+    /// The bytes that are allocated from the zone.
+    size_t requested;
+    /// The usable bytes of the chunks that the zone holds.
+    size_t reserved;
+    /// The number of the chunks.
+    size_t chunks;
+    /// The bytes that are skipped to align the allocations.
+    size_t padding;
+    /// The number of the finalizers.
+    size_t finalizers;
+};
+
 class zone {
     struct finalizer {
         finalizer(void (*func)(void*), void* data):m_func(func), m_data(data) {}
@@ -81,36 +115,62 @@ class zone {
     };
     struct chunk {
         chunk* m_next;
+        // The size of the block from the allocator or memory_pool, 0 if it
+        // is from ::malloc(), and external_size() if it is the buffer
+        // supplied by the user.
+        size_t m_size;
+        static size_t external_size() { return static_cast<size_t>(-1); }
     };
     struct chunk_list {
-        chunk_list(size_t chunk_size)
+        chunk_list(size_t chunk_size, zone_allocator const& allocator)
+            :m_allocator(allocator)
         {
-            chunk* c = static_cast<chunk*>(::malloc(sizeof(chunk) + chunk_size));
-            if(!c) {
-                throw std::bad_alloc();
-            }
+            chunk* c = allocate_chunk(chunk_size);
 
             m_head = c;
             m_free = chunk_size;
             m_ptr  = reinterpret_cast<char*>(c) + sizeof(chunk);
+            m_first_size = chunk_size;
+            c->m_next = MSGPACK_NULLPTR;
+            reset_stats();
+        }
+        // The buffer is the first chunk if it can hold the chunk header.
+        chunk_list(void* buffer, size_t size, size_t chunk_size)
+        {
+            char* aligned = get_aligned(static_cast<char*>(buffer), MSGPACK_ZONE_ALIGN);
+            size_t header = static_cast<size_t>(aligned - static_cast<char*>(buffer)) + sizeof(chunk);
+            chunk* c;
+            if(buffer && header < size) {
+                c = reinterpret_cast<chunk*>(aligned);
+                c->m_size = chunk::external_size();
+                m_free = size - header;
+            } else {
+                c = allocate_chunk(chunk_size);
+                m_free = chunk_size;
+            }
+
+            m_head = c;
+            m_ptr  = reinterpret_cast<char*>(c) + sizeof(chunk);
+            m_first_size = m_free;
             c->m_next = MSGPACK_NULLPTR;
+            reset_stats();
         }
         ~chunk_list()
         {
             chunk* c = m_head;
             while(c) {
                 chunk* n = c->m_next;
-                ::free(c);
+                free_chunk(c);
                 c = n;
             }
         }
-        void clear(size_t chunk_size)
+        void clear()
         {
             chunk* c = m_head;
             while(true) {
                 chunk* n = c->m_next;
                 if(n) {
-                    ::free(c);
+                    free_chunk(c);
                     c = n;
                 } else {
                     m_head = c;
@@ -118,19 +178,91 @@ class zone {
                 }
             }
             m_head->m_next = MSGPACK_NULLPTR;
-            m_free = chunk_size;
+            m_free = m_first_size;
             m_ptr  = reinterpret_cast<char*>(m_head) + sizeof(chunk);
+            reset_stats();
+        }
+        void reset_stats()
+        {
+            m_reserved = m_first_size;
+            m_chunks = 1;
+            m_padding = 0;
+            m_retired_free = 0;
+        }
+        // The chunk takes the whole block from memory_pool, and size is
+        // updated to the usable size.
+        chunk* allocate_chunk(size_t& size)
+        {
+            chunk* c;
+            if(m_allocator.allocate) {
+                c = static_cast<chunk*>(m_allocator.allocate(m_allocator.user_data, sizeof(chunk) + size));
+                if(!c) {
+                    throw std::bad_alloc();
+                }
+                c->m_size = sizeof(chunk) + size;
+            } else if(memory_pool::enabled()) {
+                size_t bs = memory_pool::block_size(sizeof(chunk) + size);
+                c = static_cast<chunk*>(memory_pool::allocate(bs));
+                c->m_size = bs;
+                size = bs - sizeof(chunk);
+            } else {
+                c = static_cast<chunk*>(::malloc(sizeof(chunk) + size));
+                if(!c) {
+                    throw std::bad_alloc();
+                }
+                c->m_size = 0;
+            }
+            return c;
+        }
+        void free_chunk(chunk* c)
+        {
+            if(c->m_size == chunk::external_size()) {
+                return;
+            }
+            if(m_allocator.deallocate) {
+                m_allocator.deallocate(m_allocator.user_data, c, c->m_size);
+            } else if(c->m_size) {
+                memory_pool::deallocate(c, c->m_size);
+            } else {
+                ::free(c);
+            }
         }
         size_t m_free;
         char* m_ptr;
         chunk* m_head;
+        // the usable size of the oldest chunk that clear() keeps
+        size_t m_first_size;
+        zone_allocator m_allocator;
+        // for stats()
+        size_t m_reserved;
+        size_t m_chunks;
+        size_t m_padding;
+        // the bytes left unused in the chunks that are not the head
+        size_t m_retired_free;
     };
     size_t m_chunk_size;
+    // the chunk size that the growth has reached, and its limit
+    size_t m_next_chunk_size;
+    size_t m_max_chunk_size;
     chunk_list m_chunk_list;
     finalizer_array m_finalizer_array;
 
 public:
     zone(size_t chunk_size = MSGPACK_ZONE_CHUNK_SIZE) /* throw() */;
+    /// Construct the zone whose first chunk is the buffer.
+    /**
+     * @param buffer The memory that the allocations are served from until it is exhausted.
+     *               It is not freed by the zone, and must outlive the zone.
+     * @param size The size of the buffer.
+     * @param chunk_size The size of the chunks that are allocated after the buffer.
+     */
+    zone(void* buffer, size_t size, size_t chunk_size = MSGPACK_ZONE_CHUNK_SIZE) /* throw() */;
+    /// Construct the zone that allocates the chunks by the allocator.
+    /**
+     * Both allocate and deallocate of the allocator are set, or neither is
+     * set to use the default. Otherwise std::invalid_argument is thrown.
+     */
+    zone(zone_allocator const& allocator, size_t chunk_size = MSGPACK_ZONE_CHUNK_SIZE);
 
 public:
     void* allocate_align(size_t size, size_t align = MSGPACK_ZONE_ALIGN);
@@ -143,16 +275,29 @@ public:
 
     void clear();
 
+    /// Set how the size of the chunks grows.
+    /**
+     * @param growth ZONE_GROWTH_FIXED allocates the chunks of chunk_size bytes. It is the default.
+     *               ZONE_GROWTH_GEOMETRIC doubles the size of each new chunk.
+     *               ZONE_GROWTH_CAPPED_GEOMETRIC doubles it up to max_chunk_size.
+     * @param max_chunk_size The limit of ZONE_GROWTH_CAPPED_GEOMETRIC.
+     *
+     * A chunk is always large enough for the allocation that requires it.
+     * clear() restarts the growth from chunk_size.
+     */
+    void set_growth(zone_growth growth, size_t max_chunk_size = 0);
+
+    /// The memory usage of the zone.
+    zone_stats stats() const;
+
     void swap(zone& o);
     static void* operator new(std::size_t size)
     {
-        void* p = ::malloc(size);
-        if (!p) throw std::bad_alloc();
-        return p;
+        return memory_pool::allocate(size);
     }
-    static void operator delete(void *p) /* throw() */
+    static void operator delete(void *p, std::size_t size) /* throw() */
     {
-        ::free(p);
+        memory_pool::deallocate(p, size);
     }
     static void* operator new(std::size_t size, void* place) /* throw() */
     {
@@ -214,16 +359,28 @@ public:
     
     /// @endcond
 
+    /// Allocate an array of n default constructed T.
+    /**
+     * One finalizer destructs the whole array, and no finalizer is
+     * registered if T is trivially destructible.
+     */
+    template <typename T>
+    T* allocate_array(size_t n);
+
 private:
     void undo_allocate(size_t size);
 
     template <typename T>
     static void object_destruct(void* obj);
 
+    template <typename T>
+    static void object_array_destruct(void* obj);
+
     template <typename T>
     static void object_delete(void* obj);
 
     static char* get_aligned(char* ptr, size_t align);
+    static zone_allocator const& validate(zone_allocator const& allocator);
 
     char* allocate_expand(size_t size);
 private:
@@ -231,8 +388,30 @@ private:
     zone& operator=(const zone&);
 };
 
-inline zone::zone(size_t chunk_size) /* throw() */ :m_chunk_size(chunk_size), m_chunk_list(m_chunk_size)
+inline zone::zone(size_t chunk_size) /* throw() */
+    :m_chunk_size(chunk_size), m_next_chunk_size(chunk_size), m_max_chunk_size(chunk_size),
+     m_chunk_list(m_chunk_size, zone_allocator())
+{
+}
+
+inline zone::zone(void* buffer, size_t size, size_t chunk_size) /* throw() */
+    :m_chunk_size(chunk_size), m_next_chunk_size(chunk_size), m_max_chunk_size(chunk_size),
+     m_chunk_list(buffer, size, m_chunk_size)
+{
+}
+
+inline zone::zone(zone_allocator const& allocator, size_t chunk_size)
+    :m_chunk_size(chunk_size), m_next_chunk_size(chunk_size), m_max_chunk_size(chunk_size),
+     m_chunk_list(m_chunk_size, validate(allocator))
+{
+}
+
+inline zone_allocator const& zone::validate(zone_allocator const& allocator)
 {
+    if(!allocator.allocate != !allocator.deallocate) {
+        throw std::invalid_argument("zone_allocator: allocate and deallocate must be set together");
+    }
+    return allocator;
 }
 
 inline char* zone::get_aligned(char* ptr, size_t align)
@@ -253,6 +432,7 @@ inline void* zone::allocate_align(size_t size, size_t align)
         aligned = get_aligned(ptr, align);
         adjusted_size = size + static_cast<size_t>(aligned - m_chunk_list.m_ptr);
     }
+    m_chunk_list.m_padding += adjusted_size - size;
     m_chunk_list.m_free -= adjusted_size;
     m_chunk_list.m_ptr  += adjusted_size;
     return aligned;
@@ -274,7 +454,13 @@ inline char* zone::allocate_expand(size_t size)
 {
     chunk_list* const cl = &m_chunk_list;
 
-    size_t sz = m_chunk_size;
+    if(m_next_chunk_size < m_max_chunk_size) {
+        size_t next = m_next_chunk_size * 2;
+        m_next_chunk_size = (next <= m_next_chunk_size || next > m_max_chunk_size) ?
+            m_max_chunk_size : next;
+    }
+
+    size_t sz = m_next_chunk_size;
 
     while(sz < size) {
         size_t tmp_sz = sz * 2;
@@ -285,15 +471,17 @@ inline char* zone::allocate_expand(size_t size)
         sz = tmp_sz;
     }
 
-    chunk* c = static_cast<chunk*>(::malloc(sizeof(chunk) + sz));
-    if (!c) throw std::bad_alloc();
+    chunk* c = cl->allocate_chunk(sz);
 
     char* ptr = reinterpret_cast<char*>(c) + sizeof(chunk);
 
     c->m_next  = cl->m_head;
+    cl->m_retired_free += cl->m_free;
     cl->m_head = c;
     cl->m_free = sz;
     cl->m_ptr  = ptr;
+    cl->m_reserved += sz;
+    ++cl->m_chunks;
 
     return ptr;
 }
@@ -312,13 +500,46 @@ inline void zone::push_finalizer(msgpack::unique_ptr<T> obj)
 inline void zone::clear()
 {
     m_finalizer_array.clear();
-    m_chunk_list.clear(m_chunk_size);
+    m_chunk_list.clear();
+    m_next_chunk_size = m_chunk_size;
+}
+
+inline void zone::set_growth(zone_growth growth, size_t max_chunk_size)
+{
+    switch(growth) {
+    case ZONE_GROWTH_FIXED:
+        m_max_chunk_size = m_chunk_size;
+        break;
+    case ZONE_GROWTH_GEOMETRIC:
+        m_max_chunk_size = static_cast<size_t>(-1);
+        break;
+    case ZONE_GROWTH_CAPPED_GEOMETRIC:
+        m_max_chunk_size = max_chunk_size < m_chunk_size ? m_chunk_size : max_chunk_size;
+        break;
+    }
+    if(m_next_chunk_size > m_max_chunk_size) {
+        m_next_chunk_size = m_max_chunk_size;
+    }
+}
+
+inline zone_stats zone::stats() const
+{
+    const chunk_list& cl = m_chunk_list;
+    zone_stats s;
+    s.requested = cl.m_reserved - cl.m_free - cl.m_retired_free - cl.m_padding;
+    s.reserved = cl.m_reserved;
+    s.chunks = cl.m_chunks;
+    s.padding = cl.m_padding;
+    s.finalizers = static_cast<size_t>(m_finalizer_array.m_tail - m_finalizer_array.m_array);
+    return s;
 }
 
 inline void zone::swap(zone& o)
 {
     using std::swap;
     swap(m_chunk_size, o.m_chunk_size);
+    swap(m_next_chunk_size, o.m_next_chunk_size);
+    swap(m_max_chunk_size, o.m_max_chunk_size);
     swap(m_chunk_list, o.m_chunk_list);
     swap(m_finalizer_array, o.m_finalizer_array);
 }
@@ -329,6 +550,16 @@ void zone::object_destruct(void* obj)
     static_cast<T*>(obj)->~T();
 }
 
+template <typename T>
+void zone::object_array_destruct(void* obj)
+{
+    size_t n = *static_cast<size_t*>(obj);
+    T* p = reinterpret_cast<T*>(static_cast<char*>(obj) + aligned_size(sizeof(size_t), MSGPACK_ZONE_ALIGNOF(T)));
+    while (n != 0) {
+        p[--n].~T();
+    }
+}
+
 template <typename T>
 void zone::object_delete(void* obj)
 {
@@ -347,12 +578,58 @@ inline std::size_t aligned_size(
     return (size + align - 1) / align * align;
 }
 
+namespace detail {
+
+template <std::size_t N>
+struct inline_zone_storage {
+    union {
+        char m_buffer[N];
+        // for the alignment
+        double m_double;
+        long long m_long_long;
+        void* m_pointer;
+    } m_storage;
+};
+
+} // namespace detail
+
+/// The zone whose first chunk is stored in the zone object itself.
+/**
+ * The allocations up to about N bytes don't touch the heap, so an
+ * inline_zone on the stack unpacks small messages without any malloc.
+ * The larger allocations spill to the chunks on the heap.
+ *
+ * The objects allocated by the inline_zone are valid while the inline_zone
+ * exists. Don't move or swap it as a msgpack::zone, because the moved zone
+ * would refer to the storage of this object.
+ */
+template <std::size_t N>
+class inline_zone : private detail::inline_zone_storage<N>, public zone {
+public:
+    inline_zone(size_t chunk_size = MSGPACK_ZONE_CHUNK_SIZE)
+        :zone(this->m_storage.m_buffer, N, chunk_size)
+    {
+    }
+
+private:
+    inline_zone(const inline_zone&);
+    inline_zone& operator=(const inline_zone&);
+};
+
 /// @cond
 
 template <typename T>
 T* zone::allocate()
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T();
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -372,6 +649,14 @@ template <typename T, typename A1>
 T* zone::allocate(A1 a1)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -391,6 +676,14 @@ template <typename T, typename A1, typename A2>
 T* zone::allocate(A1 a1, A2 a2)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -410,6 +703,14 @@ template <typename T, typename A1, typename A2, typename A3>
 T* zone::allocate(A1 a1, A2 a2, A3 a3)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -429,6 +730,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4>
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -448,6 +757,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -467,6 +784,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -486,6 +811,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -505,6 +838,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7, a8);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -524,6 +865,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7, a8, a9);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -543,6 +892,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -562,6 +919,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -581,6 +946,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11, A12 a12)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -600,6 +973,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11, A12 a12, A13 a13)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -619,6 +1000,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11, A12 a12, A13 a13, A14 a14)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -638,6 +1027,14 @@ template <typename T, typename A1, typename A2, typename A3, typename A4, typena
 T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9, A10 a10, A11 a11, A12 a12, A13 a13, A14 a14, A15 a15)
 {
     void* x = allocate_align(sizeof(T), MSGPACK_ZONE_ALIGNOF(T));
+    if (msgpack::is_trivially_destructible<T>::value) {
+        try {
+            return new (x) T(a1, a2, a3, a4, a5, a6, a7, a8, a9, a10, a11, a12, a13, a14, a15);
+        } catch (...) {
+            undo_allocate(sizeof(T));
+            throw;
+        }
+    }
     try {
         m_finalizer_array.push(&zone::object_destruct<T>, x);
     } catch (...) {
@@ -655,6 +1052,57 @@ T* zone::allocate(A1 a1, A2 a2, A3 a3, A4 a4, A5 a5, A6 a6, A7 a7, A8 a8, A9 a9,
 
 /// @endcond
 
+template <typename T>
+inline T* zone::allocate_array(size_t n)
+{
+    if (msgpack::is_trivially_destructible<T>::value) {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        const size_t size = sizeof(T) * n;
+        T* p = static_cast<T*>(allocate_align(size, MSGPACK_ZONE_ALIGNOF(T)));
+        try {
+            for (size_t i = 0; i != n; ++i) {
+                new (p + i) T();
+            }
+        } catch (...) {
+            undo_allocate(size);
+            throw;
+        }
+        return p;
+    }
+
+    // The number of the constructed elements precedes the array.
+    const size_t header = aligned_size(sizeof(size_t), MSGPACK_ZONE_ALIGNOF(T));
+    if (n > (static_cast<size_t>(-1) - header) / sizeof(T)) {
+        throw std::bad_alloc();
+    }
+    const size_t size = header + sizeof(T) * n;
+    const size_t align = MSGPACK_ZONE_ALIGNOF(T) < MSGPACK_ZONE_ALIGNOF(size_t) ?
+        MSGPACK_ZONE_ALIGNOF(size_t) : MSGPACK_ZONE_ALIGNOF(T);
+    char* x = static_cast<char*>(allocate_align(size, align));
+    size_t& count = *reinterpret_cast<size_t*>(x);
+    T* p = reinterpret_cast<T*>(x + header);
+    count = 0;
+    try {
+        m_finalizer_array.push(&zone::object_array_destruct<T>, x);
+    } catch (...) {
+        undo_allocate(size);
+        throw;
+    }
+    try {
+        for (; count != n; ++count) {
+            new (p + count) T();
+        }
+    } catch (...) {
+        --m_finalizer_array.m_tail;
+        object_array_destruct<T>(x);
+        undo_allocate(size);
+        throw;
+    }
+    return p;
+}
+
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v1)
 /// @endcond
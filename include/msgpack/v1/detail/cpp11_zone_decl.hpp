@@ -42,6 +42,19 @@ MSGPACK_API_VERSION_NAMESPACE(v1) {
 
 class zone;
 
+template <std::size_t N>
+class inline_zone;
+
+struct zone_allocator;
+
+struct zone_stats;
+
+enum zone_growth {
+    ZONE_GROWTH_FIXED,
+    ZONE_GROWTH_GEOMETRIC,
+    ZONE_GROWTH_CAPPED_GEOMETRIC
+};
+
 std::size_t aligned_size(
     std::size_t size,
     std::size_t align = MSGPACK_ZONE_ALIGN);
@@ -0,0 +1,119 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_DETAIL_EMBED_STACK_HPP
+#define MSGPACK_V1_DETAIL_EMBED_STACK_HPP
+
+#include "msgpack/versioning.hpp"
+#include "msgpack/unpack_define.h"
+
+#include <cstddef>
+#include <algorithm>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+namespace detail {
+
+// The stack that is used by the parsers to track nested containers.
+// The first N elements are stored in the object itself, so the heap is
+// allocated only if the nesting depth exceeds N. Elements are not
+// destroyed on pop_back(), so T should be a trivially destructible type.
+template <typename T, std::size_t N = MSGPACK_EMBED_STACK_SIZE>
+class embed_stack {
+public:
+    embed_stack()
+        :m_data(m_embed), m_size(0), m_capacity(N)
+    {
+    }
+
+    embed_stack(embed_stack const& other)
+        :m_data(m_embed), m_size(0), m_capacity(N)
+    {
+        assign(other);
+    }
+
+    embed_stack& operator=(embed_stack const& other)
+    {
+        if (this != &other) {
+            m_size = 0;
+            assign(other);
+        }
+        return *this;
+    }
+
+    ~embed_stack()
+    {
+        if (m_data != m_embed) delete[] m_data;
+    }
+
+    void push_back(T const& v)
+    {
+        if (m_size == m_capacity) expand(m_capacity * 2);
+        m_data[m_size++] = v;
+    }
+    void pop_back() { --m_size; }
+
+    T& back() { return m_data[m_size - 1]; }
+    T const& back() const { return m_data[m_size - 1]; }
+    T& operator[](std::size_t i) { return m_data[i]; }
+    T const& operator[](std::size_t i) const { return m_data[i]; }
+    T* begin() { return m_data; }
+    T* end() { return m_data + m_size; }
+
+    std::size_t size() const { return m_size; }
+    std::size_t capacity() const { return m_capacity; }
+    bool empty() const { return m_size == 0; }
+    // true if no heap memory is used
+    bool embedded() const { return m_data == m_embed; }
+
+    void clear() { m_size = 0; }
+    void reserve(std::size_t size)
+    {
+        if (size > m_capacity) expand(size);
+    }
+    void resize(std::size_t size)
+    {
+        reserve(size);
+        for (std::size_t i = m_size; i < size; ++i) m_data[i] = T();
+        m_size = size;
+    }
+
+private:
+    void expand(std::size_t capacity)
+    {
+        T* tmp = new T[capacity];
+        for (std::size_t i = 0; i != m_size; ++i) tmp[i] = m_data[i];
+        if (m_data != m_embed) delete[] m_data;
+        m_data = tmp;
+        m_capacity = capacity;
+    }
+    void assign(embed_stack const& other)
+    {
+        reserve(other.m_size);
+        std::copy(other.m_data, other.m_data + other.m_size, m_data);
+        m_size = other.m_size;
+    }
+
+    T m_embed[N];
+    T* m_data;
+    std::size_t m_size;
+    std::size_t m_capacity;
+};
+
+} // namespace detail
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V1_DETAIL_EMBED_STACK_HPP
@@ -0,0 +1,236 @@
+//
+// MessagePack for C++ file descriptor buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_FDBUFFER_HPP
+#define MSGPACK_V1_FDBUFFER_HPP
+
+#include "msgpack/v1/fdbuffer_decl.hpp"
+
+#if defined(MSGPACK_FDBUFFER)
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if !defined(MSGPACK_USE_CPP03)
+#include <future>
+#endif // !defined(MSGPACK_USE_CPP03)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+/// The buffer that writes to a file descriptor by write(2).
+/**
+ * The packed data is gathered in a user space buffer of buffer_size bytes,
+ * and the buffer is written at once when it is full, when flush() is called
+ * and when the fdbuffer is destroyed. The packer encodes headers and scalars
+ * directly into the buffer by prepare() and commit(). The data that is
+ * larger than the buffer is written directly.
+ *
+ * The fd is not closed by the fdbuffer. If writing fails, std::runtime_error
+ * is thrown. With FDBUFFER_BACKGROUND, the error of a background write is
+ * thrown by the next call that waits for it.
+ */
+class fdbuffer {
+public:
+    explicit fdbuffer(int fd,
+                      size_t buffer_size = MSGPACK_FDBUFFER_SIZE,
+                      int flags = FDBUFFER_DEFAULT)
+        : m_fd(fd), m_flags(flags), m_data(MSGPACK_NULLPTR), m_back(MSGPACK_NULLPTR),
+          m_size(0), m_capacity(std::max<size_t>(buffer_size, 1)), m_file_off(0)
+    {
+        m_data = static_cast<char*>(::malloc(m_capacity));
+        if (!m_data) {
+            throw std::bad_alloc();
+        }
+        if (m_flags & FDBUFFER_FADVISE_DONTNEED) {
+            off_t off = ::lseek(m_fd, 0, SEEK_CUR);
+            if (off < 0) {
+                // not a regular file
+                m_flags &= ~FDBUFFER_FADVISE_DONTNEED;
+            } else {
+                m_file_off = off;
+            }
+        }
+    }
+
+    ~fdbuffer()
+    {
+        try {
+            flush();
+        } catch (...) {
+        }
+        ::free(m_data);
+        ::free(m_back);
+    }
+
+public:
+    void write(const char* buf, size_t len)
+    {
+        if (m_capacity - m_size < len) {
+            flush_buffer();
+            if (m_capacity <= len) {
+                wait();
+                write_fd(buf, len);
+                return;
+            }
+        }
+        std::memcpy(m_data + m_size, buf, len);
+        m_size += len;
+    }
+
+    char* prepare(size_t len)
+    {
+        if (m_capacity - m_size < len) {
+            flush_buffer();
+            if (m_capacity < len) {
+                wait();
+                char* tmp = static_cast<char*>(::realloc(m_data, len));
+                if (!tmp) {
+                    throw std::bad_alloc();
+                }
+                m_data = tmp;
+                m_capacity = len;
+                ::free(m_back);
+                m_back = MSGPACK_NULLPTR;
+            }
+        }
+        return m_data + m_size;
+    }
+
+    void commit(size_t len)
+    {
+        m_size += len;
+    }
+
+    /// Writes the buffered data and waits for the background write.
+    void flush()
+    {
+        flush_buffer();
+        wait();
+    }
+
+    int fd() const
+    {
+        return m_fd;
+    }
+
+    /// The size of the data that is buffered and not written yet.
+    size_t size() const
+    {
+        return m_size;
+    }
+
+private:
+    // Starts writing the buffer. It is written in the background if
+    // FDBUFFER_BACKGROUND is set, after the previous write finishes.
+    void flush_buffer()
+    {
+        if (m_size == 0) {
+            return;
+        }
+#if !defined(MSGPACK_USE_CPP03)
+        if (m_flags & FDBUFFER_BACKGROUND) {
+            wait();
+            if (!m_back) {
+                m_back = static_cast<char*>(::malloc(m_capacity));
+                if (!m_back) {
+                    throw std::bad_alloc();
+                }
+            }
+            std::swap(m_data, m_back);
+            const size_t size = m_size;
+            m_size = 0;
+            m_pending = std::async(std::launch::async, &fdbuffer::write_fd, this, m_back, size);
+            return;
+        }
+#endif // !defined(MSGPACK_USE_CPP03)
+        write_fd(m_data, m_size);
+        m_size = 0;
+    }
+
+    void wait()
+    {
+#if !defined(MSGPACK_USE_CPP03)
+        if (m_pending.valid()) {
+            m_pending.get();
+        }
+#endif // !defined(MSGPACK_USE_CPP03)
+    }
+
+    void write_fd(const char* buf, size_t len)
+    {
+        const size_t total = len;
+        while (len > 0) {
+            ssize_t n = ::write(m_fd, buf, len);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("write() failed");
+            }
+            buf += n;
+            len -= static_cast<size_t>(n);
+        }
+        if (m_flags & FDBUFFER_FDATASYNC) {
+#if defined(__linux__)
+            if (::fdatasync(m_fd) != 0) {
+#else
+            if (::fsync(m_fd) != 0) {
+#endif
+                throw std::runtime_error("fdatasync() failed");
+            }
+        }
+#if defined(__linux__)
+        if (m_flags & FDBUFFER_FADVISE_DONTNEED) {
+            ::posix_fadvise(m_fd, m_file_off, static_cast<off_t>(total), POSIX_FADV_DONTNEED);
+        }
+#endif
+        m_file_off += static_cast<off_t>(total);
+    }
+
+#if defined(MSGPACK_USE_CPP03)
+private:
+    fdbuffer(const fdbuffer&);
+    fdbuffer& operator=(const fdbuffer&);
+#else  // defined(MSGPACK_USE_CPP03)
+    fdbuffer(const fdbuffer&) = delete;
+    fdbuffer& operator=(const fdbuffer&) = delete;
+#endif // defined(MSGPACK_USE_CPP03)
+
+private:
+    int m_fd;
+    int m_flags;
+    char* m_data;
+    // the buffer that is being written in the background
+    char* m_back;
+    size_t m_size;
+    size_t m_capacity;
+    // the file offset of the next write, for posix_fadvise()
+    off_t m_file_off;
+#if !defined(MSGPACK_USE_CPP03)
+    std::future<void> m_pending;
+#endif // !defined(MSGPACK_USE_CPP03)
+};
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_FDBUFFER)
+
+#endif // MSGPACK_V1_FDBUFFER_HPP
@@ -0,0 +1,52 @@
+//
+// MessagePack for C++ file descriptor buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_FDBUFFER_DECL_HPP
+#define MSGPACK_V1_FDBUFFER_DECL_HPP
+
+#include "msgpack/versioning.hpp"
+
+#include <cstddef>
+
+#if defined(unix) || defined(__unix) || defined(__APPLE__) || defined(__OpenBSD__)
+#define MSGPACK_FDBUFFER
+#endif
+
+#if defined(MSGPACK_FDBUFFER)
+
+#ifndef MSGPACK_FDBUFFER_SIZE
+#define MSGPACK_FDBUFFER_SIZE (1024*1024)
+#endif
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+/// The policies of fdbuffer. They can be combined by bitwise or.
+enum fdbuffer_flags {
+    FDBUFFER_DEFAULT = 0,
+    /// Call fdatasync() after each write of the buffer.
+    FDBUFFER_FDATASYNC = 1,
+    /// Advise that the written range is not needed in the page cache.
+    FDBUFFER_FADVISE_DONTNEED = 2,
+    /// Write the full buffer on another thread while the next one is filled. C++11 only.
+    FDBUFFER_BACKGROUND = 4
+};
+
+class fdbuffer;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_FDBUFFER)
+
+#endif // MSGPACK_V1_FDBUFFER_DECL_HPP
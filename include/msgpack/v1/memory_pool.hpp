@@ -0,0 +1,257 @@
+//
+// MessagePack for C++ memory pool
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_MEMORY_POOL_HPP
+#define MSGPACK_V1_MEMORY_POOL_HPP
+
+#include "msgpack/v1/memory_pool_decl.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+namespace detail {
+
+inline std::size_t memory_pool_class(std::size_t size)
+{
+    std::size_t index = 0;
+    std::size_t block = MSGPACK_MEMORY_POOL_MIN_SIZE;
+    while(block < size) {
+        block *= 2;
+        ++index;
+    }
+    return index;
+}
+
+#if !defined(MSGPACK_USE_CPP03)
+
+template <std::size_t Block, bool Last = (Block >= MSGPACK_MEMORY_POOL_MAX_SIZE)>
+struct memory_pool_classes {
+    static const std::size_t value = 1 + memory_pool_classes<Block * 2>::value;
+};
+
+template <std::size_t Block>
+struct memory_pool_classes<Block, true> {
+    static const std::size_t value = 1;
+};
+
+// The pooled blocks of a size class are linked through their first bytes.
+struct memory_pool_block {
+    memory_pool_block* m_next;
+};
+
+// Set when the state of the thread is destroyed. The blocks that are
+// deallocated after that, e.g. by a zone destroyed at the exit of the
+// program, are freed directly. A bool is trivially destructible, so it
+// is still valid while the other thread local objects are destroyed.
+inline bool& memory_pool_destroyed()
+{
+    static thread_local bool destroyed = false;
+    return destroyed;
+}
+
+class memory_pool_state {
+public:
+    static const std::size_t classes =
+        memory_pool_classes<MSGPACK_MEMORY_POOL_MIN_SIZE>::value;
+
+    memory_pool_state():m_enabled(false), m_max_blocks(0)
+    {
+        std::memset(m_heads, 0, sizeof(m_heads));
+        std::memset(m_counts, 0, sizeof(m_counts));
+        std::memset(&m_stats, 0, sizeof(m_stats));
+    }
+    ~memory_pool_state()
+    {
+        release();
+        m_enabled = false;
+        memory_pool_destroyed() = true;
+    }
+    void release()
+    {
+        for(std::size_t i = 0; i != classes; ++i) {
+            memory_pool_block* b = m_heads[i];
+            while(b) {
+                memory_pool_block* n = b->m_next;
+                ::free(b);
+                b = n;
+            }
+            m_heads[i] = MSGPACK_NULLPTR;
+            m_counts[i] = 0;
+        }
+    }
+    void* pop(std::size_t index)
+    {
+        memory_pool_block* b = m_heads[index];
+        if(b) {
+            m_heads[index] = b->m_next;
+            --m_counts[index];
+            ++m_stats.hits;
+        } else {
+            ++m_stats.misses;
+        }
+        return b;
+    }
+    bool push(std::size_t index, void* p)
+    {
+        if(m_counts[index] == m_max_blocks) {
+            ++m_stats.discards;
+            return false;
+        }
+        memory_pool_block* b = static_cast<memory_pool_block*>(p);
+        b->m_next = m_heads[index];
+        m_heads[index] = b;
+        ++m_counts[index];
+        ++m_stats.returns;
+        return true;
+    }
+
+    bool m_enabled;
+    std::size_t m_max_blocks;
+    memory_pool_block* m_heads[classes];
+    std::size_t m_counts[classes];
+    memory_pool_stats m_stats;
+};
+
+// Returns MSGPACK_NULLPTR once the state of the thread is destroyed.
+inline memory_pool_state* memory_pool_instance()
+{
+    if(memory_pool_destroyed()) {
+        return MSGPACK_NULLPTR;
+    }
+    static thread_local memory_pool_state s;
+    return &s;
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+} // namespace detail
+
+#if !defined(MSGPACK_USE_CPP03)
+
+inline void memory_pool::enable(std::size_t max_blocks)
+{
+    detail::memory_pool_state* s = detail::memory_pool_instance();
+    if(!s) return;
+    s->m_enabled = true;
+    s->m_max_blocks = max_blocks;
+}
+
+inline void memory_pool::disable()
+{
+    detail::memory_pool_state* s = detail::memory_pool_instance();
+    if(!s) return;
+    s->m_enabled = false;
+    s->release();
+}
+
+inline bool memory_pool::enabled()
+{
+    detail::memory_pool_state* s = detail::memory_pool_instance();
+    return s && s->m_enabled;
+}
+
+inline memory_pool_stats memory_pool::stats()
+{
+    detail::memory_pool_state* s = detail::memory_pool_instance();
+    if(!s) {
+        memory_pool_stats z = { 0, 0, 0, 0 };
+        return z;
+    }
+    return s->m_stats;
+}
+
+inline void memory_pool::reset_stats()
+{
+    detail::memory_pool_state* s = detail::memory_pool_instance();
+    if(!s) return;
+    std::memset(&s->m_stats, 0, sizeof(memory_pool_stats));
+}
+
+#else  // !defined(MSGPACK_USE_CPP03)
+
+inline void memory_pool::enable(std::size_t)
+{
+}
+
+inline void memory_pool::disable()
+{
+}
+
+inline bool memory_pool::enabled()
+{
+    return false;
+}
+
+inline memory_pool_stats memory_pool::stats()
+{
+    memory_pool_stats s = { 0, 0, 0, 0 };
+    return s;
+}
+
+inline void memory_pool::reset_stats()
+{
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+inline std::size_t memory_pool::block_size(std::size_t size)
+{
+    if(size > MSGPACK_MEMORY_POOL_MAX_SIZE) {
+        return size;
+    }
+    return static_cast<std::size_t>(MSGPACK_MEMORY_POOL_MIN_SIZE) << detail::memory_pool_class(size);
+}
+
+inline void* memory_pool::allocate(std::size_t size)
+{
+    std::size_t bs = block_size(size);
+#if !defined(MSGPACK_USE_CPP03)
+    if(bs <= MSGPACK_MEMORY_POOL_MAX_SIZE) {
+        detail::memory_pool_state* s = detail::memory_pool_instance();
+        if(s && s->m_enabled) {
+            void* p = s->pop(detail::memory_pool_class(bs));
+            if(p) return p;
+        }
+    }
+#endif // !defined(MSGPACK_USE_CPP03)
+    void* p = ::malloc(bs);
+    if(!p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+inline void memory_pool::deallocate(void* p, std::size_t size)
+{
+    if(!p) return;
+#if !defined(MSGPACK_USE_CPP03)
+    if(size <= MSGPACK_MEMORY_POOL_MAX_SIZE) {
+        detail::memory_pool_state* s = detail::memory_pool_instance();
+        if(s && s->m_enabled && s->push(detail::memory_pool_class(size), p)) {
+            return;
+        }
+    }
+#else  // !defined(MSGPACK_USE_CPP03)
+    (void)size;
+#endif // !defined(MSGPACK_USE_CPP03)
+    ::free(p);
+}
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V1_MEMORY_POOL_HPP
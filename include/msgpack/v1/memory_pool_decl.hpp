@@ -0,0 +1,111 @@
+//
+// MessagePack for C++ memory pool
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_MEMORY_POOL_DECL_HPP
+#define MSGPACK_V1_MEMORY_POOL_DECL_HPP
+
+#include "msgpack/versioning.hpp"
+#include "msgpack/cpp_config.hpp"
+
+#include <cstddef>
+
+// The smallest and the largest size classes, both must be powers of 2.
+#ifndef MSGPACK_MEMORY_POOL_MIN_SIZE
+#define MSGPACK_MEMORY_POOL_MIN_SIZE 64
+#endif
+
+#ifndef MSGPACK_MEMORY_POOL_MAX_SIZE
+#define MSGPACK_MEMORY_POOL_MAX_SIZE (1024 * 1024)
+#endif
+
+// The default number of the blocks that a size class keeps.
+#ifndef MSGPACK_MEMORY_POOL_MAX_BLOCKS
+#define MSGPACK_MEMORY_POOL_MAX_BLOCKS 16
+#endif
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+/// The counters of memory_pool
+struct memory_pool_stats {
+    /// The number of allocations that reused a pooled block
+    std::size_t hits;
+    /// The number of allocations that called `::malloc()`
+    std::size_t misses;
+    /// The number of deallocations that kept the block in the pool
+    std::size_t returns;
+    /// The number of deallocations that called `::free()`
+    std::size_t discards;
+};
+
+/// The per-thread pool of memory blocks
+/**
+ * The blocks are grouped by size classes of powers of 2 from
+ * MSGPACK_MEMORY_POOL_MIN_SIZE to MSGPACK_MEMORY_POOL_MAX_SIZE.
+ * The pool is disabled by default. While it is enabled on a thread, the zones
+ * (including the ones that object_handle and unpacker own), the chunks of
+ * vrefbuffer, and sbuffer with sbuffer_pool_allocator() reuse the blocks
+ * that were freed on the same thread instead of calling `::malloc()`.
+ * The blocks are allocated by `::malloc()`, so they can be freed on any thread.
+ *
+ * The pool requires C++11 `thread_local`. On C++03, enable() does nothing
+ * and the blocks are always allocated by `::malloc()`.
+ */
+class memory_pool {
+public:
+    /// Enable the pool on the current thread
+    /**
+     * @param max_blocks The number of the blocks that each size class keeps.
+     */
+    static void enable(std::size_t max_blocks = MSGPACK_MEMORY_POOL_MAX_BLOCKS);
+
+    /// Disable the pool on the current thread and free the pooled blocks
+    static void disable();
+
+    /// Return true if the pool is enabled on the current thread
+    static bool enabled();
+
+    /// Get the counters of the current thread
+    /**
+     * The counters are updated only while the pool is enabled.
+     */
+    static memory_pool_stats stats();
+
+    /// Reset the counters of the current thread
+    static void reset_stats();
+
+    /// Get the size of the block that allocate() returns
+    /**
+     * @return The smallest size class that is not less than size, or size
+     *         itself if it is larger than MSGPACK_MEMORY_POOL_MAX_SIZE.
+     */
+    static std::size_t block_size(std::size_t size);
+
+    /// Allocate a block of block_size(size) bytes
+    /**
+     * std::bad_alloc is thrown on failure.
+     */
+    static void* allocate(std::size_t size);
+
+    /// Deallocate the block
+    /**
+     * @param p The block that allocate() returned.
+     * @param size The size that was passed to allocate() or a smaller size.
+     */
+    static void deallocate(void* p, std::size_t size);
+};
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V1_MEMORY_POOL_DECL_HPP
@@ -24,9 +24,199 @@ namespace msgpack {
 MSGPACK_API_VERSION_NAMESPACE(v1) {
 /// @endcond
 
+namespace detail {
+
+// Detects `char* prepare(size_t)` and `void commit(size_t)` of a stream.
+template <typename Stream>
+struct has_prepare_commit {
+private:
+    template <typename U, char* (U::*)(size_t), void (U::*)(size_t)>
+    struct check_type {};
+    template <typename U>
+    static char check(check_type<U, &U::prepare, &U::commit>*);
+    template <typename U>
+    static char (&check(...))[2];
+public:
+    static const bool value = sizeof(check<Stream>(MSGPACK_NULLPTR)) == 1;
+};
+
+// The packer builds headers and scalars in the region that prepare()
+// returns. If the stream doesn't have prepare() and commit(), the region
+// is a temporary buffer and commit() copies it by write().
+template <typename Stream, bool Sink = has_prepare_commit<Stream>::value>
+struct packer_sink {
+    static char* prepare(Stream&, char* buf, size_t) {
+        return buf;
+    }
+    static void commit(Stream& s, const char* buf, size_t len) {
+        write(s, &Stream::write, buf, len);
+    }
+private:
+    template <typename Ret, typename Cls, typename SizeType>
+    static void write(Stream& s, Ret (Cls::*)(const char*, SizeType), const char* buf, size_t len) {
+        s.write(buf, static_cast<SizeType>(len));
+    }
+};
+
+template <typename Stream>
+struct packer_sink<Stream, true> {
+    static char* prepare(Stream& s, char*, size_t len) {
+        return s.prepare(len);
+    }
+    static void commit(Stream& s, const char*, size_t len) {
+        s.commit(len);
+    }
+};
+
+// Encoders of the elements that pack_array_body() packs in batches.
+// They produce the same bytes as the corresponding packer::pack().
+inline std::size_t encode_uint(char* p, uint64_t d)
+{
+    if(d < (1ULL<<7)) {
+        /* fixnum */
+        p[0] = static_cast<char>(d);
+        return 1;
+    } else if(d < (1ULL<<8)) {
+        /* unsigned 8 */
+        p[0] = static_cast<char>(0xccu); p[1] = static_cast<char>(d);
+        return 2;
+    } else if(d < (1ULL<<16)) {
+        /* unsigned 16 */
+        p[0] = static_cast<char>(0xcdu); _msgpack_store16(&p[1], static_cast<uint16_t>(d));
+        return 3;
+    } else if(d < (1ULL<<32)) {
+        /* unsigned 32 */
+        p[0] = static_cast<char>(0xceu); _msgpack_store32(&p[1], static_cast<uint32_t>(d));
+        return 5;
+    } else {
+        /* unsigned 64 */
+        p[0] = static_cast<char>(0xcfu); _msgpack_store64(&p[1], d);
+        return 9;
+    }
+}
+
+inline std::size_t encode_int(char* p, int64_t d)
+{
+    if(d >= 0) {
+        return encode_uint(p, static_cast<uint64_t>(d));
+    } else if(d >= -(1LL<<5)) {
+        /* fixnum */
+        p[0] = static_cast<char>(d);
+        return 1;
+    } else if(d >= -(1LL<<7)) {
+        /* signed 8 */
+        p[0] = static_cast<char>(0xd0u); p[1] = static_cast<char>(d);
+        return 2;
+    } else if(d >= -(1LL<<15)) {
+        /* signed 16 */
+        p[0] = static_cast<char>(0xd1u); _msgpack_store16(&p[1], static_cast<int16_t>(d));
+        return 3;
+    } else if(d >= -(1LL<<31)) {
+        /* signed 32 */
+        p[0] = static_cast<char>(0xd2u); _msgpack_store32(&p[1], static_cast<int32_t>(d));
+        return 5;
+    } else {
+        /* signed 64 */
+        p[0] = static_cast<char>(0xd3u); _msgpack_store64(&p[1], d);
+        return 9;
+    }
+}
+
+inline std::size_t encode_float(char* p, float d)
+{
+    union { float f; uint32_t i; } mem;
+    mem.f = d;
+    p[0] = static_cast<char>(0xcau); _msgpack_store32(&p[1], mem.i);
+    return 5;
+}
+
+inline std::size_t encode_double(char* p, double d)
+{
+    union { double f; uint64_t i; } mem;
+    mem.f = d;
+    p[0] = static_cast<char>(0xcbu);
+
+#if defined(TARGET_OS_IPHONE)
+    // ok
+#elif defined(__arm__) && !(__ARM_EABI__) // arm-oabi
+    // https://github.com/msgpack/msgpack-perl/pull/1
+    mem.i = (mem.i & 0xFFFFFFFFUL) << 32UL | (mem.i >> 32UL);
+#endif
+    _msgpack_store64(&p[1], mem.i);
+    return 9;
+}
+
+// The number of elements that pack_array_body() encodes at once.
+const uint32_t bulk_batch_size = 64;
+
+template <bool Enabled>
+struct bulk_tag {};
+
+// max_size is the largest encoded size of an element.
+template <typename T>
+struct bulk_encoder {
+    static const bool enabled = false;
+};
+
+template <typename T>
+struct bulk_integer_encoder {
+    static const bool enabled = true;
+    static const std::size_t max_size = 1 + sizeof(T);
+    static std::size_t encode(char* p, T d) {
+        return std::numeric_limits<T>::is_signed ?
+            encode_int(p, static_cast<int64_t>(d)) :
+            encode_uint(p, static_cast<uint64_t>(d));
+    }
+};
+
+template <> struct bulk_encoder<char> : bulk_integer_encoder<char> {};
+template <> struct bulk_encoder<signed char> : bulk_integer_encoder<signed char> {};
+template <> struct bulk_encoder<unsigned char> : bulk_integer_encoder<unsigned char> {};
+template <> struct bulk_encoder<signed short> : bulk_integer_encoder<signed short> {};
+template <> struct bulk_encoder<unsigned short> : bulk_integer_encoder<unsigned short> {};
+template <> struct bulk_encoder<signed int> : bulk_integer_encoder<signed int> {};
+template <> struct bulk_encoder<unsigned int> : bulk_integer_encoder<unsigned int> {};
+template <> struct bulk_encoder<signed long> : bulk_integer_encoder<signed long> {};
+template <> struct bulk_encoder<unsigned long> : bulk_integer_encoder<unsigned long> {};
+template <> struct bulk_encoder<signed long long> : bulk_integer_encoder<signed long long> {};
+template <> struct bulk_encoder<unsigned long long> : bulk_integer_encoder<unsigned long long> {};
+
+template <>
+struct bulk_encoder<bool> {
+    static const bool enabled = true;
+    static const std::size_t max_size = 1;
+    static std::size_t encode(char* p, bool d) {
+        p[0] = static_cast<char>(d ? 0xc3u : 0xc2u);
+        return 1;
+    }
+};
+
+template <>
+struct bulk_encoder<float> {
+    static const bool enabled = true;
+    static const std::size_t max_size = 5;
+    static std::size_t encode(char* p, float d) {
+        return encode_float(p, d);
+    }
+};
+
+template <>
+struct bulk_encoder<double> {
+    static const bool enabled = true;
+    static const std::size_t max_size = 9;
+    static std::size_t encode(char* p, double d) {
+        return encode_double(p, d);
+    }
+};
+
+} // namespace detail
+
 /// The class template that supports continuous packing.
 /**
  * @tparam Stream  Any type that have a member function `Stream write(const char*, size_t s)`
+ *                 If it also has `char* prepare(size_t len)` that returns a writable region
+ *                 of at least len bytes and `void commit(size_t len)` that appends len bytes
+ *                 written there, headers and scalars are packed directly into the stream.
  *
  */
 template <typename Stream>
@@ -484,6 +674,21 @@ public:
      */
     packer<Stream>& pack_array(uint32_t n);
 
+    /// Packing array elements
+    /**
+     * You need to call this function just after `pack_array(uint32_t n)` calling.
+     * Each element is packed by `pack()`. The elements of bool, integer, float,
+     * and double are encoded in batches, so the stream is written once per batch
+     * instead of once per element.
+     *
+     * @param b The pointer to the first element.
+     * @param l The number of elements.
+     *
+     * @return The reference of `*this`.
+     */
+    template <typename T>
+    packer<Stream>& pack_array_body(const T* b, uint32_t l);
+
     /// Packing map header and size
     /**
      * The packed type is map header and map size.
@@ -618,6 +823,11 @@ private:
     template <typename T>
     void pack_imp_int64(T d);
 
+    template <typename T>
+    void pack_array_body_imp(const T* b, uint32_t l, detail::bulk_tag<false>);
+    template <typename T>
+    void pack_array_body_imp(const T* b, uint32_t l, detail::bulk_tag<true>);
+
     void append_buffer(const char* buf, size_t len)
     {
         append_buffer(&Stream::write, buf, len);
@@ -629,6 +839,16 @@ private:
         m_stream.write(buf, static_cast<SizeType>(len));
     }
 
+    char* prepare_buffer(char* buf, size_t len)
+    {
+        return detail::packer_sink<Stream>::prepare(m_stream, buf, len);
+    }
+
+    void commit_buffer(const char* buf, size_t len)
+    {
+        detail::packer_sink<Stream>::commit(m_stream, buf, len);
+    }
+
 private:
     Stream& m_stream;
 
@@ -760,70 +980,80 @@ inline packer<Stream>& packer<Stream>::pack_int64(int64_t d)
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_fix_uint8(uint8_t d)
 {
-    char buf[2] = {static_cast<char>(0xccu), take8_8(d)};
-    append_buffer(buf, 2);
+    char tmp[2];
+    char* buf = prepare_buffer(tmp, 2);
+    buf[0] = static_cast<char>(0xccu); buf[1] = take8_8(d);
+    commit_buffer(buf, 2);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_fix_uint16(uint16_t d)
 {
-    char buf[3];
+    char tmp[3];
+    char* buf = prepare_buffer(tmp, 3);
     buf[0] = static_cast<char>(0xcdu); _msgpack_store16(&buf[1], d);
-    append_buffer(buf, 3);
+    commit_buffer(buf, 3);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_fix_uint32(uint32_t d)
 {
-    char buf[5];
+    char tmp[5];
+    char* buf = prepare_buffer(tmp, 5);
     buf[0] = static_cast<char>(0xceu); _msgpack_store32(&buf[1], d);
-    append_buffer(buf, 5);
+    commit_buffer(buf, 5);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_fix_uint64(uint64_t d)
 {
-    char buf[9];
+    char tmp[9];
+    char* buf = prepare_buffer(tmp, 9);
     buf[0] = static_cast<char>(0xcfu); _msgpack_store64(&buf[1], d);
-    append_buffer(buf, 9);
+    commit_buffer(buf, 9);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_fix_int8(int8_t d)
 {
-    char buf[2] = {static_cast<char>(0xd0u), take8_8(d)};
-    append_buffer(buf, 2);
+    char tmp[2];
+    char* buf = prepare_buffer(tmp, 2);
+    buf[0] = static_cast<char>(0xd0u); buf[1] = take8_8(d);
+    commit_buffer(buf, 2);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_fix_int16(int16_t d)
 {
-    char buf[3];
+    char tmp[3];
+    char* buf = prepare_buffer(tmp, 3);
     buf[0] = static_cast<char>(0xd1u); _msgpack_store16(&buf[1], (uint16_t)d);
-    append_buffer(buf, 3);
+    commit_buffer(buf, 3);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_fix_int32(int32_t d)
 {
-    char buf[5];
+    char tmp[5];
+    char* buf = prepare_buffer(tmp, 5);
     buf[0] = static_cast<char>(0xd2u); _msgpack_store32(&buf[1], (uint32_t)d);
-    append_buffer(buf, 5);
+    commit_buffer(buf, 5);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_fix_int64(int64_t d)
 {
-    char buf[9];
+    char tmp[9];
+    char* buf = prepare_buffer(tmp, 9);
     buf[0] = static_cast<char>(0xd3u); _msgpack_store64(&buf[1], d);
-    append_buffer(buf, 9);
+    commit_buffer(buf, 9);
     return *this;
 }
 
@@ -1138,30 +1368,20 @@ inline packer<Stream>& packer<Stream>::pack_unsigned_long_long(unsigned long lon
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_float(float d)
 {
-    union { float f; uint32_t i; } mem;
-    mem.f = d;
-    char buf[5];
-    buf[0] = static_cast<char>(0xcau); _msgpack_store32(&buf[1], mem.i);
-    append_buffer(buf, 5);
+    char tmp[5];
+    char* buf = prepare_buffer(tmp, 5);
+    detail::encode_float(buf, d);
+    commit_buffer(buf, 5);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_double(double d)
 {
-    union { double f; uint64_t i; } mem;
-    mem.f = d;
-    char buf[9];
-    buf[0] = static_cast<char>(0xcbu);
-
-#if defined(TARGET_OS_IPHONE)
-    // ok
-#elif defined(__arm__) && !(__ARM_EABI__) // arm-oabi
-    // https://github.com/msgpack/msgpack-perl/pull/1
-    mem.i = (mem.i & 0xFFFFFFFFUL) << 32UL | (mem.i >> 32UL);
-#endif
-    _msgpack_store64(&buf[1], mem.i);
-    append_buffer(buf, 9);
+    char tmp[9];
+    char* buf = prepare_buffer(tmp, 9);
+    detail::encode_double(buf, d);
+    commit_buffer(buf, 9);
     return *this;
 }
 
@@ -1169,24 +1389,30 @@ inline packer<Stream>& packer<Stream>::pack_double(double d)
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_nil()
 {
-    const char d = static_cast<char>(0xc0u);
-    append_buffer(&d, 1);
+    char tmp;
+    char* buf = prepare_buffer(&tmp, 1);
+    buf[0] = static_cast<char>(0xc0u);
+    commit_buffer(buf, 1);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_true()
 {
-    const char d = static_cast<char>(0xc3u);
-    append_buffer(&d, 1);
+    char tmp;
+    char* buf = prepare_buffer(&tmp, 1);
+    buf[0] = static_cast<char>(0xc3u);
+    commit_buffer(buf, 1);
     return *this;
 }
 
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_false()
 {
-    const char d = static_cast<char>(0xc2u);
-    append_buffer(&d, 1);
+    char tmp;
+    char* buf = prepare_buffer(&tmp, 1);
+    buf[0] = static_cast<char>(0xc2u);
+    commit_buffer(buf, 1);
     return *this;
 }
 
@@ -1195,35 +1421,79 @@ template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_array(uint32_t n)
 {
     if(n < 16) {
-        char d = static_cast<char>(0x90u | n);
-        append_buffer(&d, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = static_cast<char>(0x90u | n);
+        commit_buffer(buf, 1);
     } else if(n < 65536) {
-        char buf[3];
+        char tmp[3];
+        char* buf = prepare_buffer(tmp, 3);
         buf[0] = static_cast<char>(0xdcu); _msgpack_store16(&buf[1], static_cast<uint16_t>(n));
-        append_buffer(buf, 3);
+        commit_buffer(buf, 3);
     } else {
-        char buf[5];
+        char tmp[5];
+        char* buf = prepare_buffer(tmp, 5);
         buf[0] = static_cast<char>(0xddu); _msgpack_store32(&buf[1], static_cast<uint32_t>(n));
-        append_buffer(buf, 5);
+        commit_buffer(buf, 5);
     }
     return *this;
 }
 
+template <typename Stream>
+template <typename T>
+inline packer<Stream>& packer<Stream>::pack_array_body(const T* b, uint32_t l)
+{
+    pack_array_body_imp(b, l, detail::bulk_tag<detail::bulk_encoder<T>::enabled>());
+    return *this;
+}
+
+template <typename Stream>
+template <typename T>
+inline void packer<Stream>::pack_array_body_imp(const T* b, uint32_t l, detail::bulk_tag<false>)
+{
+    for (const T* e = b + l; b != e; ++b) {
+        pack(*b);
+    }
+}
+
+template <typename Stream>
+template <typename T>
+inline void packer<Stream>::pack_array_body_imp(const T* b, uint32_t l, detail::bulk_tag<true>)
+{
+    typedef detail::bulk_encoder<T> encoder;
+    // The region for a batch is prepared and committed once.
+    char tmp[detail::bulk_batch_size * encoder::max_size];
+    while (l != 0) {
+        uint32_t n = l < detail::bulk_batch_size ? l : detail::bulk_batch_size;
+        char* buf = prepare_buffer(tmp, n * encoder::max_size);
+        char* p = buf;
+        for (const T* e = b + n; b != e; ++b) {
+            p += encoder::encode(p, *b);
+        }
+        commit_buffer(buf, static_cast<size_t>(p - buf));
+        l -= n;
+    }
+}
+
 template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_map(uint32_t n)
 {
     if(n < 16) {
         unsigned char d = static_cast<unsigned char>(0x80u | n);
-        char buf = take8_8(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_8(d);
+        commit_buffer(buf, 1);
     } else if(n < 65536) {
-        char buf[3];
+        char tmp[3];
+        char* buf = prepare_buffer(tmp, 3);
         buf[0] = static_cast<char>(0xdeu); _msgpack_store16(&buf[1], static_cast<uint16_t>(n));
-        append_buffer(buf, 3);
+        commit_buffer(buf, 3);
     } else {
-        char buf[5];
+        char tmp[5];
+        char* buf = prepare_buffer(tmp, 5);
         buf[0] = static_cast<char>(0xdfu); _msgpack_store32(&buf[1], static_cast<uint32_t>(n));
-        append_buffer(buf, 5);
+        commit_buffer(buf, 5);
     }
     return *this;
 }
@@ -1233,20 +1503,25 @@ inline packer<Stream>& packer<Stream>::pack_str(uint32_t l)
 {
     if(l < 32) {
         unsigned char d = static_cast<uint8_t>(0xa0u | l);
-        char buf = take8_8(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_8(d);
+        commit_buffer(buf, 1);
     } else if(l < 256) {
-        char buf[2];
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
         buf[0] = static_cast<char>(0xd9u); buf[1] = static_cast<char>(l);
-        append_buffer(buf, 2);
+        commit_buffer(buf, 2);
     } else if(l < 65536) {
-        char buf[3];
+        char tmp[3];
+        char* buf = prepare_buffer(tmp, 3);
         buf[0] = static_cast<char>(0xdau); _msgpack_store16(&buf[1], static_cast<uint16_t>(l));
-        append_buffer(buf, 3);
+        commit_buffer(buf, 3);
     } else {
-        char buf[5];
+        char tmp[5];
+        char* buf = prepare_buffer(tmp, 5);
         buf[0] = static_cast<char>(0xdbu); _msgpack_store32(&buf[1], static_cast<uint32_t>(l));
-        append_buffer(buf, 5);
+        commit_buffer(buf, 5);
     }
     return *this;
 }
@@ -1265,16 +1540,20 @@ inline packer<Stream>& packer<Stream>::pack_v4raw(uint32_t l)
 {
     if(l < 32) {
         unsigned char d = static_cast<uint8_t>(0xa0u | l);
-        char buf = take8_8(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_8(d);
+        commit_buffer(buf, 1);
     } else if(l < 65536) {
-        char buf[3];
+        char tmp[3];
+        char* buf = prepare_buffer(tmp, 3);
         buf[0] = static_cast<char>(0xdau); _msgpack_store16(&buf[1], static_cast<uint16_t>(l));
-        append_buffer(buf, 3);
+        commit_buffer(buf, 3);
     } else {
-        char buf[5];
+        char tmp[5];
+        char* buf = prepare_buffer(tmp, 5);
         buf[0] = static_cast<char>(0xdbu); _msgpack_store32(&buf[1], static_cast<uint32_t>(l));
-        append_buffer(buf, 5);
+        commit_buffer(buf, 5);
     }
     return *this;
 }
@@ -1290,17 +1569,20 @@ template <typename Stream>
 inline packer<Stream>& packer<Stream>::pack_bin(uint32_t l)
 {
     if(l < 256) {
-        char buf[2];
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
         buf[0] = static_cast<char>(0xc4u); buf[1] = static_cast<char>(l);
-        append_buffer(buf, 2);
+        commit_buffer(buf, 2);
     } else if(l < 65536) {
-        char buf[3];
+        char tmp[3];
+        char* buf = prepare_buffer(tmp, 3);
         buf[0] = static_cast<char>(0xc5u); _msgpack_store16(&buf[1], static_cast<uint16_t>(l));
-        append_buffer(buf, 3);
+        commit_buffer(buf, 3);
     } else {
-        char buf[5];
+        char tmp[5];
+        char* buf = prepare_buffer(tmp, 5);
         buf[0] = static_cast<char>(0xc6u); _msgpack_store32(&buf[1], static_cast<uint32_t>(l));
-        append_buffer(buf, 5);
+        commit_buffer(buf, 5);
     }
     return *this;
 }
@@ -1317,54 +1599,62 @@ inline packer<Stream>& packer<Stream>::pack_ext(size_t l, int8_t type)
 {
     switch(l) {
     case 1: {
-        char buf[2];
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
         buf[0] = static_cast<char>(0xd4u);
         buf[1] = static_cast<char>(type);
-        append_buffer(buf, 2);
+        commit_buffer(buf, 2);
     } break;
     case 2: {
-        char buf[2];
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
         buf[0] = static_cast<char>(0xd5u);
         buf[1] = static_cast<char>(type);
-        append_buffer(buf, 2);
+        commit_buffer(buf, 2);
     } break;
     case 4: {
-        char buf[2];
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
         buf[0] = static_cast<char>(0xd6u);
         buf[1] = static_cast<char>(type);
-        append_buffer(buf, 2);
+        commit_buffer(buf, 2);
     } break;
     case 8: {
-        char buf[2];
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
         buf[0] = static_cast<char>(0xd7u);
         buf[1] = static_cast<char>(type);
-        append_buffer(buf, 2);
+        commit_buffer(buf, 2);
     } break;
     case 16: {
-        char buf[2];
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
         buf[0] = static_cast<char>(0xd8u);
         buf[1] = static_cast<char>(type);
-        append_buffer(buf, 2);
+        commit_buffer(buf, 2);
     } break;
     default:
         if(l < 256) {
-            char buf[3];
+            char tmp[3];
+            char* buf = prepare_buffer(tmp, 3);
             buf[0] = static_cast<char>(0xc7u);
             buf[1] = static_cast<char>(l);
             buf[2] = static_cast<char>(type);
-            append_buffer(buf, 3);
+            commit_buffer(buf, 3);
         } else if(l < 65536) {
-            char buf[4];
+            char tmp[4];
+            char* buf = prepare_buffer(tmp, 4);
             buf[0] = static_cast<char>(0xc8u);
             _msgpack_store16(&buf[1], static_cast<uint16_t>(l));
             buf[3] = static_cast<char>(type);
-            append_buffer(buf, 4);
+            commit_buffer(buf, 4);
         } else {
-            char buf[6];
+            char tmp[6];
+            char* buf = prepare_buffer(tmp, 6);
             buf[0] = static_cast<char>(0xc9u);
             _msgpack_store32(&buf[1], static_cast<uint32_t>(l));
             buf[5] = static_cast<char>(type);
-            append_buffer(buf, 6);
+            commit_buffer(buf, 6);
         }
         break;
     }
@@ -1384,12 +1674,16 @@ inline void packer<Stream>::pack_imp_uint8(T d)
 {
     if(d < (1<<7)) {
         /* fixnum */
-        char buf = take8_8(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_8(d);
+        commit_buffer(buf, 1);
     } else {
         /* unsigned 8 */
-        char buf[2] = {static_cast<char>(0xccu), take8_8(d)};
-        append_buffer(buf, 2);
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
+        buf[0] = static_cast<char>(0xccu); buf[1] = take8_8(d);
+        commit_buffer(buf, 2);
     }
 }
 
@@ -1399,17 +1693,22 @@ inline void packer<Stream>::pack_imp_uint16(T d)
 {
     if(d < (1<<7)) {
         /* fixnum */
-        char buf = take8_16(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_16(d);
+        commit_buffer(buf, 1);
     } else if(d < (1<<8)) {
         /* unsigned 8 */
-        char buf[2] = {static_cast<char>(0xccu), take8_16(d)};
-        append_buffer(buf, 2);
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
+        buf[0] = static_cast<char>(0xccu); buf[1] = take8_16(d);
+        commit_buffer(buf, 2);
     } else {
         /* unsigned 16 */
-        char buf[3];
+        char tmp[3];
+        char* buf = prepare_buffer(tmp, 3);
         buf[0] = static_cast<char>(0xcdu); _msgpack_store16(&buf[1], static_cast<uint16_t>(d));
-        append_buffer(buf, 3);
+        commit_buffer(buf, 3);
     }
 }
 
@@ -1420,24 +1719,30 @@ inline void packer<Stream>::pack_imp_uint32(T d)
     if(d < (1<<8)) {
         if(d < (1<<7)) {
             /* fixnum */
-            char buf = take8_32(d);
-            append_buffer(&buf, 1);
+            char tmp;
+            char* buf = prepare_buffer(&tmp, 1);
+            buf[0] = take8_32(d);
+            commit_buffer(buf, 1);
         } else {
             /* unsigned 8 */
-            char buf[2] = {static_cast<char>(0xccu), take8_32(d)};
-            append_buffer(buf, 2);
+            char tmp[2];
+            char* buf = prepare_buffer(tmp, 2);
+            buf[0] = static_cast<char>(0xccu); buf[1] = take8_32(d);
+            commit_buffer(buf, 2);
         }
     } else {
         if(d < (1<<16)) {
             /* unsigned 16 */
-            char buf[3];
+            char tmp[3];
+            char* buf = prepare_buffer(tmp, 3);
             buf[0] = static_cast<char>(0xcdu); _msgpack_store16(&buf[1], static_cast<uint16_t>(d));
-            append_buffer(buf, 3);
+            commit_buffer(buf, 3);
         } else {
             /* unsigned 32 */
-            char buf[5];
+            char tmp[5];
+            char* buf = prepare_buffer(tmp, 5);
             buf[0] = static_cast<char>(0xceu); _msgpack_store32(&buf[1], static_cast<uint32_t>(d));
-            append_buffer(buf, 5);
+            commit_buffer(buf, 5);
         }
     }
 }
@@ -1449,29 +1754,36 @@ inline void packer<Stream>::pack_imp_uint64(T d)
     if(d < (1ULL<<8)) {
         if(d < (1ULL<<7)) {
             /* fixnum */
-            char buf = take8_64(d);
-            append_buffer(&buf, 1);
+            char tmp;
+            char* buf = prepare_buffer(&tmp, 1);
+            buf[0] = take8_64(d);
+            commit_buffer(buf, 1);
         } else {
             /* unsigned 8 */
-            char buf[2] = {static_cast<char>(0xccu), take8_64(d)};
-            append_buffer(buf, 2);
+            char tmp[2];
+            char* buf = prepare_buffer(tmp, 2);
+            buf[0] = static_cast<char>(0xccu); buf[1] = take8_64(d);
+            commit_buffer(buf, 2);
         }
     } else {
         if(d < (1ULL<<16)) {
             /* unsigned 16 */
-            char buf[3];
+            char tmp[3];
+            char* buf = prepare_buffer(tmp, 3);
             buf[0] = static_cast<char>(0xcdu); _msgpack_store16(&buf[1], static_cast<uint16_t>(d));
-            append_buffer(buf, 3);
+            commit_buffer(buf, 3);
         } else if(d < (1ULL<<32)) {
             /* unsigned 32 */
-            char buf[5];
+            char tmp[5];
+            char* buf = prepare_buffer(tmp, 5);
             buf[0] = static_cast<char>(0xceu); _msgpack_store32(&buf[1], static_cast<uint32_t>(d));
-            append_buffer(buf, 5);
+            commit_buffer(buf, 5);
         } else {
             /* unsigned 64 */
-            char buf[9];
+            char tmp[9];
+            char* buf = prepare_buffer(tmp, 9);
             buf[0] = static_cast<char>(0xcfu); _msgpack_store64(&buf[1], d);
-            append_buffer(buf, 9);
+            commit_buffer(buf, 9);
         }
     }
 }
@@ -1482,12 +1794,16 @@ inline void packer<Stream>::pack_imp_int8(T d)
 {
     if(d < -(1<<5)) {
         /* signed 8 */
-        char buf[2] = {static_cast<char>(0xd0u), take8_8(d)};
-        append_buffer(buf, 2);
+        char tmp[2];
+        char* buf = prepare_buffer(tmp, 2);
+        buf[0] = static_cast<char>(0xd0u); buf[1] = take8_8(d);
+        commit_buffer(buf, 2);
     } else {
         /* fixnum */
-        char buf = take8_8(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_8(d);
+        commit_buffer(buf, 1);
     }
 }
 
@@ -1498,28 +1814,36 @@ inline void packer<Stream>::pack_imp_int16(T d)
     if(d < -(1<<5)) {
         if(d < -(1<<7)) {
             /* signed 16 */
-            char buf[3];
+            char tmp[3];
+            char* buf = prepare_buffer(tmp, 3);
             buf[0] = static_cast<char>(0xd1u); _msgpack_store16(&buf[1], static_cast<int16_t>(d));
-            append_buffer(buf, 3);
+            commit_buffer(buf, 3);
         } else {
             /* signed 8 */
-            char buf[2] = {static_cast<char>(0xd0u), take8_16(d)};
-            append_buffer(buf, 2);
+            char tmp[2];
+            char* buf = prepare_buffer(tmp, 2);
+            buf[0] = static_cast<char>(0xd0u); buf[1] = take8_16(d);
+            commit_buffer(buf, 2);
         }
     } else if(d < (1<<7)) {
         /* fixnum */
-        char buf = take8_16(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_16(d);
+        commit_buffer(buf, 1);
     } else {
         if(d < (1<<8)) {
             /* unsigned 8 */
-            char buf[2] = {static_cast<char>(0xccu), take8_16(d)};
-            append_buffer(buf, 2);
+            char tmp[2];
+            char* buf = prepare_buffer(tmp, 2);
+            buf[0] = static_cast<char>(0xccu); buf[1] = take8_16(d);
+            commit_buffer(buf, 2);
         } else {
             /* unsigned 16 */
-            char buf[3];
+            char tmp[3];
+            char* buf = prepare_buffer(tmp, 3);
             buf[0] = static_cast<char>(0xcdu); _msgpack_store16(&buf[1], static_cast<uint16_t>(d));
-            append_buffer(buf, 3);
+            commit_buffer(buf, 3);
         }
     }
 }
@@ -1531,38 +1855,48 @@ inline void packer<Stream>::pack_imp_int32(T d)
     if(d < -(1<<5)) {
         if(d < -(1<<15)) {
             /* signed 32 */
-            char buf[5];
+            char tmp[5];
+            char* buf = prepare_buffer(tmp, 5);
             buf[0] = static_cast<char>(0xd2u); _msgpack_store32(&buf[1], static_cast<int32_t>(d));
-            append_buffer(buf, 5);
+            commit_buffer(buf, 5);
         } else if(d < -(1<<7)) {
             /* signed 16 */
-            char buf[3];
+            char tmp[3];
+            char* buf = prepare_buffer(tmp, 3);
             buf[0] = static_cast<char>(0xd1u); _msgpack_store16(&buf[1], static_cast<int16_t>(d));
-            append_buffer(buf, 3);
+            commit_buffer(buf, 3);
         } else {
             /* signed 8 */
-            char buf[2] = { static_cast<char>(0xd0u), take8_32(d)};
-            append_buffer(buf, 2);
+            char tmp[2];
+            char* buf = prepare_buffer(tmp, 2);
+            buf[0] = static_cast<char>(0xd0u); buf[1] = take8_32(d);
+            commit_buffer(buf, 2);
         }
     } else if(d < (1<<7)) {
         /* fixnum */
-        char buf = take8_32(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_32(d);
+        commit_buffer(buf, 1);
     } else {
         if(d < (1<<8)) {
             /* unsigned 8 */
-            char buf[2] = { static_cast<char>(0xccu), take8_32(d)};
-            append_buffer(buf, 2);
+            char tmp[2];
+            char* buf = prepare_buffer(tmp, 2);
+            buf[0] = static_cast<char>(0xccu); buf[1] = take8_32(d);
+            commit_buffer(buf, 2);
         } else if(d < (1<<16)) {
             /* unsigned 16 */
-            char buf[3];
+            char tmp[3];
+            char* buf = prepare_buffer(tmp, 3);
             buf[0] = static_cast<char>(0xcdu); _msgpack_store16(&buf[1], static_cast<uint16_t>(d));
-            append_buffer(buf, 3);
+            commit_buffer(buf, 3);
         } else {
             /* unsigned 32 */
-            char buf[5];
+            char tmp[5];
+            char* buf = prepare_buffer(tmp, 5);
             buf[0] = static_cast<char>(0xceu); _msgpack_store32(&buf[1], static_cast<uint32_t>(d));
-            append_buffer(buf, 5);
+            commit_buffer(buf, 5);
         }
     }
 }
@@ -1575,54 +1909,66 @@ inline void packer<Stream>::pack_imp_int64(T d)
         if(d < -(1LL<<15)) {
             if(d < -(1LL<<31)) {
                 /* signed 64 */
-                char buf[9];
+                char tmp[9];
+                char* buf = prepare_buffer(tmp, 9);
                 buf[0] = static_cast<char>(0xd3u); _msgpack_store64(&buf[1], d);
-                append_buffer(buf, 9);
+                commit_buffer(buf, 9);
             } else {
                 /* signed 32 */
-                char buf[5];
+                char tmp[5];
+                char* buf = prepare_buffer(tmp, 5);
                 buf[0] = static_cast<char>(0xd2u); _msgpack_store32(&buf[1], static_cast<int32_t>(d));
-                append_buffer(buf, 5);
+                commit_buffer(buf, 5);
             }
         } else {
             if(d < -(1<<7)) {
                 /* signed 16 */
-                char buf[3];
+                char tmp[3];
+                char* buf = prepare_buffer(tmp, 3);
                 buf[0] = static_cast<char>(0xd1u); _msgpack_store16(&buf[1], static_cast<int16_t>(d));
-                append_buffer(buf, 3);
+                commit_buffer(buf, 3);
             } else {
                 /* signed 8 */
-                char buf[2] = {static_cast<char>(0xd0u), take8_64(d)};
-                append_buffer(buf, 2);
+                char tmp[2];
+                char* buf = prepare_buffer(tmp, 2);
+                buf[0] = static_cast<char>(0xd0u); buf[1] = take8_64(d);
+                commit_buffer(buf, 2);
             }
         }
     } else if(d < (1<<7)) {
         /* fixnum */
-        char buf = take8_64(d);
-        append_buffer(&buf, 1);
+        char tmp;
+        char* buf = prepare_buffer(&tmp, 1);
+        buf[0] = take8_64(d);
+        commit_buffer(buf, 1);
     } else {
         if(d < (1LL<<16)) {
             if(d < (1<<8)) {
                 /* unsigned 8 */
-                char buf[2] = {static_cast<char>(0xccu), take8_64(d)};
-                append_buffer(buf, 2);
+                char tmp[2];
+                char* buf = prepare_buffer(tmp, 2);
+                buf[0] = static_cast<char>(0xccu); buf[1] = take8_64(d);
+                commit_buffer(buf, 2);
             } else {
                 /* unsigned 16 */
-                char buf[3];
+                char tmp[3];
+                char* buf = prepare_buffer(tmp, 3);
                 buf[0] = static_cast<char>(0xcdu); _msgpack_store16(&buf[1], static_cast<uint16_t>(d));
-                append_buffer(buf, 3);
+                commit_buffer(buf, 3);
             }
         } else {
             if(d < (1LL<<32)) {
                 /* unsigned 32 */
-                char buf[5];
+                char tmp[5];
+                char* buf = prepare_buffer(tmp, 5);
                 buf[0] = static_cast<char>(0xceu); _msgpack_store32(&buf[1], static_cast<uint32_t>(d));
-                append_buffer(buf, 5);
+                commit_buffer(buf, 5);
             } else {
                 /* unsigned 64 */
-                char buf[9];
+                char tmp[9];
+                char* buf = prepare_buffer(tmp, 9);
                 buf[0] = static_cast<char>(0xcfu); _msgpack_store64(&buf[1], d);
-                append_buffer(buf, 9);
+                commit_buffer(buf, 9);
             }
         }
     }
@@ -0,0 +1,184 @@
+//
+// MessagePack for C++ serializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_PACKED_SIZE_HPP
+#define MSGPACK_V1_PACKED_SIZE_HPP
+
+#include "msgpack/v1/packed_size_decl.hpp"
+#include "msgpack/pack.hpp"
+#include "msgpack/adaptor/nil_decl.hpp"
+
+#include <utility>
+#include <vector>
+
+#if !defined(MSGPACK_USE_CPP03)
+#include <array>
+#include <tuple>
+#endif // !defined(MSGPACK_USE_CPP03)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+namespace detail {
+
+// The stream that counts the packed bytes only. The packer encodes
+// headers and scalars to m_buf by prepare() and commit(), and passes
+// the bodies to write() that doesn't copy them.
+class packed_size_counter {
+public:
+    packed_size_counter():m_size(0) {}
+    void write(const char*, std::size_t len) {
+        m_size += len;
+    }
+    char* prepare(std::size_t len) {
+        if (len <= sizeof(m_buf)) {
+            return m_buf;
+        }
+        // the stream contract allows any size
+        if (m_large.size() < len) {
+            m_large.resize(len);
+        }
+        return &m_large[0];
+    }
+    void commit(std::size_t len) {
+        m_size += len;
+    }
+    std::size_t size() const {
+        return m_size;
+    }
+private:
+    std::size_t m_size;
+    // headers and scalars are at most 9 bytes, and so are the elements
+    // of a batch that pack_array_body() prepares
+    char m_buf[bulk_batch_size * 9];
+    std::vector<char> m_large;
+};
+
+template <std::size_t N>
+struct packed_size_constant {
+    static const std::size_t value = N;
+};
+
+template <std::size_t N>
+const std::size_t packed_size_constant<N>::value;
+
+template <std::size_t N>
+struct array_header_size
+    : packed_size_constant<N < 16 ? 1 : N < 65536 ? 3 : 5> {};
+
+template <std::size_t N>
+struct str_header_size
+    : packed_size_constant<N < 32 ? 1 : N < 256 ? 2 : N < 65536 ? 3 : 5> {};
+
+template <std::size_t N>
+struct bin_header_size
+    : packed_size_constant<N < 256 ? 2 : N < 65536 ? 3 : 5> {};
+
+} // namespace detail
+
+template <typename T>
+inline std::size_t packed_size(T const& v)
+{
+    detail::packed_size_counter c;
+    msgpack::pack(c, v);
+    return c.size();
+}
+
+template <>
+struct max_packed_size<bool> : detail::packed_size_constant<1> {};
+
+template <>
+struct max_packed_size<type::nil_t> : detail::packed_size_constant<1> {};
+
+// The header byte and the widest integer
+template <>
+struct max_packed_size<char> : detail::packed_size_constant<1 + sizeof(char)> {};
+template <>
+struct max_packed_size<signed char> : detail::packed_size_constant<1 + sizeof(signed char)> {};
+template <>
+struct max_packed_size<unsigned char> : detail::packed_size_constant<1 + sizeof(unsigned char)> {};
+template <>
+struct max_packed_size<signed short> : detail::packed_size_constant<1 + sizeof(signed short)> {};
+template <>
+struct max_packed_size<unsigned short> : detail::packed_size_constant<1 + sizeof(unsigned short)> {};
+template <>
+struct max_packed_size<signed int> : detail::packed_size_constant<1 + sizeof(signed int)> {};
+template <>
+struct max_packed_size<unsigned int> : detail::packed_size_constant<1 + sizeof(unsigned int)> {};
+template <>
+struct max_packed_size<signed long> : detail::packed_size_constant<1 + sizeof(signed long)> {};
+template <>
+struct max_packed_size<unsigned long> : detail::packed_size_constant<1 + sizeof(unsigned long)> {};
+template <>
+struct max_packed_size<signed long long> : detail::packed_size_constant<1 + sizeof(signed long long)> {};
+template <>
+struct max_packed_size<unsigned long long> : detail::packed_size_constant<1 + sizeof(unsigned long long)> {};
+
+template <>
+struct max_packed_size<float> : detail::packed_size_constant<5> {};
+template <>
+struct max_packed_size<double> : detail::packed_size_constant<9> {};
+
+template <typename T, std::size_t N>
+struct max_packed_size<T[N]>
+    : detail::packed_size_constant<detail::array_header_size<N>::value + N * max_packed_size<T>::value> {};
+
+// str up to the first '\0'
+template <std::size_t N>
+struct max_packed_size<char[N]>
+    : detail::packed_size_constant<detail::str_header_size<N>::value + N> {};
+
+template <std::size_t N>
+struct max_packed_size<unsigned char[N]>
+    : detail::packed_size_constant<detail::bin_header_size<N>::value + N> {};
+
+template <typename T1, typename T2>
+struct max_packed_size<std::pair<T1, T2> >
+    : detail::packed_size_constant<1 + max_packed_size<T1>::value + max_packed_size<T2>::value> {};
+
+#if !defined(MSGPACK_USE_CPP03)
+
+template <typename T, std::size_t N>
+struct max_packed_size<std::array<T, N>>
+    : detail::packed_size_constant<detail::array_header_size<N>::value + N * max_packed_size<T>::value> {};
+
+template <std::size_t N>
+struct max_packed_size<std::array<char, N>>
+    : detail::packed_size_constant<detail::bin_header_size<N>::value + N> {};
+
+template <std::size_t N>
+struct max_packed_size<std::array<unsigned char, N>>
+    : detail::packed_size_constant<detail::bin_header_size<N>::value + N> {};
+
+namespace detail {
+
+template <typename... Args>
+struct max_packed_size_sum : packed_size_constant<0> {};
+
+template <typename T, typename... Args>
+struct max_packed_size_sum<T, Args...>
+    : packed_size_constant<max_packed_size<T>::value + max_packed_size_sum<Args...>::value> {};
+
+} // namespace detail
+
+template <typename... Args>
+struct max_packed_size<std::tuple<Args...>>
+    : detail::packed_size_constant<
+        detail::array_header_size<sizeof...(Args)>::value + detail::max_packed_size_sum<Args...>::value> {};
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V1_PACKED_SIZE_HPP
@@ -0,0 +1,54 @@
+//
+// MessagePack for C++ serializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_PACKED_SIZE_DECL_HPP
+#define MSGPACK_V1_PACKED_SIZE_DECL_HPP
+
+#include "msgpack/versioning.hpp"
+#include "msgpack/cpp_config.hpp"
+
+#include <cstddef>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+/// Get the size of the value packed as MessagePack format
+/**
+ * The value is packed by the same adaptors as msgpack::pack(), but only
+ * the number of the bytes is counted. The bodies of str, bin and ext
+ * are not copied.
+ *
+ * @tparam T Any type that is adapted to MessagePack
+ * @param v The value
+ *
+ * @return The exact number of the bytes that msgpack::pack() writes.
+ */
+template <typename T>
+std::size_t packed_size(T const& v);
+
+/// The upper bound of the packed size of the fixed-shape type
+/**
+ * `max_packed_size<T>::value` is a constant expression. It is defined for
+ * bool, integral and floating point types, msgpack::type::nil_t, C arrays,
+ * std::pair, and std::array and std::tuple on C++11 or later, if the
+ * elements are also fixed-shape. It isn't defined for the other types.
+ *
+ * @tparam T The type of the value
+ */
+template <typename T>
+struct max_packed_size;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V1_PACKED_SIZE_DECL_HPP
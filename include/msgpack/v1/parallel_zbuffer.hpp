@@ -0,0 +1,392 @@
+//
+// MessagePack for C++ parallel deflate buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_PARALLEL_ZBUFFER_HPP
+#define MSGPACK_V1_PARALLEL_ZBUFFER_HPP
+
+#include "msgpack/v1/parallel_zbuffer_decl.hpp"
+#include "msgpack/zbuffer_decl.hpp"
+
+#if !defined(MSGPACK_USE_CPP03)
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <zlib.h>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+/// The deflate buffer that compresses blocks on worker threads.
+/**
+ * The input is split into blocks of block_size bytes. The blocks are
+ * compressed by num_threads worker threads, that are started at the first
+ * block and take the blocks from a queue of at most num_threads blocks.
+ * Each block is compressed as raw deflate data, primed with the last
+ * 32KiB of the previous block, and ended by a sync flush. The blocks are
+ * joined in order with the zlib header and the combined Adler-32 into a
+ * single zlib stream, the same format that msgpack::zbuffer creates.
+ *
+ * The interface is the same as msgpack::zbuffer. size() and data() contain
+ * the blocks that are compressed in order so far, and flush() waits for
+ * all blocks and finishes the stream. Calling flush() again returns the
+ * same stream, and write() throws std::logic_error until reset() starts
+ * a new stream.
+ */
+class parallel_zbuffer {
+private:
+    struct block {
+        std::vector<char> in;
+        std::vector<char> dict;
+        std::vector<char> out;
+        uLong adler;
+        bool last;
+        // set by the worker under m_mutex
+        bool done;
+        std::exception_ptr error;
+    };
+
+public:
+    /**
+     * @param level The compression level of zlib.
+     * @param block_size The size of the input that is compressed by a worker at once.
+     * @param num_threads The number of the worker threads.
+     *                    If 0, std::thread::hardware_concurrency() is used.
+     * @param init_size The initial size of the output buffer.
+     */
+    parallel_zbuffer(int level = Z_DEFAULT_COMPRESSION,
+                     size_t block_size = MSGPACK_PARALLEL_ZBUFFER_BLOCK_SIZE,
+                     size_t num_threads = 0,
+                     size_t init_size = MSGPACK_ZBUFFER_INIT_SIZE)
+        : m_level(level), m_block_size(std::max<size_t>(block_size, 1)),
+          m_num_threads(num_threads), m_init_size(init_size),
+          m_data(MSGPACK_NULLPTR), m_size(0), m_capacity(0),
+          m_adler(adler32(0, Z_NULL, 0)), m_started(false), m_finished(false),
+          m_stop(false)
+    {
+        if (m_num_threads == 0) m_num_threads = std::thread::hardware_concurrency();
+        if (m_num_threads == 0) m_num_threads = 1;
+    }
+
+    ~parallel_zbuffer()
+    {
+        discard();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_work.notify_all();
+        for (std::thread& t : m_workers) {
+            t.join();
+        }
+        ::free(m_data);
+    }
+
+public:
+    void write(const char* buf, size_t len)
+    {
+        if (m_finished) {
+            throw std::logic_error("parallel_zbuffer: write() after flush() without reset()");
+        }
+        while (len > 0) {
+            if (!m_current) {
+                m_current.reset(new block());
+                m_current->in.reserve(m_block_size);
+            }
+            std::vector<char>& in = m_current->in;
+            size_t n = std::min(len, m_block_size - in.size());
+            in.insert(in.end(), buf, buf + n);
+            buf += n;
+            len -= n;
+            if (in.size() == m_block_size) {
+                submit(false);
+            }
+        }
+    }
+
+    char* flush()
+    {
+        if (m_finished) {
+            return m_data;
+        }
+        if (!m_current) {
+            m_current.reset(new block());
+        }
+        submit(true);
+        collect(0);
+        char* p = reserve(4);
+        p[0] = static_cast<char>(m_adler >> 24);
+        p[1] = static_cast<char>(m_adler >> 16);
+        p[2] = static_cast<char>(m_adler >> 8);
+        p[3] = static_cast<char>(m_adler);
+        m_size += 4;
+        m_finished = true;
+        return m_data;
+    }
+
+    char* data()
+    {
+        return m_data;
+    }
+
+    const char* data() const
+    {
+        return m_data;
+    }
+
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    void reset()
+    {
+        discard();
+        m_current.reset();
+        m_tail_dict.clear();
+        m_adler = adler32(0, Z_NULL, 0);
+        m_started = false;
+        m_finished = false;
+        reset_buffer();
+    }
+
+    void reset_buffer()
+    {
+        m_size = 0;
+    }
+
+    char* release_buffer()
+    {
+        char* tmp = m_data;
+        m_data = MSGPACK_NULLPTR;
+        m_size = 0;
+        m_capacity = 0;
+        return tmp;
+    }
+
+private:
+    // Queues m_current to the workers. The last 32KiB of the input
+    // is kept as the dictionary of the next block.
+    void submit(bool last)
+    {
+        // num_threads blocks are being compressed and at most
+        // num_threads blocks wait in the queue
+        collect(2 * m_num_threads - 1);
+        start_workers();
+
+        block* b = m_current.get();
+        b->last = last;
+        b->done = false;
+        b->dict.swap(m_tail_dict);
+        const size_t dsize = std::min<size_t>(b->in.size(), 32768);
+        m_tail_dict.assign(b->in.end() - static_cast<std::ptrdiff_t>(dsize), b->in.end());
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_queue.push_back(b);
+        }
+        m_work.notify_one();
+        m_blocks.push_back(std::move(m_current));
+    }
+
+    // Appends the compressed blocks in order until at most max_blocks are left.
+    void collect(size_t max_blocks)
+    {
+        while (m_blocks.size() > max_blocks) {
+            std::unique_ptr<block> b = std::move(m_blocks.front());
+            m_blocks.pop_front();
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_done.wait(lock, [&b] { return b->done; });
+            }
+            if (b->error) {
+                std::rethrow_exception(b->error);
+            }
+            append(*b);
+        }
+    }
+
+    // Drops the queued blocks and waits for the blocks that are being compressed.
+    void discard()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        for (block* b : m_queue) {
+            b->done = true;
+        }
+        m_queue.clear();
+        for (std::unique_ptr<block>& b : m_blocks) {
+            m_done.wait(lock, [&b] { return b->done; });
+        }
+        m_blocks.clear();
+    }
+
+    void start_workers()
+    {
+        while (m_workers.size() < m_num_threads) {
+            m_workers.emplace_back(&parallel_zbuffer::work, this);
+        }
+    }
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true) {
+            m_work.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_queue.empty()) {
+                return;
+            }
+            block* b = m_queue.front();
+            m_queue.pop_front();
+            lock.unlock();
+            try {
+                compress(m_level, b);
+            }
+            catch (...) {
+                b->error = std::current_exception();
+            }
+            lock.lock();
+            b->done = true;
+            m_done.notify_all();
+        }
+    }
+
+    void append(block const& b)
+    {
+        if (!m_started) {
+            // CMF: deflate with 32KiB window, FLG: FLEVEL and FCHECK
+            unsigned int flevel =
+                m_level == Z_DEFAULT_COMPRESSION ? 2 :
+                m_level < 2 ? 0 : m_level < 6 ? 1 : m_level == 6 ? 2 : 3;
+            unsigned int header = (0x78u << 8) | (flevel << 6);
+            if (header % 31 != 0) {
+                header += 31 - header % 31;
+            }
+            char* p = reserve(2);
+            p[0] = static_cast<char>(header >> 8);
+            p[1] = static_cast<char>(header);
+            m_size += 2;
+            m_started = true;
+        }
+        if (!b.out.empty()) {
+            std::memcpy(reserve(b.out.size()), b.out.data(), b.out.size());
+            m_size += b.out.size();
+        }
+        m_adler = adler32_combine(m_adler, b.adler, static_cast<z_off_t>(b.in.size()));
+    }
+
+    char* reserve(size_t len)
+    {
+        if (m_capacity - m_size < len) {
+            size_t nsize = m_capacity == 0 ? std::max<size_t>(m_init_size, 1) : m_capacity * 2;
+            while (nsize < m_size + len) {
+                nsize *= 2;
+            }
+            char* tmp = static_cast<char*>(::realloc(m_data, nsize));
+            if (tmp == MSGPACK_NULLPTR) {
+                throw std::bad_alloc();
+            }
+            m_data = tmp;
+            m_capacity = nsize;
+        }
+        return m_data + m_size;
+    }
+
+    static void compress(int level, block* b)
+    {
+        z_stream s;
+        s.zalloc = Z_NULL;
+        s.zfree = Z_NULL;
+        s.opaque = Z_NULL;
+        if (deflateInit2(&s, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::bad_alloc();
+        }
+        int ret = Z_OK;
+        if (!b->dict.empty()) {
+            ret = deflateSetDictionary(&s, reinterpret_cast<const Bytef*>(b->dict.data()),
+                                       static_cast<uInt>(b->dict.size()));
+        }
+        const uInt len = static_cast<uInt>(b->in.size());
+        b->adler = adler32(adler32(0, Z_NULL, 0), reinterpret_cast<const Bytef*>(b->in.data()), len);
+        // the bound of Z_FINISH, and the empty stored block of Z_SYNC_FLUSH
+        b->out.resize(deflateBound(&s, len) + 16);
+        s.next_in = reinterpret_cast<Bytef*>(b->in.data());
+        s.avail_in = len;
+        s.next_out = reinterpret_cast<Bytef*>(b->out.data());
+        s.avail_out = static_cast<uInt>(b->out.size());
+        const int flush = b->last ? Z_FINISH : Z_SYNC_FLUSH;
+        while (ret == Z_OK || ret == Z_BUF_ERROR) {
+            ret = deflate(&s, flush);
+            if (ret == Z_STREAM_END || (ret == Z_OK && s.avail_out != 0 && !b->last)) {
+                ret = Z_STREAM_END;
+                break;
+            }
+            size_t used = b->out.size() - s.avail_out;
+            b->out.resize(b->out.size() * 2);
+            s.next_out = reinterpret_cast<Bytef*>(b->out.data() + used);
+            s.avail_out = static_cast<uInt>(b->out.size() - used);
+        }
+        b->out.resize(b->out.size() - s.avail_out);
+        deflateEnd(&s);
+        std::vector<char>().swap(b->dict);
+        if (ret != Z_STREAM_END) {
+            throw std::bad_alloc();
+        }
+    }
+
+    parallel_zbuffer(const parallel_zbuffer&) = delete;
+    parallel_zbuffer& operator=(const parallel_zbuffer&) = delete;
+
+private:
+    int m_level;
+    size_t m_block_size;
+    size_t m_num_threads;
+    size_t m_init_size;
+
+    char* m_data;
+    size_t m_size;
+    size_t m_capacity;
+    uLong m_adler;
+    bool m_started;
+    bool m_finished;
+
+    // the block that is being written, and the dictionary for the next block
+    std::unique_ptr<block> m_current;
+    std::vector<char> m_tail_dict;
+
+    // the blocks that are queued or being compressed, in the stream order
+    std::deque<std::unique_ptr<block> > m_blocks;
+
+    std::vector<std::thread> m_workers;
+    std::mutex m_mutex;
+    // signaled when a block is queued or the workers are stopped
+    std::condition_variable m_work;
+    // signaled when a block is compressed
+    std::condition_variable m_done;
+    // the blocks that no worker has taken yet, guarded by m_mutex
+    std::deque<block*> m_queue;
+    bool m_stop;
+};
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+#endif // MSGPACK_V1_PARALLEL_ZBUFFER_HPP
@@ -0,0 +1,35 @@
+//
+// MessagePack for C++ parallel deflate buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_PARALLEL_ZBUFFER_DECL_HPP
+#define MSGPACK_V1_PARALLEL_ZBUFFER_DECL_HPP
+
+#include "msgpack/versioning.hpp"
+
+#if !defined(MSGPACK_USE_CPP03)
+
+#ifndef MSGPACK_PARALLEL_ZBUFFER_BLOCK_SIZE
+#define MSGPACK_PARALLEL_ZBUFFER_BLOCK_SIZE (128*1024)
+#endif
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+class parallel_zbuffer;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+#endif // MSGPACK_V1_PARALLEL_ZBUFFER_DECL_HPP
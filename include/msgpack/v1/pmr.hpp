@@ -0,0 +1,80 @@
+//
+// MessagePack for C++ std::pmr::memory_resource adapter
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_PMR_HPP
+#define MSGPACK_V1_PMR_HPP
+
+#include "msgpack/v1/pmr_decl.hpp"
+
+#if defined(MSGPACK_PMR)
+
+#include "msgpack/object.hpp"
+#include "msgpack/zone.hpp"
+#include "msgpack/adaptor/cpp17/pmr.hpp"
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+/// The monotonic memory resource that allocates from a zone.
+/**
+ * The allocations are served by zone::allocate_align(), and deallocation
+ * does nothing. The memory is released when the zone is cleared or
+ * destroyed, so the objects that use the resource must not outlive the
+ * contents of the zone. The zone is not owned by the resource.
+ *
+ * The resource can be used for the zone of an object_handle, and then
+ * the converted containers are in the same arena as the object tree.
+ */
+class zone_memory_resource : public std::pmr::memory_resource {
+public:
+    explicit zone_memory_resource(msgpack::zone& z) noexcept
+        :m_zone(z) {}
+
+    msgpack::zone& zone() const noexcept
+    {
+        return m_zone;
+    }
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        return m_zone.allocate_align(bytes, alignment);
+    }
+
+    void do_deallocate(void*, std::size_t, std::size_t) override
+    {
+    }
+
+    bool do_is_equal(std::pmr::memory_resource const& other) const noexcept override
+    {
+        return this == &other;
+    }
+
+private:
+    msgpack::zone& m_zone;
+};
+
+template <typename T>
+inline T as(msgpack::object const& o, std::pmr::memory_resource* r)
+{
+    T v = detail::make_with_allocator<T>(std::pmr::polymorphic_allocator<std::byte>(r));
+    o.convert(v);
+    return v;
+}
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_PMR)
+
+#endif // MSGPACK_V1_PMR_HPP
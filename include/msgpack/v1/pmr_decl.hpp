@@ -0,0 +1,53 @@
+//
+// MessagePack for C++ std::pmr::memory_resource adapter
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_PMR_DECL_HPP
+#define MSGPACK_V1_PMR_DECL_HPP
+
+#include "msgpack/versioning.hpp"
+#include "msgpack/cpp_config_decl.hpp"
+#include "msgpack/object_fwd_decl.hpp"
+
+#if !defined(MSGPACK_USE_CPP03) && __cplusplus >= 201703 && MSGPACK_HAS_INCLUDE(<memory_resource>)
+#define MSGPACK_PMR
+#endif
+
+#if defined(MSGPACK_PMR)
+
+#include <memory_resource>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+class zone_memory_resource;
+
+/// Convert the object to T whose allocations are from the resource.
+/**
+ * T is constructed with std::pmr::polymorphic_allocator of r if T uses
+ * the allocator, and the std::pmr containers in T get r by the uses
+ * allocator construction.
+ *
+ * @param o The object that is converted.
+ * @param r The memory resource.
+ *
+ * @return The converted value.
+ */
+template <typename T>
+T as(msgpack::object const& o, std::pmr::memory_resource* r);
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_PMR)
+
+#endif // MSGPACK_V1_PMR_DECL_HPP
@@ -11,9 +11,20 @@
 #define MSGPACK_V1_SBUFFER_HPP
 
 #include "msgpack/v1/sbuffer_decl.hpp"
+#include "msgpack/memory_pool.hpp"
 
 #include <stdexcept>
 #include <cstring>
+#include <cstdlib>
+
+// mremap() and MREMAP_MAYMOVE need _GNU_SOURCE, that g++ and clang++ define by default.
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#if defined(MREMAP_MAYMOVE)
+#define MSGPACK_SBUFFER_MMAP 1
+#endif // defined(MREMAP_MAYMOVE)
+#endif // defined(__linux__)
 
 namespace msgpack {
 
@@ -21,23 +32,168 @@ namespace msgpack {
 MSGPACK_API_VERSION_NAMESPACE(v1) {
 /// @endcond
 
+/// The memory allocator of sbuffer
+/**
+ * `reallocate` resizes the memory at `ptr` from `old_size` bytes to `new_size` bytes
+ * keeping the contents, and returns the new address. `ptr` is null and `old_size` is 0
+ * at the first allocation. It returns null on failure and the memory is kept.
+ * `deallocate` frees the memory of `size` bytes at `ptr`, that is not null.
+ * `user_data` is passed to both functions.
+ */
+struct sbuffer_allocator {
+    void* (*reallocate)(void* user_data, void* ptr, size_t old_size, size_t new_size);
+    void (*deallocate)(void* user_data, void* ptr, size_t size);
+    void* user_data;
+};
+
+namespace detail {
+
+inline void* sbuffer_malloc_reallocate(void*, void* ptr, size_t, size_t new_size)
+{
+    return ::realloc(ptr, new_size);
+}
+
+inline void sbuffer_malloc_deallocate(void*, void* ptr, size_t)
+{
+    ::free(ptr);
+}
+
+inline void* sbuffer_pool_reallocate(void*, void* ptr, size_t old_size, size_t new_size)
+{
+    if(ptr && memory_pool::block_size(old_size) == memory_pool::block_size(new_size)) {
+        return ptr;
+    }
+    void* p;
+    try {
+        p = memory_pool::allocate(new_size);
+    } catch (std::bad_alloc const&) {
+        return MSGPACK_NULLPTR;
+    }
+    if(ptr) {
+        std::memcpy(p, ptr, old_size < new_size ? old_size : new_size);
+        memory_pool::deallocate(ptr, old_size);
+    }
+    return p;
+}
+
+inline void sbuffer_pool_deallocate(void*, void* ptr, size_t size)
+{
+    memory_pool::deallocate(ptr, size);
+}
+
+#if defined(MSGPACK_SBUFFER_MMAP)
+
+inline size_t sbuffer_mmap_size(size_t size)
+{
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    return (size + page - 1) / page * page;
+}
+
+inline void* sbuffer_mmap_reallocate(void*, void* ptr, size_t old_size, size_t new_size)
+{
+    void* p;
+    if(!ptr) {
+        p = ::mmap(MSGPACK_NULLPTR, sbuffer_mmap_size(new_size), PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#if defined(MADV_HUGEPAGE)
+        if(p != MAP_FAILED) {
+            // a hint only, the mapping is usable without huge pages
+            ::madvise(p, sbuffer_mmap_size(new_size), MADV_HUGEPAGE);
+        }
+#endif // defined(MADV_HUGEPAGE)
+    } else {
+        // The pages are moved by the page table, not copied.
+        p = ::mremap(ptr, sbuffer_mmap_size(old_size), sbuffer_mmap_size(new_size), MREMAP_MAYMOVE);
+    }
+    return p == MAP_FAILED ? MSGPACK_NULLPTR : p;
+}
+
+inline void sbuffer_mmap_deallocate(void*, void* ptr, size_t size)
+{
+    ::munmap(ptr, sbuffer_mmap_size(size));
+}
+
+#endif // defined(MSGPACK_SBUFFER_MMAP)
+
+} // namespace detail
+
+/// The allocator that uses `::realloc()` and `::free()`
+/**
+ * This is the default allocator of sbuffer.
+ */
+inline sbuffer_allocator const& sbuffer_malloc_allocator()
+{
+    static const sbuffer_allocator a = {
+        &detail::sbuffer_malloc_reallocate, &detail::sbuffer_malloc_deallocate, MSGPACK_NULLPTR
+    };
+    return a;
+}
+
+/// The allocator that uses memory_pool
+/**
+ * The memory is taken from and returned to the size class of memory_pool
+ * while it is enabled on the thread. The memory can be freed by `::free()`,
+ * so the buffer that release() returns can be freed in the same way as
+ * sbuffer_malloc_allocator().
+ */
+inline sbuffer_allocator const& sbuffer_pool_allocator()
+{
+    static const sbuffer_allocator a = {
+        &detail::sbuffer_pool_reallocate, &detail::sbuffer_pool_deallocate, MSGPACK_NULLPTR
+    };
+    return a;
+}
+
+#if defined(MSGPACK_SBUFFER_MMAP)
+
+/// The allocator that uses anonymous mappings
+/**
+ * The buffer is grown by `mremap()`, so the contents are not copied and
+ * the old and the new memory don't exist at the same time.
+ * Huge pages are requested by `madvise()` if they are supported.
+ * Each allocation takes at least a page, so it is for large buffers.
+ * This is only available on Linux, where `MSGPACK_SBUFFER_MMAP` is defined.
+ * It needs `_GNU_SOURCE` for `mremap()`. g++ and clang++ define it by default,
+ * but `MSGPACK_SBUFFER_MMAP` is not defined if it is undefined.
+ */
+inline sbuffer_allocator const& sbuffer_mmap_allocator()
+{
+    static const sbuffer_allocator a = {
+        &detail::sbuffer_mmap_reallocate, &detail::sbuffer_mmap_deallocate, MSGPACK_NULLPTR
+    };
+    return a;
+}
+
+#endif // defined(MSGPACK_SBUFFER_MMAP)
+
 class sbuffer {
 public:
-    sbuffer(size_t initsz = MSGPACK_SBUFFER_INIT_SIZE):m_size(0), m_alloc(initsz)
+    sbuffer(size_t initsz = MSGPACK_SBUFFER_INIT_SIZE)
+        :m_size(0), m_data(MSGPACK_NULLPTR), m_alloc(0),
+         m_grow_limit(0), m_allocator(sbuffer_malloc_allocator())
     {
-        if(initsz == 0) {
-            m_data = MSGPACK_NULLPTR;
-        } else {
-            m_data = (char*)::malloc(initsz);
-            if(!m_data) {
-                throw std::bad_alloc();
-            }
-        }
+        reallocate(initsz);
+    }
+
+    /// Constructor
+    /**
+     * @param initsz The initial capacity.
+     * @param grow_limit The maximum bytes that an expansion adds. The capacity is
+     *                   doubled until it reaches grow_limit, and then grows by grow_limit.
+     *                   0 means no limit.
+     * @param allocator The allocator of the memory.
+     */
+    sbuffer(size_t initsz, size_t grow_limit,
+            sbuffer_allocator const& allocator = sbuffer_malloc_allocator())
+        :m_size(0), m_data(MSGPACK_NULLPTR), m_alloc(0),
+         m_grow_limit(grow_limit), m_allocator(allocator)
+    {
+        reallocate(initsz);
     }
 
     ~sbuffer()
     {
-        ::free(m_data);
+        deallocate();
     }
 
 #if !defined(MSGPACK_USE_CPP03)
@@ -45,7 +201,8 @@ public:
     sbuffer& operator=(const sbuffer&) = delete;
 
     sbuffer(sbuffer&& other) :
-        m_size(other.m_size), m_data(other.m_data), m_alloc(other.m_alloc)
+        m_size(other.m_size), m_data(other.m_data), m_alloc(other.m_alloc),
+        m_grow_limit(other.m_grow_limit), m_allocator(other.m_allocator)
     {
         other.m_size = other.m_alloc = 0;
         other.m_data = MSGPACK_NULLPTR;
@@ -53,11 +210,13 @@ public:
 
     sbuffer& operator=(sbuffer&& other)
     {
-        ::free(m_data);
+        deallocate();
 
         m_size = other.m_size;
         m_alloc = other.m_alloc;
         m_data = other.m_data;
+        m_grow_limit = other.m_grow_limit;
+        m_allocator = other.m_allocator;
 
         other.m_size = other.m_alloc = 0;
         other.m_data = MSGPACK_NULLPTR;
@@ -75,6 +234,21 @@ public:
         m_size += len;
     }
 
+    // Returns the region to write at most len bytes to.
+    // commit() appends the bytes that are written there.
+    char* prepare(size_t len)
+    {
+        if(m_alloc - m_size < len) {
+            expand_buffer(len);
+        }
+        return m_data + m_size;
+    }
+
+    void commit(size_t len)
+    {
+        m_size += len;
+    }
+
     char* data()
     {
         return m_data;
@@ -90,6 +264,36 @@ public:
         return m_size;
     }
 
+    size_t capacity() const
+    {
+        return m_alloc;
+    }
+
+    /// Allocate the memory for at least n bytes
+    /**
+     * Unlike the expansion by write(), exactly n bytes are allocated
+     * if the capacity is less than n.
+     */
+    void reserve(size_t n)
+    {
+        if(m_alloc < n) {
+            reallocate(n);
+        }
+    }
+
+    /// Reduce the capacity to the size
+    void shrink_to_fit()
+    {
+        if(m_alloc != m_size) {
+            reallocate(m_size);
+        }
+    }
+
+    /// Release the ownership of the buffer
+    /**
+     * The memory is allocated by the allocator of the sbuffer. If it is the
+     * default one, the caller should free the returned buffer by `::free()`.
+     */
     char* release()
     {
         char* tmp = m_data;
@@ -105,13 +309,18 @@ public:
     }
 
 private:
+    size_t next_size(size_t n) const
+    {
+        return n + ((m_grow_limit != 0 && n > m_grow_limit) ? m_grow_limit : n);
+    }
+
     void expand_buffer(size_t len)
     {
         size_t nsize = (m_alloc > 0) ?
-                m_alloc * 2 : MSGPACK_SBUFFER_INIT_SIZE;
+                next_size(m_alloc) : MSGPACK_SBUFFER_INIT_SIZE;
 
         while(nsize < m_size + len) {
-            size_t tmp_nsize = nsize * 2;
+            size_t tmp_nsize = next_size(nsize);
             if (tmp_nsize <= nsize) {
                 nsize = m_size + len;
                 break;
@@ -119,7 +328,19 @@ private:
             nsize = tmp_nsize;
         }
 
-        void* tmp = ::realloc(m_data, nsize);
+        reallocate(nsize);
+    }
+
+    void reallocate(size_t nsize)
+    {
+        if(nsize == 0) {
+            deallocate();
+            m_data = MSGPACK_NULLPTR;
+            m_alloc = 0;
+            return;
+        }
+
+        void* tmp = m_allocator.reallocate(m_allocator.user_data, m_data, m_alloc, nsize);
         if(!tmp) {
             throw std::bad_alloc();
         }
@@ -128,6 +349,13 @@ private:
         m_alloc = nsize;
     }
 
+    void deallocate()
+    {
+        if(m_data) {
+            m_allocator.deallocate(m_allocator.user_data, m_data, m_alloc);
+        }
+    }
+
 #if defined(MSGPACK_USE_CPP03)
 private:
     sbuffer(const sbuffer&);
@@ -138,6 +366,8 @@ private:
     size_t m_size;
     char* m_data;
     size_t m_alloc;
+    size_t m_grow_limit;
+    sbuffer_allocator m_allocator;
 };
 
 /// @cond
@@ -22,8 +22,14 @@ namespace msgpack {
 MSGPACK_API_VERSION_NAMESPACE(v1) {
 /// @endcond
 
+struct sbuffer_allocator;
+
 class sbuffer;
 
+sbuffer_allocator const& sbuffer_malloc_allocator();
+
+sbuffer_allocator const& sbuffer_pool_allocator();
+
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v1)
 /// @endcond
@@ -312,7 +312,6 @@ public:
     context(unpack_reference_func f, void* user_data, unpack_limit const& limit)
         :m_trail(0), m_user(f, user_data, limit), m_cs(MSGPACK_CS_HEADER)
     {
-        m_stack.reserve(MSGPACK_EMBED_STACK_SIZE);
         m_stack.push_back(unpack_stack());
     }
 
@@ -448,7 +447,7 @@ private:
     std::size_t m_trail;
     unpack_user m_user;
     uint32_t m_cs;
-    std::vector<unpack_stack> m_stack;
+    embed_stack<unpack_stack> m_stack;
 };
 
 template <>
@@ -17,6 +17,7 @@
 #include "msgpack/cpp_config.hpp"
 #include "msgpack/sysdep.h"
 #include "msgpack/parse_return.hpp"
+#include "msgpack/v1/detail/embed_stack.hpp"
 
 #include <memory>
 #include <stdexcept>
@@ -11,9 +11,11 @@
 #define MSGPACK_V1_VREFBUFFER_HPP
 
 #include "msgpack/v1/vrefbuffer_decl.hpp"
+#include "msgpack/memory_pool.hpp"
 
 #include <stdexcept>
 #include <algorithm>
+#include <climits>
 
 #if defined(_MSC_VER)
 // avoiding confliction std::max, std::min, and macro in windows.h
@@ -24,6 +26,9 @@
 
 #if defined(unix) || defined(__unix) || defined(__APPLE__) || defined(__OpenBSD__)
 #include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#define MSGPACK_VREFBUFFER_WRITEV
 #else
 struct iovec {
     void  *iov_base;
@@ -40,12 +45,23 @@ MSGPACK_API_VERSION_NAMESPACE(v1) {
 namespace detail {
     // int64, uint64, double
     std::size_t const packer_max_buffer_size = 9;
+
+    // The maximum iovcnt of a writev() call.
+#if defined(IOV_MAX)
+    std::size_t const vrefbuffer_iov_max = IOV_MAX;
+#else
+    std::size_t const vrefbuffer_iov_max = 1024;
+#endif
 } // detail
 
 class vrefbuffer {
 private:
     struct chunk {
         chunk* next;
+        // The size of the block from memory_pool, 0 if it is from ::malloc().
+        size_t size;
+        // One past the index of the last iovec that refers to the chunk.
+        size_t vec_end;
     };
     struct inner_buffer {
         size_t free;
@@ -56,7 +72,8 @@ public:
     vrefbuffer(size_t ref_size = MSGPACK_VREFBUFFER_REF_SIZE,
                size_t chunk_size = MSGPACK_VREFBUFFER_CHUNK_SIZE)
         :m_ref_size(std::max(ref_size, detail::packer_max_buffer_size + 1)),
-         m_chunk_size(chunk_size)
+         m_chunk_size(chunk_size),
+         m_sent(0)
     {
         if((sizeof(chunk) + chunk_size) < chunk_size) {
             throw std::bad_alloc();
@@ -75,14 +92,17 @@ public:
         m_end   = array + nfirst;
         m_array = array;
 
-        chunk* c = static_cast<chunk*>(::malloc(sizeof(chunk) + chunk_size));
-        if(!c) {
+        size_t sz = chunk_size;
+        chunk* c;
+        try {
+            c = allocate_chunk(sz);
+        } catch (...) {
             ::free(array);
-            throw std::bad_alloc();
+            throw;
         }
         inner_buffer* const ib = &m_inner_buffer;
 
-        ib->free = chunk_size;
+        ib->free = sz;
         ib->ptr      = reinterpret_cast<char*>(c) + sizeof(chunk);
         ib->head = c;
         c->next = MSGPACK_NULLPTR;
@@ -94,7 +114,7 @@ public:
         chunk* c = m_inner_buffer.head;
         while(true) {
             chunk* n = c->next;
-            ::free(c);
+            free_chunk(c);
             if(n != NULL) {
                 c = n;
             } else {
@@ -137,6 +157,14 @@ public:
     }
 
     void append_copy(const char* buf, size_t len)
+    {
+        std::memcpy(prepare(len), buf, len);
+        commit(len);
+    }
+
+    // Returns the region to write at most len bytes to.
+    // commit() appends the bytes that are written there as a copied data.
+    char* prepare(size_t len)
     {
         inner_buffer* const ib = &m_inner_buffer;
 
@@ -150,10 +178,7 @@ public:
                 throw std::bad_alloc();
             }
 
-            chunk* c = static_cast<chunk*>(::malloc(sizeof(chunk) + sz));
-            if(!c) {
-                throw std::bad_alloc();
-            }
+            chunk* c = allocate_chunk(sz);
 
             c->next = ib->head;
             ib->head = c;
@@ -161,31 +186,107 @@ public:
             ib->ptr      = reinterpret_cast<char*>(c) + sizeof(chunk);
         }
 
+        return ib->ptr;
+    }
+
+    void commit(size_t len)
+    {
+        inner_buffer* const ib = &m_inner_buffer;
+
         char* m = ib->ptr;
-        std::memcpy(m, buf, len);
         ib->free -= len;
         ib->ptr      += len;
 
-        if(m_tail != m_array && m ==
+        // The iovecs that are already sent can't be extended.
+        if(m_tail != m_array + m_sent && m ==
             static_cast<const char*>(
                 const_cast<const void *>((m_tail - 1)->iov_base)
             ) + (m_tail - 1)->iov_len) {
             (m_tail - 1)->iov_len += len;
-            return;
         } else {
             append_ref( m, len);
         }
+        ib->head->vec_end = static_cast<size_t>(m_tail - m_array);
     }
 
+    // Returns the iovecs that are not sent yet.
+    // Pass at most detail::vrefbuffer_iov_max of them to writev().
     const struct iovec* vector() const
     {
-        return m_array;
+        return m_array + m_sent;
     }
 
     size_t vector_size() const
     {
-        return static_cast<size_t>(m_tail - m_array);
+        return static_cast<size_t>(m_tail - m_array) - m_sent;
+    }
+
+    // Marks the first len bytes of vector() as sent.
+    // The chunks that are no longer referred to are released, and the
+    // buffer is cleared when everything is sent.
+    // len must not exceed the total length of vector().
+    void consume(size_t len)
+    {
+        iovec* vec = m_array + m_sent;
+        while(len != 0 && vec != m_tail) {
+            if(len < vec->iov_len) {
+                vec->iov_base = static_cast<char*>(vec->iov_base) + len;
+                vec->iov_len -= len;
+                break;
+            }
+            len -= vec->iov_len;
+            ++vec;
+        }
+
+        const size_t sent = static_cast<size_t>(vec - m_array);
+        if(sent == m_sent) {
+            return;
+        }
+        if(vec == m_tail) {
+            clear();
+            return;
+        }
+        m_sent = sent;
+
+        // The current chunk is kept for the following writes.
+        chunk** p = &m_inner_buffer.head->next;
+        while(*p) {
+            chunk* c = *p;
+            if(c->vec_end <= m_sent) {
+                *p = c->next;
+                free_chunk(c);
+            } else {
+                p = &c->next;
+            }
+        }
+    }
+
+#if defined(MSGPACK_VREFBUFFER_WRITEV)
+    // Writes vector() to fd by writev() until everything is sent or
+    // fd would block, and returns the number of bytes written.
+    // The written bytes are consumed. It throws std::runtime_error
+    // if writev() fails.
+    size_t write_to_fd(int fd)
+    {
+        size_t total = 0;
+        while(vector_size() != 0) {
+            const size_t cnt = std::min(vector_size(), detail::vrefbuffer_iov_max);
+            const ssize_t len = ::writev(fd, vector(), static_cast<int>(cnt));
+            if(len < 0) {
+                if(errno == EINTR) {
+                    continue;
+                }
+                if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                    break;
+                }
+                throw std::runtime_error("writev() failed");
+            }
+            consume(static_cast<size_t>(len));
+            total += static_cast<size_t>(len);
+        }
+        return total;
     }
+#endif // defined(MSGPACK_VREFBUFFER_WRITEV)
 
     void migrate(vrefbuffer* to)
     {
@@ -195,14 +296,12 @@ public:
             throw std::bad_alloc();
         }
 
-        chunk* empty = static_cast<chunk*>(::malloc(sizeof(chunk) + sz));
-        if(!empty) {
-            throw std::bad_alloc();
-        }
+        chunk* empty = allocate_chunk(sz);
 
         empty->next = MSGPACK_NULLPTR;
+        empty->vec_end = 0;
 
-        const size_t nused = static_cast<size_t>(m_tail - m_array);
+        const size_t nused = vector_size();
         if(to->m_tail + nused < m_end) {
             const size_t tosize = static_cast<size_t>(to->m_tail - to->m_array);
             const size_t reqsize = nused + tosize;
@@ -219,7 +318,7 @@ public:
             iovec* nvec = static_cast<iovec*>(::realloc(
                 to->m_array, sizeof(iovec)*nnext));
             if(!nvec) {
-                ::free(empty);
+                free_chunk(empty);
                 throw std::bad_alloc();
             }
 
@@ -228,7 +327,8 @@ public:
             to->m_tail  = nvec + tosize;
         }
 
-        std::memcpy(to->m_tail, m_array, sizeof(iovec)*nused);
+        const size_t tosize = static_cast<size_t>(to->m_tail - to->m_array);
+        std::memcpy(to->m_tail, vector(), sizeof(iovec)*nused);
 
         to->m_tail += nused;
         m_tail = m_array;
@@ -238,15 +338,25 @@ public:
         inner_buffer* const toib = &to->m_inner_buffer;
 
         chunk* last = ib->head;
-        while(last->next) {
+        while(true) {
+            last->vec_end = last->vec_end > m_sent ?
+                last->vec_end - m_sent + tosize : 0;
+            if(!last->next) {
+                break;
+            }
             last = last->next;
         }
-        last->next = toib->head;
-        toib->head = ib->head;
+        m_sent = 0;
 
+        // The chunk that has the free space is kept at the head.
         if(toib->free < ib->free) {
+            last->next = toib->head;
+            toib->head = ib->head;
             toib->free = ib->free;
             toib->ptr  = ib->ptr;
+        } else {
+            last->next = toib->head->next;
+            toib->head->next = ib->head;
         }
 
         ib->head = empty;
@@ -261,17 +371,19 @@ public:
         chunk* n;
         while(c) {
             n = c->next;
-            ::free(c);
+            free_chunk(c);
             c = n;
         }
 
         inner_buffer* const ib = &m_inner_buffer;
         c = ib->head;
         c->next = MSGPACK_NULLPTR;
+        c->vec_end = 0;
         ib->free = m_chunk_size;
         ib->ptr      = reinterpret_cast<char*>(c) + sizeof(chunk);
 
         m_tail = m_array;
+        m_sent = 0;
     }
 
 #if defined(MSGPACK_USE_CPP03)
@@ -283,6 +395,37 @@ private:
     vrefbuffer& operator=(const vrefbuffer&) = delete;
 #endif // defined(MSGPACK_USE_CPP03)
 
+private:
+    // While memory_pool is enabled, the chunk takes the whole block
+    // and size is updated to the usable size.
+    static chunk* allocate_chunk(size_t& size)
+    {
+        chunk* c;
+        if(memory_pool::enabled()) {
+            size_t bs = memory_pool::block_size(sizeof(chunk) + size);
+            c = static_cast<chunk*>(memory_pool::allocate(bs));
+            c->size = bs;
+            size = bs - sizeof(chunk);
+        } else {
+            c = static_cast<chunk*>(::malloc(sizeof(chunk) + size));
+            if(!c) {
+                throw std::bad_alloc();
+            }
+            c->size = 0;
+        }
+        c->vec_end = 0;
+        return c;
+    }
+
+    static void free_chunk(chunk* c)
+    {
+        if(c->size) {
+            memory_pool::deallocate(c, c->size);
+        } else {
+            ::free(c);
+        }
+    }
+
 private:
     iovec* m_tail;
     iovec* m_end;
@@ -290,6 +433,8 @@ private:
 
     size_t m_ref_size;
     size_t m_chunk_size;
+    // The number of iovecs from m_array that are sent.
+    size_t m_sent;
 
     inner_buffer m_inner_buffer;
 
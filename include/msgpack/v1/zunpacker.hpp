@@ -0,0 +1,234 @@
+//
+// MessagePack for C++ inflating unpacker implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_ZUNPACKER_HPP
+#define MSGPACK_V1_ZUNPACKER_HPP
+
+#include "msgpack/v1/zunpacker_decl.hpp"
+#include "msgpack/object_decl.hpp"
+#include "msgpack/unpack_exception.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <zlib.h>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+/// Inflates deflate compressed data into the buffer of an unpacker.
+/**
+ * The compressed data is inflated on demand, straight into the region
+ * that unpacker::buffer() returns. The output is reserved in steps that
+ * are estimated from the compression ratio observed so far, and that are
+ * limited to MSGPACK_ZUNPACKER_MAX_RESERVE_SIZE. So the unpacker buffer
+ * doesn't grow much more than the largest object even if a small input
+ * expands hugely.
+ *
+ * Usage:
+ *
+ *     msgpack::unpacker unp;
+ *     msgpack::zunpacker zunp;
+ *     zunp.feed(compressed, len);
+ *     msgpack::object_handle oh;
+ *     while(zunp.next(unp, oh)) {
+ *         // use oh
+ *     }
+ *     // feed the next compressed data
+ */
+class zunpacker {
+public:
+    /**
+     * @param window_bits The windowBits parameter of zlib's inflateInit2().
+     *                    The default MAX_WBITS is for zlib wrapped streams
+     *                    that msgpack::zbuffer creates, -MAX_WBITS is for
+     *                    raw deflate streams, and MAX_WBITS + 32 detects
+     *                    zlib and gzip streams automatically.
+     */
+    zunpacker(int window_bits = MAX_WBITS)
+        : m_remaining(0), m_total_in(0), m_total_out(0), m_pending(false)
+    {
+        m_stream.zalloc = Z_NULL;
+        m_stream.zfree = Z_NULL;
+        m_stream.opaque = Z_NULL;
+        m_stream.next_in = Z_NULL;
+        m_stream.avail_in = 0;
+        if(inflateInit2(&m_stream, window_bits) != Z_OK) {
+            throw std::bad_alloc();
+        }
+    }
+
+    ~zunpacker()
+    {
+        inflateEnd(&m_stream);
+    }
+
+public:
+    /// Sets the compressed data.
+    /**
+     * The data is not copied. It must be kept until next() or inflate()
+     * returns false, and it replaces the data that is not inflated yet.
+     * A stream that follows the end of the previous stream is inflated
+     * as a new stream. The data can be larger than zlib's uInt, it is
+     * passed to zlib in slices.
+     */
+    void feed(const char* buf, size_t len)
+    {
+        m_stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(buf));
+        m_stream.avail_in = 0;
+        m_remaining = len;
+        refill();
+    }
+
+    /// Inflates a step of the fed data into the buffer of unp.
+    /**
+     * @return false if no progress can be made until the next feed().
+     *
+     * If the data is not a valid stream, msgpack::parse_error is thrown.
+     */
+    template <typename Unpacker>
+    bool inflate(Unpacker& unp)
+    {
+        refill();
+        if(m_stream.avail_in == 0 && !m_pending) {
+            return false;
+        }
+
+        const size_t size = reserve_size();
+        unp.reserve_buffer(size);
+        const uInt avail_in = m_stream.avail_in;
+        m_stream.next_out = reinterpret_cast<Bytef*>(unp.buffer());
+        m_stream.avail_out = static_cast<uInt>(size);
+
+        const int ret = ::inflate(&m_stream, Z_NO_FLUSH);
+
+        const size_t in = avail_in - m_stream.avail_in;
+        const size_t out = size - m_stream.avail_out;
+        unp.buffer_consumed(out);
+        m_total_in += in;
+        m_total_out += out;
+        m_stream.next_out = Z_NULL;
+        m_stream.avail_out = 0;
+
+        switch(ret) {
+        case Z_OK:
+            // zlib could have more output for the consumed input
+            m_pending = out == size;
+            break;
+        case Z_STREAM_END:
+            m_pending = false;
+            if(inflateReset(&m_stream) != Z_OK) {
+                throw std::bad_alloc();
+            }
+            break;
+        case Z_BUF_ERROR:
+            m_pending = false;
+            break;
+        case Z_MEM_ERROR:
+            throw std::bad_alloc();
+        default:
+            throw msgpack::parse_error("inflate() failed");
+        }
+        return in != 0 || out != 0;
+    }
+
+    /// Unpacks the next object, inflating the fed data as required.
+    /**
+     * @return true if an object is unpacked to oh, false if more data
+     *         has to be fed.
+     *
+     * The exceptions are the same as Unpacker::next() and inflate().
+     */
+    template <typename Unpacker>
+    bool next(Unpacker& unp, msgpack::object_handle& oh)
+    {
+        while(!unp.next(oh)) {
+            if(!inflate(unp)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// Discards the data that is not inflated yet and starts a new stream.
+    void reset()
+    {
+        if(inflateReset(&m_stream) != Z_OK) {
+            throw std::bad_alloc();
+        }
+        m_stream.next_in = Z_NULL;
+        m_stream.avail_in = 0;
+        m_remaining = 0;
+        m_pending = false;
+    }
+
+    /// The total bytes of the compressed data that are inflated.
+    size_t total_in() const
+    {
+        return m_total_in;
+    }
+
+    /// The total bytes that are inflated into the unpacker.
+    size_t total_out() const
+    {
+        return m_total_out;
+    }
+
+private:
+    // Passes the next slice of the fed data to zlib. next_in is already
+    // advanced to the slice by zlib.
+    void refill()
+    {
+        if(m_stream.avail_in != 0 || m_remaining == 0) {
+            return;
+        }
+        const size_t max = std::numeric_limits<uInt>::max();
+        const size_t len = m_remaining < max ? m_remaining : max;
+        m_stream.avail_in = static_cast<uInt>(len);
+        m_remaining -= len;
+    }
+
+    size_t reserve_size() const
+    {
+        // assume the ratio of zlib's default level until it is observed
+        const size_t ratio = m_total_in == 0 ? 4 : m_total_out / m_total_in + 1;
+        const size_t max = MSGPACK_ZUNPACKER_MAX_RESERVE_SIZE;
+        if(m_stream.avail_in == 0 || m_stream.avail_in >= max / ratio) {
+            return max;
+        }
+        const size_t size = m_stream.avail_in * ratio;
+        return size < MSGPACK_ZUNPACKER_MIN_RESERVE_SIZE ?
+            MSGPACK_ZUNPACKER_MIN_RESERVE_SIZE : size;
+    }
+
+#if defined(MSGPACK_USE_CPP03)
+private:
+    zunpacker(const zunpacker&);
+    zunpacker& operator=(const zunpacker&);
+#else  // defined(MSGPACK_USE_CPP03)
+    zunpacker(const zunpacker&) = delete;
+    zunpacker& operator=(const zunpacker&) = delete;
+#endif // defined(MSGPACK_USE_CPP03)
+
+private:
+    z_stream m_stream;
+    // the bytes of the fed data that follow avail_in
+    size_t m_remaining;
+    size_t m_total_in;
+    size_t m_total_out;
+    bool m_pending;
+};
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V1_ZUNPACKER_HPP
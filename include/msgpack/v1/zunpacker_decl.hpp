@@ -0,0 +1,35 @@
+//
+// MessagePack for C++ inflating unpacker implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V1_ZUNPACKER_DECL_HPP
+#define MSGPACK_V1_ZUNPACKER_DECL_HPP
+
+#include "msgpack/versioning.hpp"
+
+#ifndef MSGPACK_ZUNPACKER_MIN_RESERVE_SIZE
+#define MSGPACK_ZUNPACKER_MIN_RESERVE_SIZE 512
+#endif
+
+#ifndef MSGPACK_ZUNPACKER_MAX_RESERVE_SIZE
+#define MSGPACK_ZUNPACKER_MAX_RESERVE_SIZE (64*1024)
+#endif
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v1) {
+/// @endcond
+
+class zunpacker;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v1)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V1_ZUNPACKER_DECL_HPP
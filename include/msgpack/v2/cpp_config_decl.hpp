@@ -39,6 +39,7 @@ using v1::remove_volatile;
 using v1::remove_cv;
 
 using v1::is_pointer;
+using v1::is_trivially_destructible;
 
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v2)
@@ -72,6 +73,7 @@ using v1::remove_volatile;
 using v1::remove_cv;
 
 using v1::is_pointer;
+using v1::is_trivially_destructible;
 
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v2)
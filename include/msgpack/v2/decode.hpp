@@ -0,0 +1,492 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_DECODE_HPP
+#define MSGPACK_V2_DECODE_HPP
+
+#if MSGPACK_DEFAULT_API_VERSION >= 2
+
+#include "msgpack/v2/decode_decl.hpp"
+#include "msgpack/object.hpp"
+#include "msgpack/parse.hpp"
+#include "msgpack/unpack.hpp"
+#include "msgpack/adaptor/define.hpp"
+
+#if !defined(MSGPACK_USE_CPP03)
+
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+namespace detail {
+
+struct msgpack_decode_check {
+    template <typename T>
+    static auto check(T* v) -> decltype(v->msgpack_decode(std::declval<decoder&>()), std::true_type());
+    template <typename T>
+    static std::false_type check(...);
+};
+
+// Types defined by MSGPACK_DEFINE* have msgpack_decode().
+template <typename T>
+struct has_msgpack_decode
+    : decltype(msgpack_decode_check::check<T>(MSGPACK_NULLPTR)) {};
+
+inline bool decode_key_equal(const char* key, const char* p, uint32_t size) {
+    return std::strlen(key) == size && std::memcmp(key, p, size) == 0;
+}
+
+inline bool decode_key_equal(std::string const& key, const char* p, uint32_t size) {
+    return key.size() == size && std::memcmp(key.data(), p, size) == 0;
+}
+
+// Reads msgpack formatted data from the buffer and writes it to values.
+// Containers are decoded by decode_imp, so no object tree is created.
+class decoder {
+public:
+    decoder(const char* data, std::size_t len, std::size_t off, unpack_limit const& limit)
+        :m_start(data), m_p(data + off), m_pe(data + len), m_limit(limit), m_depth(0) {}
+
+    std::size_t offset() const {
+        return static_cast<std::size_t>(m_p - m_start);
+    }
+
+    template <typename T>
+    void decode(T& v) {
+        decode_imp<T>::decode(*this, v);
+    }
+
+    // If the next object is an array, reads its header and returns true.
+    bool start_array(uint32_t& size) {
+        if (m_p == m_pe) throw msgpack::insufficient_bytes("insufficient bytes");
+        unsigned char h = static_cast<unsigned char>(*m_p);
+        if ((h & 0xf0) == 0x90) {
+            size = h & 0x0f;
+            ++m_p;
+        }
+        else if (h == 0xdc || h == 0xdd) {
+            std::size_t trail = h == 0xdc ? 2 : 4;
+            need(1 + trail);
+            size = load_size(trail, m_p + 1);
+            m_p += 1 + trail;
+        }
+        else {
+            return false;
+        }
+        if (size > m_limit.array()) throw msgpack::array_size_overflow("array size overflow");
+        start_container(size);
+        return true;
+    }
+
+    // If the next object is a map, reads its header and returns true.
+    bool start_map(uint32_t& size) {
+        if (m_p == m_pe) throw msgpack::insufficient_bytes("insufficient bytes");
+        unsigned char h = static_cast<unsigned char>(*m_p);
+        if ((h & 0xf0) == 0x80) {
+            size = h & 0x0f;
+            ++m_p;
+        }
+        else if (h == 0xde || h == 0xdf) {
+            std::size_t trail = h == 0xde ? 2 : 4;
+            need(1 + trail);
+            size = load_size(trail, m_p + 1);
+            m_p += 1 + trail;
+        }
+        else {
+            return false;
+        }
+        if (size > m_limit.map()) throw msgpack::map_size_overflow("map size overflow");
+        start_container(static_cast<uint64_t>(size) * 2);
+        return true;
+    }
+
+    void end_container() {
+        --m_depth;
+    }
+
+    void skip() {
+        std::size_t off = offset();
+        switch (skip_imp(m_start, static_cast<std::size_t>(m_pe - m_start), off)) {
+        case PARSE_CONTINUE:
+            throw msgpack::insufficient_bytes("insufficient bytes");
+        case PARSE_PARSE_ERROR:
+            throw msgpack::parse_error("parse error");
+        default:
+            m_p = m_start + off;
+            break;
+        }
+    }
+
+    // Reads a non container object. str, bin and ext refer to the buffer.
+    // If the next object is a container, nothing is read and false is returned.
+    bool read_scalar(msgpack::object& obj) {
+        if (m_p == m_pe) throw msgpack::insufficient_bytes("insufficient bytes");
+        header_info const& hi = header_table()[*reinterpret_cast<const unsigned char*>(m_p)];
+        switch (hi.kind) {
+        case header_info::positive_fixint:
+            obj.type = msgpack::type::POSITIVE_INTEGER;
+            obj.via.u64 = *reinterpret_cast<const uint8_t*>(m_p);
+            ++m_p;
+            return true;
+        case header_info::negative_fixint:
+            obj.type = msgpack::type::NEGATIVE_INTEGER;
+            obj.via.i64 = *reinterpret_cast<const int8_t*>(m_p);
+            ++m_p;
+            return true;
+        case header_info::fixstr:
+            set_trail(obj, msgpack::type::STR, m_p + 1, static_cast<uint32_t>(*m_p) & 0x1f);
+            return true;
+        case header_info::fixarray:
+        case header_info::fixmap:
+            return false;
+        case header_info::nil:
+            obj.type = msgpack::type::NIL;
+            ++m_p;
+            return true;
+        case header_info::boolean_false:
+        case header_info::boolean_true:
+            obj.type = msgpack::type::BOOLEAN;
+            obj.via.boolean = hi.kind == header_info::boolean_true;
+            ++m_p;
+            return true;
+        case header_info::never_used:
+            throw msgpack::parse_error("parse error");
+        default:
+            break;
+        }
+        need(1 + static_cast<std::size_t>(hi.trail));
+        const char* n = m_p + 1;
+        switch (hi.kind) {
+        case MSGPACK_CS_FLOAT: {
+            union { uint32_t i; float f; } mem;
+            load<uint32_t>(mem.i, n);
+            obj.type = msgpack::type::FLOAT32;
+            obj.via.f64 = mem.f;
+        } break;
+        case MSGPACK_CS_DOUBLE: {
+            union { uint64_t i; double f; } mem;
+            load<uint64_t>(mem.i, n);
+#if defined(TARGET_OS_IPHONE)
+            // ok
+#elif defined(__arm__) && !(__ARM_EABI__) // arm-oabi
+            // https://github.com/msgpack/msgpack-perl/pull/1
+            mem.i = (mem.i & 0xFFFFFFFFUL) << 32UL | (mem.i >> 32UL);
+#endif
+            obj.type = msgpack::type::FLOAT64;
+            obj.via.f64 = mem.f;
+        } break;
+        case MSGPACK_CS_UINT_8:
+        case MSGPACK_CS_UINT_16:
+        case MSGPACK_CS_UINT_32:
+        case MSGPACK_CS_UINT_64: {
+            obj.type = msgpack::type::POSITIVE_INTEGER;
+            switch (hi.trail) {
+            case 1: { uint8_t tmp; load<uint8_t>(tmp, n); obj.via.u64 = tmp; } break;
+            case 2: { uint16_t tmp; load<uint16_t>(tmp, n); obj.via.u64 = tmp; } break;
+            case 4: { uint32_t tmp; load<uint32_t>(tmp, n); obj.via.u64 = tmp; } break;
+            default: load<uint64_t>(obj.via.u64, n); break;
+            }
+        } break;
+        case MSGPACK_CS_INT_8:
+        case MSGPACK_CS_INT_16:
+        case MSGPACK_CS_INT_32:
+        case MSGPACK_CS_INT_64: {
+            int64_t v;
+            switch (hi.trail) {
+            case 1: { int8_t tmp; load<int8_t>(tmp, n); v = tmp; } break;
+            case 2: { int16_t tmp; load<int16_t>(tmp, n); v = tmp; } break;
+            case 4: { int32_t tmp; load<int32_t>(tmp, n); v = tmp; } break;
+            default: load<int64_t>(v, n); break;
+            }
+            if (v >= 0) {
+                obj.type = msgpack::type::POSITIVE_INTEGER;
+                obj.via.u64 = static_cast<uint64_t>(v);
+            }
+            else {
+                obj.type = msgpack::type::NEGATIVE_INTEGER;
+                obj.via.i64 = v;
+            }
+        } break;
+        case MSGPACK_CS_FIXEXT_1:
+        case MSGPACK_CS_FIXEXT_2:
+        case MSGPACK_CS_FIXEXT_4:
+        case MSGPACK_CS_FIXEXT_8:
+        case MSGPACK_CS_FIXEXT_16:
+            obj.type = msgpack::type::EXT;
+            obj.via.ext.ptr = n;
+            obj.via.ext.size = static_cast<uint32_t>(hi.trail - 1);
+            break;
+        case MSGPACK_CS_STR_8:
+        case MSGPACK_CS_STR_16:
+        case MSGPACK_CS_STR_32:
+            set_trail(obj, msgpack::type::STR, n + hi.trail, load_size(hi.trail, n));
+            return true;
+        case MSGPACK_CS_BIN_8:
+        case MSGPACK_CS_BIN_16:
+        case MSGPACK_CS_BIN_32:
+            set_trail(obj, msgpack::type::BIN, n + hi.trail, load_size(hi.trail, n));
+            return true;
+        case MSGPACK_CS_EXT_8:
+        case MSGPACK_CS_EXT_16:
+        case MSGPACK_CS_EXT_32:
+            set_trail(obj, msgpack::type::EXT, n + hi.trail, load_size(hi.trail, n));
+            return true;
+        case MSGPACK_CS_ARRAY_16:
+        case MSGPACK_CS_ARRAY_32:
+        case MSGPACK_CS_MAP_16:
+        case MSGPACK_CS_MAP_32:
+            return false;
+        default:
+            throw msgpack::parse_error("parse error");
+        }
+        m_p = n + hi.trail;
+        return true;
+    }
+
+    // Converts the next object by the convert adaptor of T.
+    template <typename T>
+    void decode_object(T& v) {
+        static_assert(!std::is_same<T, msgpack::object>::value,
+                      "msgpack::object can't refer to the temporary zone. Use msgpack::unpack().");
+        msgpack::object obj;
+        if (!read_scalar(obj)) {
+            if (!m_zone) m_zone.reset(new msgpack::zone);
+            std::size_t off = offset();
+            // the containers that enclose the object count for the depth
+            unpack_limit limit(
+                m_limit.array(), m_limit.map(), m_limit.str(),
+                m_limit.bin(), m_limit.ext(), m_limit.depth() - m_depth);
+            obj = msgpack::v2::unpack(
+                *m_zone, m_start, static_cast<std::size_t>(m_pe - m_start), off,
+                &decoder::reference_func, MSGPACK_NULLPTR, limit);
+            m_p = m_start + off;
+        }
+        obj.convert(v);
+    }
+
+    template <typename... Args>
+    void decode_define(msgpack::type::define_array<Args...> const& d) {
+        uint32_t size;
+        if (!start_array(size)) throw msgpack::type_error();
+        define_array_elements<std::tuple<Args&...>, 0, sizeof...(Args)>::decode(*this, d.a, size);
+        for (uint32_t i = sizeof...(Args); i < size; ++i) skip();
+        end_container();
+    }
+
+    void decode_define(msgpack::type::define_array<> const&) {
+        uint32_t size;
+        if (!start_array(size)) throw msgpack::type_error();
+        for (uint32_t i = 0; i < size; ++i) skip();
+        end_container();
+    }
+
+    template <typename... Args>
+    void decode_define(msgpack::type::define_map<Args...> const& d) {
+        uint32_t size;
+        if (!start_map(size)) throw msgpack::type_error();
+        for (uint32_t i = 0; i < size; ++i) {
+            msgpack::object key;
+            if (!read_scalar(key) || key.type != msgpack::type::STR) throw msgpack::type_error();
+            if (!define_map_values<std::tuple<Args&...>, 0, sizeof...(Args)>::decode(
+                    *this, d.a, key.via.str.ptr, key.via.str.size)) {
+                skip();
+            }
+        }
+        end_container();
+    }
+
+private:
+    template <typename Tuple, std::size_t I, std::size_t N>
+    struct define_array_elements {
+        static void decode(decoder& d, Tuple const& t, uint32_t size) {
+            if (size <= I) return;
+            d.decode(std::get<I>(t));
+            define_array_elements<Tuple, I + 1, N>::decode(d, t, size);
+        }
+    };
+
+    template <typename Tuple, std::size_t N>
+    struct define_array_elements<Tuple, N, N> {
+        static void decode(decoder&, Tuple const&, uint32_t) {}
+    };
+
+    template <typename Tuple, std::size_t I, std::size_t N>
+    struct define_map_values {
+        static bool decode(decoder& d, Tuple const& t, const char* key, uint32_t size) {
+            if (decode_key_equal(std::get<I>(t), key, size)) {
+                d.decode(std::get<I + 1>(t));
+                return true;
+            }
+            return define_map_values<Tuple, I + 2, N>::decode(d, t, key, size);
+        }
+    };
+
+    template <typename Tuple, std::size_t N>
+    struct define_map_values<Tuple, N, N> {
+        static bool decode(decoder&, Tuple const&, const char*, uint32_t) { return false; }
+    };
+
+    static bool reference_func(msgpack::type::object_type /*type*/, std::size_t /*len*/, void*) {
+        return true;
+    }
+
+    void need(std::size_t size) {
+        if (static_cast<std::size_t>(m_pe - m_p) < size) throw msgpack::insufficient_bytes("insufficient bytes");
+    }
+
+    void set_trail(msgpack::object& obj, msgpack::type::object_type type, const char* p, uint32_t size) {
+        switch (type) {
+        case msgpack::type::STR:
+            if (size > m_limit.str()) throw msgpack::str_size_overflow("str size overflow");
+            obj.via.str.ptr = p;
+            obj.via.str.size = size;
+            break;
+        case msgpack::type::BIN:
+            if (size > m_limit.bin()) throw msgpack::bin_size_overflow("bin size overflow");
+            obj.via.bin.ptr = p;
+            obj.via.bin.size = size;
+            break;
+        default:
+            // includes the type byte
+            if (static_cast<uint64_t>(size) + 1 > m_limit.ext()) throw msgpack::ext_size_overflow("ext size overflow");
+            obj.via.ext.ptr = p;
+            obj.via.ext.size = size;
+            ++size;
+            break;
+        }
+        if (static_cast<std::size_t>(m_pe - p) < size) throw msgpack::insufficient_bytes("insufficient bytes");
+        obj.type = type;
+        m_p = p + size;
+    }
+
+    // Each element needs at least 1 byte, so a broken size is detected
+    // before memory is allocated for the elements.
+    void start_container(uint64_t num_objects) {
+        if (static_cast<uint64_t>(m_pe - m_p) < num_objects) throw msgpack::insufficient_bytes("insufficient bytes");
+        if (++m_depth > m_limit.depth()) throw msgpack::depth_size_overflow("depth size overflow");
+    }
+
+    const char* m_start;
+    const char* m_p;
+    const char* m_pe;
+    unpack_limit m_limit;
+    std::size_t m_depth;
+    std::unique_ptr<msgpack::zone> m_zone;
+};
+
+template <typename T, typename Enabler>
+struct decode_imp {
+    static void decode(decoder& d, T& v) {
+        d.decode_object(v);
+    }
+};
+
+template <typename T>
+struct decode_imp<T, typename std::enable_if<has_msgpack_decode<T>::value>::type> {
+    static void decode(decoder& d, T& v) {
+        v.msgpack_decode(d);
+    }
+};
+
+// std::vector<char>, std::vector<unsigned char> and std::vector<bool> have
+// their own convert adaptors.
+template <typename T, typename Alloc>
+struct decode_imp<
+    std::vector<T, Alloc>,
+    typename std::enable_if<
+        !std::is_same<T, char>::value &&
+        !std::is_same<T, unsigned char>::value &&
+        !std::is_same<T, bool>::value
+    >::type> {
+    static void decode(decoder& d, std::vector<T, Alloc>& v) {
+        uint32_t size;
+        if (!d.start_array(size)) {
+            d.decode_object(v);
+            return;
+        }
+        v.resize(size);
+        for (uint32_t i = 0; i != size; ++i) {
+            d.decode(v[i]);
+        }
+        d.end_container();
+    }
+};
+
+template <typename Map>
+struct decode_map_imp {
+    static void decode(decoder& d, Map& v) {
+        uint32_t size;
+        if (!d.start_map(size)) {
+            d.decode_object(v);
+            return;
+        }
+        Map tmp;
+        for (uint32_t i = 0; i != size; ++i) {
+            typename Map::key_type key;
+            d.decode(key);
+            d.decode(tmp[std::move(key)]);
+        }
+        v = std::move(tmp);
+        d.end_container();
+    }
+};
+
+template <typename K, typename V, typename Compare, typename Alloc>
+struct decode_imp<std::map<K, V, Compare, Alloc> >
+    : decode_map_imp<std::map<K, V, Compare, Alloc> > {
+};
+
+template <typename K, typename V, typename Hash, typename Compare, typename Alloc>
+struct decode_imp<std::unordered_map<K, V, Hash, Compare, Alloc> >
+    : decode_map_imp<std::unordered_map<K, V, Hash, Compare, Alloc> > {
+};
+
+} // namespace detail
+
+template <typename T>
+inline void decode(
+    const char* data, std::size_t len, std::size_t& off, T& v,
+    unpack_limit const& limit)
+{
+    if (len <= off) throw msgpack::insufficient_bytes("insufficient bytes");
+    detail::decoder d(data, len, off, limit);
+    d.decode(v);
+    off = d.offset();
+}
+
+template <typename T>
+inline void decode(
+    const char* data, std::size_t len, T& v,
+    unpack_limit const& limit)
+{
+    std::size_t off = 0;
+    msgpack::v2::decode(data, len, off, v, limit);
+}
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2
+
+#endif // MSGPACK_V2_DECODE_HPP
@@ -0,0 +1,79 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_DECODE_DECL_HPP
+#define MSGPACK_V2_DECODE_DECL_HPP
+
+#include "msgpack/unpack_decl.hpp"
+
+#if !defined(MSGPACK_USE_CPP03)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+namespace detail {
+
+class decoder;
+
+template <typename T, typename Enabler = void>
+struct decode_imp;
+
+} // namespace detail
+
+/// Decode msgpack formatted data to a value directly.
+/**
+ * Unlike msgpack::unpack() followed by msgpack::object::convert(), no msgpack::object
+ * tree is created. Types defined by MSGPACK_DEFINE, MSGPACK_DEFINE_ARRAY and
+ * MSGPACK_DEFINE_MAP, std::vector, std::map and std::unordered_map are decoded
+ * directly, and the scalar values are converted by the convert adaptors.
+ * The other containers are unpacked into a temporary zone and converted.
+ *
+ * @tparam T The type of the value. It can't be msgpack::object because the
+ *           temporary zone is destroyed before returning.
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param off The offset position of the buffer. It is overwritten by the end of the decoded object.
+ * @param v The value that the object is decoded to.
+ * @param limit The size limit information.
+ *
+ * If the buffer doesn't contain a complete object, msgpack::insufficient_bytes is thrown.
+ * If the data is not msgpack format, msgpack::parse_error is thrown.
+ * If the object can't be converted to T, msgpack::type_error is thrown.
+ * In these cases off is not updated and v could be modified partially.
+ */
+template <typename T>
+void decode(
+    const char* data, std::size_t len, std::size_t& off, T& v,
+    unpack_limit const& limit = unpack_limit());
+
+/// Decode msgpack formatted data to a value directly.
+/**
+ * @tparam T The type of the value.
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param v The value that the object is decoded to.
+ * @param limit The size limit information.
+ *
+ * See the overload that has `off`.
+ */
+template <typename T>
+void decode(
+    const char* data, std::size_t len, T& v,
+    unpack_limit const& limit = unpack_limit());
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+#endif // MSGPACK_V2_DECODE_DECL_HPP
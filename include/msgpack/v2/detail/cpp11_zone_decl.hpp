@@ -19,6 +19,14 @@ MSGPACK_API_VERSION_NAMESPACE(v2) {
 /// @endcond
 
 using v1::zone;
+using v1::inline_zone;
+using v1::zone_allocator;
+using v1::zone_stats;
+
+using v1::zone_growth;
+using v1::ZONE_GROWTH_FIXED;
+using v1::ZONE_GROWTH_GEOMETRIC;
+using v1::ZONE_GROWTH_CAPPED_GEOMETRIC;
 
 using v1::aligned_size;
 
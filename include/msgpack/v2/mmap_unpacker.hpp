@@ -0,0 +1,201 @@
+//
+// MessagePack for C++ memory mapped file unpacker
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_MMAP_UNPACKER_HPP
+#define MSGPACK_V2_MMAP_UNPACKER_HPP
+
+#if MSGPACK_DEFAULT_API_VERSION >= 2
+
+#include "msgpack/v2/mmap_unpacker_decl.hpp"
+#include "msgpack/parse.hpp"
+#include "msgpack/unpack.hpp"
+
+#if defined(MSGPACK_MMAP_UNPACKER)
+
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+namespace detail {
+
+inline bool mmap_unpacker_reference_all(msgpack::type::object_type, std::size_t, void*)
+{
+    return true;
+}
+
+} // namespace detail
+
+/// Unpacker that reads concatenated msgpack objects from a memory mapped file.
+/**
+ * The file is mapped read only and unpacked in place, so no byte is copied
+ * into an unpacker buffer. The str, bin and ext values reference the mapping
+ * unless the reference function decides otherwise, and they are valid while
+ * the mmap_unpacker exists.
+ *
+ * The mapping is advised to be read sequentially, and the next
+ * MSGPACK_MMAP_UNPACKER_READAHEAD_SIZE bytes are advised to be needed as
+ * the offset proceeds.
+ */
+class mmap_unpacker {
+public:
+    /**
+     * @param path The path of the file.
+     * @param f A judging function that msgpack::object refer to the mapping.
+     *          If it is null, all str, bin and ext values refer to the mapping.
+     * @param user_data This parameter is passed to f.
+     * @param limit The size limit information of msgpack::object.
+     *
+     * If the file can't be mapped, std::runtime_error is thrown.
+     */
+    explicit mmap_unpacker(
+        const char* path,
+        unpack_reference_func f = MSGPACK_NULLPTR,
+        void* user_data = MSGPACK_NULLPTR,
+        unpack_limit const& limit = unpack_limit())
+        :m_data(MSGPACK_NULLPTR), m_size(0), m_off(0), m_advised(0),
+         m_func(f ? f : &detail::mmap_unpacker_reference_all),
+         m_user_data(user_data), m_limit(limit)
+    {
+        int fd = ::open(path, O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error("open() failed");
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error("fstat() failed");
+        }
+        m_size = static_cast<std::size_t>(st.st_size);
+        if (m_size != 0) {
+            void* p = ::mmap(MSGPACK_NULLPTR, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error("mmap() failed");
+            }
+            m_data = static_cast<const char*>(p);
+            ::madvise(p, m_size, MADV_SEQUENTIAL);
+            advise();
+        }
+        ::close(fd);
+    }
+
+    ~mmap_unpacker()
+    {
+        if (m_data) {
+            ::munmap(const_cast<char*>(m_data), m_size);
+        }
+    }
+
+    /// Unpack the next object.
+    /**
+     * @param result The object_handle that the object is unpacked to.
+     *
+     * @return true if an object is unpacked, false at the end of the file.
+     *
+     * If the file ends in the middle of an object, msgpack::insufficient_bytes is thrown.
+     * If the data is not msgpack format, msgpack::parse_error is thrown.
+     * In these cases offset() is not updated.
+     */
+    bool next(msgpack::object_handle& result)
+    {
+        if (m_off == m_size) {
+            return false;
+        }
+        msgpack::v2::unpack(result, m_data, m_size, m_off, m_func, m_user_data, m_limit);
+        advise();
+        return true;
+    }
+
+    /// Parse the next object via a visitor.
+    /**
+     * @param v The visitor that satisfies visitor concept.
+     *
+     * @return true if an object is parsed, false at the end of the file or if
+     *         the visitor stops parsing. The errors are reported to v.
+     */
+    template <typename Visitor>
+    bool next(Visitor& v)
+    {
+        if (m_off == m_size) {
+            return false;
+        }
+        bool ret = msgpack::v2::parse(m_data, m_size, m_off, v);
+        advise();
+        return ret;
+    }
+
+    /// The mapped file.
+    const char* data() const
+    {
+        return m_data;
+    }
+
+    std::size_t size() const
+    {
+        return m_size;
+    }
+
+    /// The offset of the next object.
+    std::size_t offset() const
+    {
+        return m_off;
+    }
+
+private:
+    // Advise the next window when the offset enters the last advised one.
+    void advise()
+    {
+        const std::size_t window = MSGPACK_MMAP_UNPACKER_READAHEAD_SIZE;
+        if (m_advised >= m_size || m_off + window / 2 < m_advised) {
+            return;
+        }
+        const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+        std::size_t begin = m_off / page * page;
+        std::size_t end = m_off + window < m_size ? m_off + window : m_size;
+        ::madvise(const_cast<char*>(m_data) + begin, end - begin, MADV_WILLNEED);
+        m_advised = end;
+    }
+
+#if defined(MSGPACK_USE_CPP03)
+private:
+    mmap_unpacker(const mmap_unpacker&);
+    mmap_unpacker& operator=(const mmap_unpacker&);
+#else  // defined(MSGPACK_USE_CPP03)
+    mmap_unpacker(const mmap_unpacker&) = delete;
+    mmap_unpacker& operator=(const mmap_unpacker&) = delete;
+#endif // defined(MSGPACK_USE_CPP03)
+
+private:
+    const char* m_data;
+    std::size_t m_size;
+    std::size_t m_off;
+    std::size_t m_advised;
+    unpack_reference_func m_func;
+    void* m_user_data;
+    unpack_limit m_limit;
+};
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_MMAP_UNPACKER)
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2
+
+#endif // MSGPACK_V2_MMAP_UNPACKER_HPP
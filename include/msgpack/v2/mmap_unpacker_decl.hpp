@@ -0,0 +1,39 @@
+//
+// MessagePack for C++ memory mapped file unpacker
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_MMAP_UNPACKER_DECL_HPP
+#define MSGPACK_V2_MMAP_UNPACKER_DECL_HPP
+
+#include "msgpack/unpack_decl.hpp"
+
+#if defined(unix) || defined(__unix) || defined(__APPLE__) || defined(__OpenBSD__)
+#define MSGPACK_MMAP_UNPACKER
+#endif
+
+#if defined(MSGPACK_MMAP_UNPACKER)
+
+#ifndef MSGPACK_MMAP_UNPACKER_READAHEAD_SIZE
+#define MSGPACK_MMAP_UNPACKER_READAHEAD_SIZE (4*1024*1024)
+#endif
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+class mmap_unpacker;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_MMAP_UNPACKER)
+
+#endif // MSGPACK_V2_MMAP_UNPACKER_DECL_HPP
@@ -0,0 +1,29 @@
+//
+// MessagePack for C++ serializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_PACKED_SIZE_DECL_HPP
+#define MSGPACK_V2_PACKED_SIZE_DECL_HPP
+
+#include "msgpack/v1/packed_size_decl.hpp"
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+using v1::packed_size;
+
+using v1::max_packed_size;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V2_PACKED_SIZE_DECL_HPP
@@ -0,0 +1,133 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_PARALLEL_UNPACK_HPP
+#define MSGPACK_V2_PARALLEL_UNPACK_HPP
+
+#if MSGPACK_DEFAULT_API_VERSION >= 2
+
+#include "msgpack/v2/parallel_unpack_decl.hpp"
+#include "msgpack/parse.hpp"
+#include "msgpack/unpack.hpp"
+
+#if !defined(MSGPACK_USE_CPP03)
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+#include <vector>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+namespace detail {
+
+// Push the end offsets of the complete objects from off to bounds.
+inline void find_boundaries(const char* data, std::size_t len, std::size_t& off, std::vector<std::size_t>& bounds)
+{
+    while (off < len) {
+        std::size_t next = off;
+        switch (msgpack::v2::skip(data, len, next)) {
+        case PARSE_CONTINUE:
+            return;
+        case PARSE_PARSE_ERROR:
+            throw msgpack::parse_error("parse error");
+        default:
+            off = next;
+            bounds.push_back(off);
+            break;
+        }
+    }
+}
+
+} // namespace detail
+
+inline void parallel_unpack(
+    std::vector<msgpack::object_handle>& result,
+    const char* data, std::size_t len, std::size_t& off,
+    std::size_t num_threads,
+    unpack_reference_func f, void* user_data,
+    unpack_limit const& limit)
+{
+    // bounds[i] and bounds[i + 1] are the begin and the end of the i-th object.
+    std::vector<std::size_t> bounds(1, off);
+    std::size_t noff = off;
+    detail::find_boundaries(data, len, noff, bounds);
+
+    std::size_t num_objects = bounds.size() - 1;
+    result.clear();
+    result.resize(num_objects);
+
+    if (num_threads == 0) num_threads = std::thread::hardware_concurrency();
+    num_threads = std::max<std::size_t>(1, std::min(num_threads, num_objects));
+
+    // Split the objects into the ranges that have about the same byte size.
+    std::vector<std::size_t> firsts(num_threads + 1, num_objects);
+    firsts[0] = 0;
+    std::size_t total = noff - off;
+    for (std::size_t t = 1; t < num_threads; ++t) {
+        std::size_t target = off + total / num_threads * t;
+        firsts[t] = static_cast<std::size_t>(
+            std::lower_bound(bounds.begin(), bounds.end() - 1, target) - bounds.begin());
+    }
+
+    std::vector<std::exception_ptr> errors(num_threads);
+    auto work = [&](std::size_t t) {
+        try {
+            for (std::size_t i = firsts[t]; i < firsts[t + 1]; ++i) {
+                std::size_t obj_off = bounds[i];
+                msgpack::v2::unpack(result[i], data, bounds[i + 1], obj_off, f, user_data, limit);
+            }
+        }
+        catch (...) {
+            errors[t] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads - 1);
+    try {
+        for (std::size_t t = 1; t < num_threads; ++t) {
+            threads.emplace_back(work, t);
+        }
+    }
+    catch (...) {
+        // destroying joinable threads calls std::terminate()
+        for (std::size_t t = 0; t != threads.size(); ++t) {
+            threads[t].join();
+        }
+        result.clear();
+        throw;
+    }
+    work(0);
+    for (std::size_t t = 0; t != threads.size(); ++t) {
+        threads[t].join();
+    }
+
+    for (std::size_t t = 0; t != errors.size(); ++t) {
+        if (errors[t]) {
+            result.clear();
+            std::rethrow_exception(errors[t]);
+        }
+    }
+    off = noff;
+}
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2
+
+#endif // MSGPACK_V2_PARALLEL_UNPACK_HPP
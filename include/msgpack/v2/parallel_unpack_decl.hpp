@@ -0,0 +1,58 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_PARALLEL_UNPACK_DECL_HPP
+#define MSGPACK_V2_PARALLEL_UNPACK_DECL_HPP
+
+#include "msgpack/unpack_decl.hpp"
+
+#if !defined(MSGPACK_USE_CPP03)
+
+#include <vector>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+/// Unpack concatenated msgpack::objects from a buffer concurrently.
+/**
+ * At first, the boundaries of the objects are found by msgpack::skip().
+ * Then the objects are split into `num_threads` ranges of about the same
+ * byte size, and each range is unpacked by its own thread.
+ * Each object_handle has its own zone as msgpack::unpack().
+ *
+ * @param result The unpacked objects in the order of the buffer. Its old contents are discarded.
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param off The offset position of the buffer. It is overwritten by the end of the last complete object.
+ *            The trailing incomplete object, if any, is not unpacked.
+ * @param num_threads The number of threads including the calling thread. If 0, std::thread::hardware_concurrency() is used.
+ * @param f A judging function that msgpack::object refer to the buffer.
+ * @param user_data This parameter is passed to f. f could be called from multiple threads.
+ * @param limit The size limit information of msgpack::object.
+ *
+ * If the data is not msgpack format, msgpack::parse_error is thrown and nothing is unpacked.
+ * If unpacking throws an exception in a thread, the exception for the first object is rethrown
+ * after all threads finish.
+ */
+void parallel_unpack(
+    std::vector<msgpack::object_handle>& result,
+    const char* data, std::size_t len, std::size_t& off,
+    std::size_t num_threads = 0,
+    unpack_reference_func f = MSGPACK_NULLPTR, void* user_data = MSGPACK_NULLPTR, unpack_limit const& limit = unpack_limit());
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+#endif // MSGPACK_V2_PARALLEL_UNPACK_DECL_HPP
@@ -0,0 +1,31 @@
+//
+// MessagePack for C++ parallel deflate buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_PARALLEL_ZBUFFER_DECL_HPP
+#define MSGPACK_V2_PARALLEL_ZBUFFER_DECL_HPP
+
+#include "msgpack/v1/parallel_zbuffer_decl.hpp"
+
+#if !defined(MSGPACK_USE_CPP03)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+using v1::parallel_zbuffer;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+#endif // MSGPACK_V2_PARALLEL_ZBUFFER_DECL_HPP
@@ -13,11 +13,17 @@
 #if MSGPACK_DEFAULT_API_VERSION >= 2
 
 #include <cstddef>
+#include <deque>
+
+#if !defined(MSGPACK_USE_CPP03)
+#include <atomic>
+#endif // !defined(MSGPACK_USE_CPP03)
 
 #include "msgpack/unpack_define.h"
 #include "msgpack/parse_return.hpp"
 #include "msgpack/unpack_exception.hpp"
 #include "msgpack/unpack_decl.hpp"
+#include "msgpack/typed_array.hpp"
 
 namespace msgpack {
 
@@ -31,6 +37,233 @@ using v1::detail::fix_tag;
 using v1::detail::value;
 using v1::detail::load;
 
+// Header byte classification used by context::execute().
+// Types that have fixed size trail bytes use msgpack_unpack_state
+// as the kind, so it can be set to m_cs as is.
+struct header_info {
+    enum kind_type {
+        positive_fixint = 0x20,
+        negative_fixint,
+        fixstr,
+        fixarray,
+        fixmap,
+        nil,
+        boolean_false,
+        boolean_true,
+        never_used
+    };
+    uint8_t kind;
+    uint8_t trail;
+};
+
+inline header_info const* header_table()
+{
+#define MSGPACK_DETAIL_HI1(k)  { header_info::k, 0 }
+#define MSGPACK_DETAIL_HI4(k)  MSGPACK_DETAIL_HI1(k), MSGPACK_DETAIL_HI1(k), MSGPACK_DETAIL_HI1(k), MSGPACK_DETAIL_HI1(k)
+#define MSGPACK_DETAIL_HI16(k) MSGPACK_DETAIL_HI4(k), MSGPACK_DETAIL_HI4(k), MSGPACK_DETAIL_HI4(k), MSGPACK_DETAIL_HI4(k)
+    static const header_info table[256] = {
+        // 0x00 - 0x7f positive fixint
+        MSGPACK_DETAIL_HI16(positive_fixint), MSGPACK_DETAIL_HI16(positive_fixint),
+        MSGPACK_DETAIL_HI16(positive_fixint), MSGPACK_DETAIL_HI16(positive_fixint),
+        MSGPACK_DETAIL_HI16(positive_fixint), MSGPACK_DETAIL_HI16(positive_fixint),
+        MSGPACK_DETAIL_HI16(positive_fixint), MSGPACK_DETAIL_HI16(positive_fixint),
+        // 0x80 - 0x8f fixmap
+        MSGPACK_DETAIL_HI16(fixmap),
+        // 0x90 - 0x9f fixarray
+        MSGPACK_DETAIL_HI16(fixarray),
+        // 0xa0 - 0xbf fixstr
+        MSGPACK_DETAIL_HI16(fixstr), MSGPACK_DETAIL_HI16(fixstr),
+        MSGPACK_DETAIL_HI1(nil),           // 0xc0
+        MSGPACK_DETAIL_HI1(never_used),    // 0xc1
+        MSGPACK_DETAIL_HI1(boolean_false), // 0xc2
+        MSGPACK_DETAIL_HI1(boolean_true),  // 0xc3
+        { MSGPACK_CS_BIN_8,      1 },      // 0xc4
+        { MSGPACK_CS_BIN_16,     2 },      // 0xc5
+        { MSGPACK_CS_BIN_32,     4 },      // 0xc6
+        { MSGPACK_CS_EXT_8,      1 },      // 0xc7
+        { MSGPACK_CS_EXT_16,     2 },      // 0xc8
+        { MSGPACK_CS_EXT_32,     4 },      // 0xc9
+        { MSGPACK_CS_FLOAT,      4 },      // 0xca
+        { MSGPACK_CS_DOUBLE,     8 },      // 0xcb
+        { MSGPACK_CS_UINT_8,     1 },      // 0xcc
+        { MSGPACK_CS_UINT_16,    2 },      // 0xcd
+        { MSGPACK_CS_UINT_32,    4 },      // 0xce
+        { MSGPACK_CS_UINT_64,    8 },      // 0xcf
+        { MSGPACK_CS_INT_8,      1 },      // 0xd0
+        { MSGPACK_CS_INT_16,     2 },      // 0xd1
+        { MSGPACK_CS_INT_32,     4 },      // 0xd2
+        { MSGPACK_CS_INT_64,     8 },      // 0xd3
+        { MSGPACK_CS_FIXEXT_1,   2 },      // 0xd4
+        { MSGPACK_CS_FIXEXT_2,   3 },      // 0xd5
+        { MSGPACK_CS_FIXEXT_4,   5 },      // 0xd6
+        { MSGPACK_CS_FIXEXT_8,   9 },      // 0xd7
+        { MSGPACK_CS_FIXEXT_16, 17 },      // 0xd8
+        { MSGPACK_CS_STR_8,      1 },      // 0xd9
+        { MSGPACK_CS_STR_16,     2 },      // 0xda
+        { MSGPACK_CS_STR_32,     4 },      // 0xdb
+        { MSGPACK_CS_ARRAY_16,   2 },      // 0xdc
+        { MSGPACK_CS_ARRAY_32,   4 },      // 0xdd
+        { MSGPACK_CS_MAP_16,     2 },      // 0xde
+        { MSGPACK_CS_MAP_32,     4 },      // 0xdf
+        // 0xe0 - 0xff negative fixint
+        MSGPACK_DETAIL_HI16(negative_fixint), MSGPACK_DETAIL_HI16(negative_fixint)
+    };
+#undef MSGPACK_DETAIL_HI16
+#undef MSGPACK_DETAIL_HI4
+#undef MSGPACK_DETAIL_HI1
+    return table;
+}
+
+// Load the size field of str, bin, ext, array and map.
+inline uint32_t load_size(std::size_t width, const char* n)
+{
+    switch(width) {
+    case 1: {
+        uint8_t tmp;
+        load<uint8_t>(tmp, n);
+        return tmp;
+    }
+    case 2: {
+        uint16_t tmp;
+        load<uint16_t>(tmp, n);
+        return tmp;
+    }
+    default: {
+        uint32_t tmp;
+        load<uint32_t>(tmp, n);
+        return tmp;
+    }
+    }
+}
+
+// Skip one object that starts at data + off without calling a visitor.
+// Only the number of the remaining objects is tracked, so nested
+// containers need no stack.
+// If the object is complete, off is updated to the next position and
+// PARSE_SUCCESS or PARSE_EXTRA_BYTES is returned. Otherwise off is not
+// updated and PARSE_CONTINUE or PARSE_PARSE_ERROR is returned.
+inline parse_return skip_imp(const char* data, std::size_t len, std::size_t& off)
+{
+    assert(len >= off);
+
+    const char* p = data + off;
+    const char* const pe = data + len;
+    uint64_t rest = 1;
+    do {
+        if (p == pe) return PARSE_CONTINUE;
+        header_info const& hi = header_table()[*reinterpret_cast<const unsigned char*>(p)];
+        --rest;
+        switch(hi.kind) {
+        case header_info::positive_fixint:
+        case header_info::negative_fixint:
+        case header_info::nil:
+        case header_info::boolean_false:
+        case header_info::boolean_true:
+            ++p;
+            break;
+        case header_info::fixstr: {
+            std::size_t size = static_cast<std::size_t>(*p) & 0x1f;
+            if (static_cast<std::size_t>(pe - p) <= size) return PARSE_CONTINUE;
+            p += size + 1;
+        } break;
+        case header_info::fixarray:
+            rest += static_cast<uint64_t>(*p) & 0x0f;
+            ++p;
+            break;
+        case header_info::fixmap:
+            rest += (static_cast<uint64_t>(*p) & 0x0f) * 2;
+            ++p;
+            break;
+        case header_info::never_used:
+            return PARSE_PARSE_ERROR;
+        default: {
+            if (static_cast<std::size_t>(pe - p) <= hi.trail) return PARSE_CONTINUE;
+            const char* n = p + 1;
+            p = n + hi.trail;
+            switch(hi.kind) {
+            case MSGPACK_CS_STR_8:
+            case MSGPACK_CS_STR_16:
+            case MSGPACK_CS_STR_32:
+            case MSGPACK_CS_BIN_8:
+            case MSGPACK_CS_BIN_16:
+            case MSGPACK_CS_BIN_32: {
+                std::size_t size = load_size(hi.trail, n);
+                if (static_cast<std::size_t>(pe - p) < size) return PARSE_CONTINUE;
+                p += size;
+            } break;
+            case MSGPACK_CS_EXT_8:
+            case MSGPACK_CS_EXT_16:
+            case MSGPACK_CS_EXT_32: {
+                // includes the type byte
+                uint64_t size = static_cast<uint64_t>(load_size(hi.trail, n)) + 1;
+                if (static_cast<uint64_t>(pe - p) < size) return PARSE_CONTINUE;
+                p += size;
+            } break;
+            case MSGPACK_CS_ARRAY_16:
+            case MSGPACK_CS_ARRAY_32:
+                rest += load_size(hi.trail, n);
+                break;
+            case MSGPACK_CS_MAP_16:
+            case MSGPACK_CS_MAP_32:
+                rest += static_cast<uint64_t>(load_size(hi.trail, n)) * 2;
+                break;
+            default:
+                // fixed size types
+                break;
+            }
+        } break;
+        }
+    } while (rest != 0);
+
+    off = static_cast<std::size_t>(p - data);
+    return p == pe ? PARSE_SUCCESS : PARSE_EXTRA_BYTES;
+}
+
+// If the visitor has `bool skip_value()` and it returns true just before
+// a value header is read, execute_complete() skips the value by skip_imp()
+// without any visit function calls for it.
+// The visitor must work correctly even if the request is ignored.
+#if !defined(MSGPACK_USE_CPP03)
+
+struct skip_value_visitor_check {
+    template <typename V>
+    static auto check(V* v) -> decltype(v->skip_value(), std::true_type());
+    template <typename V>
+    static std::false_type check(...);
+};
+
+template <typename Visitor>
+struct has_skip_value
+    : decltype(skip_value_visitor_check::check<Visitor>(MSGPACK_NULLPTR)) {};
+
+#else  // !defined(MSGPACK_USE_CPP03)
+
+template <typename Visitor>
+struct has_skip_value {
+    static const bool value = false;
+};
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+template <typename Visitor, bool = has_skip_value<Visitor>::value>
+struct skip_value_helper {
+    static bool call(Visitor&) { return false; }
+};
+
+template <typename Visitor>
+struct skip_value_helper<Visitor, true> {
+    static bool call(Visitor& v) { return v.skip_value(); }
+};
+
+template <typename Visitor>
+inline bool skip_value_requested(Visitor& v)
+{
+    return skip_value_helper<Visitor>::call(v);
+}
+
+template <typename Context>
+struct complete_parser;
+
 template <typename VisitorHolder>
 class context {
 public:
@@ -49,13 +282,23 @@ public:
 
     parse_return execute(const char* data, std::size_t len, std::size_t& off);
 
-private:
-    template <typename T>
-    static uint32_t next_cs(T p)
-    {
-        return static_cast<uint32_t>(*p) & 0x1f;
+    // The buffer must contain the whole message. Unlike execute(), the
+    // parsing is not resumable and m_cs and m_trail are not used.
+    // If the message is incomplete, PARSE_CONTINUE is returned and the
+    // parsing needs to be restarted from the beginning.
+    parse_return execute_complete(const char* data, std::size_t len, std::size_t& off) {
+        return complete_parser<context>::execute(*this, data, len, off);
     }
 
+protected:
+    // When execute() returns PARSE_CONTINUE, the bytes from off to len are
+    // a part of the trail that is being read, and the parsing proceeds
+    // when trail() bytes are available from off.
+    std::size_t trail() const { return m_trail; }
+
+private:
+    friend struct complete_parser<context>;
+
     VisitorHolder& holder() {
         return static_cast<VisitorHolder&>(*this);
     }
@@ -150,13 +393,11 @@ private:
 
     struct unpack_stack {
         struct stack_elem {
+            stack_elem() {}
             stack_elem(msgpack_container_type type, uint32_t rest):m_type(type), m_rest(rest) {}
             msgpack_container_type m_type;
             uint32_t m_rest;
         };
-        unpack_stack() {
-            m_stack.reserve(MSGPACK_EMBED_STACK_SIZE);
-        }
         parse_return push(VisitorHolder& visitor_holder, msgpack_container_type type, uint32_t rest) {
             m_stack.push_back(stack_elem(type, rest));
             switch (type) {
@@ -210,7 +451,7 @@ private:
         bool empty() const { return m_stack.empty(); }
         void clear() { m_stack.clear(); }
     private:
-        std::vector<stack_elem> m_stack;
+        embed_stack<stack_elem> m_stack;
     };
 
     char const* m_start;
@@ -249,52 +490,21 @@ inline parse_return context<VisitorHolder>::execute(const char* data, std::size_
     do {
         if (m_cs == MSGPACK_CS_HEADER) {
             fixed_trail_again = false;
-            int selector = *reinterpret_cast<const unsigned char*>(m_current);
-            if (0x00 <= selector && selector <= 0x7f) { // Positive Fixnum
+            header_info const& hi = header_table()[*reinterpret_cast<const unsigned char*>(m_current)];
+            switch(hi.kind) {
+            case header_info::positive_fixint: {
                 uint8_t tmp = *reinterpret_cast<const uint8_t*>(m_current);
                 bool visret = holder().visitor().visit_positive_integer(tmp);
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else if(0xe0 <= selector && selector <= 0xff) { // Negative Fixnum
+            } break;
+            case header_info::negative_fixint: {
                 int8_t tmp = *reinterpret_cast<const int8_t*>(m_current);
                 bool visret = holder().visitor().visit_negative_integer(tmp);
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else if (0xc4 <= selector && selector <= 0xdf) {
-                const uint32_t trail[] = {
-                    1, // bin     8  0xc4
-                    2, // bin    16  0xc5
-                    4, // bin    32  0xc6
-                    1, // ext     8  0xc7
-                    2, // ext    16  0xc8
-                    4, // ext    32  0xc9
-                    4, // float  32  0xca
-                    8, // float  64  0xcb
-                    1, // uint    8  0xcc
-                    2, // uint   16  0xcd
-                    4, // uint   32  0xce
-                    8, // uint   64  0xcf
-                    1, // int     8  0xd0
-                    2, // int    16  0xd1
-                    4, // int    32  0xd2
-                    8, // int    64  0xd3
-                    2, // fixext  1  0xd4
-                    3, // fixext  2  0xd5
-                    5, // fixext  4  0xd6
-                    9, // fixext  8  0xd7
-                    17,// fixext 16  0xd8
-                    1, // str     8  0xd9
-                    2, // str    16  0xda
-                    4, // str    32  0xdb
-                    2, // array  16  0xdc
-                    4, // array  32  0xdd
-                    2, // map    16  0xde
-                    4, // map    32  0xdf
-                };
-                m_trail = trail[selector - 0xc4];
-                m_cs = next_cs(m_current);
-                fixed_trail_again = true;
-            } else if(0xa0 <= selector && selector <= 0xbf) { // FixStr
+            } break;
+            case header_info::fixstr: {
                 m_trail = static_cast<uint32_t>(*m_current) & 0x1f;
                 if(m_trail == 0) {
                     bool visret = holder().visitor().visit_str(n, static_cast<uint32_t>(m_trail));
@@ -305,29 +515,41 @@ inline parse_return context<VisitorHolder>::execute(const char* data, std::size_
                     m_cs = MSGPACK_ACS_STR_VALUE;
                     fixed_trail_again = true;
                 }
-            } else if(0x90 <= selector && selector <= 0x9f) { // FixArray
+            } break;
+            case header_info::fixarray: {
                 parse_return ret = start_aggregate<fix_tag>(array_sv(holder()), array_ev(holder()), m_current, off);
                 if (ret != PARSE_CONTINUE) return ret;
-            } else if(0x80 <= selector && selector <= 0x8f) { // FixMap
+            } break;
+            case header_info::fixmap: {
                 parse_return ret = start_aggregate<fix_tag>(map_sv(holder()), map_ev(holder()), m_current, off);
                 if (ret != PARSE_CONTINUE) return ret;
-            } else if(selector == 0xc2) { // false
-                bool visret = holder().visitor().visit_boolean(false);
+            } break;
+            case header_info::nil: {
+                bool visret = holder().visitor().visit_nil();
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else if(selector == 0xc3) { // true
-                bool visret = holder().visitor().visit_boolean(true);
+            } break;
+            case header_info::boolean_false: {
+                bool visret = holder().visitor().visit_boolean(false);
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else if(selector == 0xc0) { // nil
-                bool visret = holder().visitor().visit_nil();
+            } break;
+            case header_info::boolean_true: {
+                bool visret = holder().visitor().visit_boolean(true);
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else {
+            } break;
+            case header_info::never_used: {
                 off = static_cast<std::size_t>(m_current - m_start);
                 holder().visitor().parse_error(off - 1, off);
                 return PARSE_PARSE_ERROR;
             }
+            default: // fixed size trail
+                m_trail = hi.trail;
+                m_cs = hi.kind;
+                fixed_trail_again = true;
+                break;
+            }
             // end MSGPACK_CS_HEADER
         }
         if (m_cs != MSGPACK_CS_HEADER || fixed_trail_again) {
@@ -617,6 +839,345 @@ inline parse_return context<VisitorHolder>::execute(const char* data, std::size_
     return PARSE_CONTINUE;
 }
 
+// A buffer that is passed to parser::feed(). The caller's release function
+// is called when both the parser and the zones that reference the buffer
+// drop it.
+struct feed_chunk {
+    feed_chunk(const char* d, std::size_t s, void (*r)(void*), void* u)
+        :data(d), size(s), release(r), user_data(u), referenced(false), count(1) {}
+    const char* data;
+    std::size_t size;
+    void (*release)(void*);
+    void* user_data;
+    bool referenced;
+#if defined(MSGPACK_USE_CPP03)
+    volatile _msgpack_atomic_counter_t count;
+#else  // defined(MSGPACK_USE_CPP03)
+    std::atomic<unsigned int> count;
+#endif // defined(MSGPACK_USE_CPP03)
+};
+
+inline void incr_chunk_count(feed_chunk* c)
+{
+#if defined(MSGPACK_USE_CPP03)
+    _msgpack_sync_incr_and_fetch(&c->count);
+#else  // defined(MSGPACK_USE_CPP03)
+    ++c->count;
+#endif // defined(MSGPACK_USE_CPP03)
+}
+
+inline void decr_chunk_count(void* p)
+{
+    feed_chunk* c = static_cast<feed_chunk*>(p);
+#if defined(MSGPACK_USE_CPP03)
+    if(_msgpack_sync_decr_and_fetch(&c->count) != 0) return;
+#else  // defined(MSGPACK_USE_CPP03)
+    if(--c->count != 0) return;
+#endif // defined(MSGPACK_USE_CPP03)
+    if(c->release) c->release(c->user_data);
+    delete c;
+}
+
+// If the ReferencedBufferHook is callable with `void (*)(void*)` and
+// `void*`, the fed buffers are parsed in place and passed to the hook.
+// Otherwise parser::feed() copies them to the internal buffer, so the
+// hooks that take only char* keep working.
+#if !defined(MSGPACK_USE_CPP03)
+
+struct fed_buffer_hook_check {
+    template <typename H>
+    static auto check(H* h) -> decltype(
+        (*h)(static_cast<void (*)(void*)>(MSGPACK_NULLPTR), static_cast<void*>(MSGPACK_NULLPTR)),
+        std::true_type());
+    template <typename H>
+    static std::false_type check(...);
+};
+
+template <typename ReferencedBufferHook>
+struct has_fed_buffer_hook
+    : decltype(fed_buffer_hook_check::check<ReferencedBufferHook>(MSGPACK_NULLPTR)) {};
+
+#else  // !defined(MSGPACK_USE_CPP03)
+
+// The call can't be detected on C++03. Specialize it for the hook.
+template <typename ReferencedBufferHook>
+struct has_fed_buffer_hook {
+    static const bool value = false;
+};
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+template <bool InPlace>
+struct fed_buffer_tag {};
+
+// The parsing of a buffer that contains the whole message. It is shared
+// by the contexts of v2 and v3, and the differences of them, the offset
+// on PARSE_STOP_VISITOR and the way to consume an element, are in
+// start_aggregate() and after_visit_proc() of the Context.
+template <typename Context>
+struct complete_parser {
+    static parse_return execute(Context& c, const char* data, std::size_t len, std::size_t& off)
+    {
+        assert(len >= off);
+
+        c.m_start = data;
+        c.m_current = data + off;
+        const char* const pe = data + len;
+        const char* n = MSGPACK_NULLPTR;
+
+        while(c.m_current != pe) {
+            if (skip_value_requested(c.holder().visitor())) {
+                std::size_t end = static_cast<std::size_t>(c.m_current - c.m_start);
+                switch (skip_imp(c.m_start, len, end)) {
+                case PARSE_CONTINUE:
+                    off = static_cast<std::size_t>(c.m_current - c.m_start);
+                    return PARSE_CONTINUE;
+                case PARSE_PARSE_ERROR:
+                    off = static_cast<std::size_t>(c.m_current - c.m_start);
+                    c.holder().visitor().parse_error(off, off);
+                    return PARSE_PARSE_ERROR;
+                default:
+                    break;
+                }
+                // m_current points the last byte of the skipped value
+                c.m_current = c.m_start + end - 1;
+                parse_return upr = c.after_visit_proc(true, off);
+                if (upr != PARSE_CONTINUE) return upr;
+                continue;
+            }
+            header_info const& hi = header_table()[*reinterpret_cast<const unsigned char*>(c.m_current)];
+            switch(hi.kind) {
+            case header_info::positive_fixint: {
+                uint8_t tmp = *reinterpret_cast<const uint8_t*>(c.m_current);
+                bool visret = c.holder().visitor().visit_positive_integer(tmp);
+                parse_return upr = c.after_visit_proc(visret, off);
+                if (upr != PARSE_CONTINUE) return upr;
+            } break;
+            case header_info::negative_fixint: {
+                int8_t tmp = *reinterpret_cast<const int8_t*>(c.m_current);
+                bool visret = c.holder().visitor().visit_negative_integer(tmp);
+                parse_return upr = c.after_visit_proc(visret, off);
+                if (upr != PARSE_CONTINUE) return upr;
+            } break;
+            case header_info::fixstr: {
+                uint32_t size = static_cast<uint32_t>(*c.m_current) & 0x1f;
+                if (!trail_in_buffer(c, pe, size, n, off)) return PARSE_CONTINUE;
+                bool visret = c.holder().visitor().visit_str(n, size);
+                parse_return upr = c.after_visit_proc(visret, off);
+                if (upr != PARSE_CONTINUE) return upr;
+            } break;
+            case header_info::fixarray: {
+                parse_return ret = start_array<fix_tag>(c, c.m_current, pe, off);
+                if (ret != PARSE_CONTINUE) return ret;
+            } break;
+            case header_info::fixmap: {
+                parse_return ret = c.template start_aggregate<fix_tag>(typename Context::map_sv(c.holder()), typename Context::map_ev(c.holder()), c.m_current, off);
+                if (ret != PARSE_CONTINUE) return ret;
+            } break;
+            case header_info::nil: {
+                bool visret = c.holder().visitor().visit_nil();
+                parse_return upr = c.after_visit_proc(visret, off);
+                if (upr != PARSE_CONTINUE) return upr;
+            } break;
+            case header_info::boolean_false: {
+                bool visret = c.holder().visitor().visit_boolean(false);
+                parse_return upr = c.after_visit_proc(visret, off);
+                if (upr != PARSE_CONTINUE) return upr;
+            } break;
+            case header_info::boolean_true: {
+                bool visret = c.holder().visitor().visit_boolean(true);
+                parse_return upr = c.after_visit_proc(visret, off);
+                if (upr != PARSE_CONTINUE) return upr;
+            } break;
+            case header_info::never_used: {
+                off = static_cast<std::size_t>(c.m_current - c.m_start);
+                c.holder().visitor().parse_error(off - 1, off);
+                return PARSE_PARSE_ERROR;
+            }
+            default: {
+                // fixed size trail
+                // m_current points the last byte of the trail after here
+                if (!trail_in_buffer(c, pe, hi.trail, n, off)) return PARSE_CONTINUE;
+                switch(hi.kind) {
+                case MSGPACK_CS_FLOAT: {
+                    union { uint32_t i; float f; } mem;
+                    load<uint32_t>(mem.i, n);
+                    bool visret = c.holder().visitor().visit_float32(mem.f);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_DOUBLE: {
+                    union { uint64_t i; double f; } mem;
+                    load<uint64_t>(mem.i, n);
+    #if defined(TARGET_OS_IPHONE)
+                    // ok
+    #elif defined(__arm__) && !(__ARM_EABI__) // arm-oabi
+                    // https://github.com/msgpack/msgpack-perl/pull/1
+                    mem.i = (mem.i & 0xFFFFFFFFUL) << 32UL | (mem.i >> 32UL);
+    #endif
+                    bool visret = c.holder().visitor().visit_float64(mem.f);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_UINT_8: {
+                    uint8_t tmp;
+                    load<uint8_t>(tmp, n);
+                    bool visret = c.holder().visitor().visit_positive_integer(tmp);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_UINT_16: {
+                    uint16_t tmp;
+                    load<uint16_t>(tmp, n);
+                    bool visret = c.holder().visitor().visit_positive_integer(tmp);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_UINT_32: {
+                    uint32_t tmp;
+                    load<uint32_t>(tmp, n);
+                    bool visret = c.holder().visitor().visit_positive_integer(tmp);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_UINT_64: {
+                    uint64_t tmp;
+                    load<uint64_t>(tmp, n);
+                    bool visret = c.holder().visitor().visit_positive_integer(tmp);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_INT_8: {
+                    int8_t tmp;
+                    load<int8_t>(tmp, n);
+                    bool visret = c.holder().visitor().visit_negative_integer(tmp);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_INT_16: {
+                    int16_t tmp;
+                    load<int16_t>(tmp, n);
+                    bool visret = c.holder().visitor().visit_negative_integer(tmp);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_INT_32: {
+                    int32_t tmp;
+                    load<int32_t>(tmp, n);
+                    bool visret = c.holder().visitor().visit_negative_integer(tmp);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_INT_64: {
+                    int64_t tmp;
+                    load<int64_t>(tmp, n);
+                    bool visret = c.holder().visitor().visit_negative_integer(tmp);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_FIXEXT_1:
+                case MSGPACK_CS_FIXEXT_2:
+                case MSGPACK_CS_FIXEXT_4:
+                case MSGPACK_CS_FIXEXT_8:
+                case MSGPACK_CS_FIXEXT_16: {
+                    bool visret = c.holder().visitor().visit_ext(n, hi.trail);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_STR_8:
+                case MSGPACK_CS_STR_16:
+                case MSGPACK_CS_STR_32: {
+                    uint32_t size = load_size(hi.trail, n);
+                    if (!trail_in_buffer(c, pe, size, n, off)) return PARSE_CONTINUE;
+                    bool visret = c.holder().visitor().visit_str(n, size);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_BIN_8:
+                case MSGPACK_CS_BIN_16:
+                case MSGPACK_CS_BIN_32: {
+                    uint32_t size = load_size(hi.trail, n);
+                    if (!trail_in_buffer(c, pe, size, n, off)) return PARSE_CONTINUE;
+                    bool visret = c.holder().visitor().visit_bin(n, size);
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_EXT_8:
+                case MSGPACK_CS_EXT_16:
+                case MSGPACK_CS_EXT_32: {
+                    uint32_t size = load_size(hi.trail, n);
+                    check_ext_size<sizeof(std::size_t)>(size);
+                    // includes the type byte
+                    std::size_t trail = static_cast<std::size_t>(size) + 1;
+                    if (!trail_in_buffer(c, pe, trail, n, off)) return PARSE_CONTINUE;
+                    bool visret = c.holder().visitor().visit_ext(n, static_cast<uint32_t>(trail));
+                    parse_return upr = c.after_visit_proc(visret, off);
+                    if (upr != PARSE_CONTINUE) return upr;
+                } break;
+                case MSGPACK_CS_ARRAY_16: {
+                    parse_return ret = start_array<uint16_t>(c, n, pe, off);
+                    if (ret != PARSE_CONTINUE) return ret;
+                } break;
+                case MSGPACK_CS_ARRAY_32: {
+                    parse_return ret = start_array<uint32_t>(c, n, pe, off);
+                    if (ret != PARSE_CONTINUE) return ret;
+                } break;
+                case MSGPACK_CS_MAP_16: {
+                    parse_return ret = c.template start_aggregate<uint16_t>(typename Context::map_sv(c.holder()), typename Context::map_ev(c.holder()), n, off);
+                    if (ret != PARSE_CONTINUE) return ret;
+                } break;
+                case MSGPACK_CS_MAP_32: {
+                    parse_return ret = c.template start_aggregate<uint32_t>(typename Context::map_sv(c.holder()), typename Context::map_ev(c.holder()), n, off);
+                    if (ret != PARSE_CONTINUE) return ret;
+                } break;
+                default:
+                    off = static_cast<std::size_t>(c.m_current - c.m_start);
+                    c.holder().visitor().parse_error(static_cast<std::size_t>(n - c.m_start - 1), static_cast<std::size_t>(n - c.m_start));
+                    return PARSE_PARSE_ERROR;
+                }
+            } break;
+            }
+        }
+
+        off = static_cast<std::size_t>(c.m_current - c.m_start);
+        return PARSE_CONTINUE;
+    }
+
+private:
+    static bool trail_in_buffer(Context& c, const char* pe, std::size_t size, const char*& n, std::size_t& off)
+    {
+        n = c.m_current + 1;
+        if(static_cast<std::size_t>(pe - n) < size) {
+            off = static_cast<std::size_t>(n - c.m_start);
+            return false;
+        }
+        c.m_current += size;
+        return true;
+    }
+
+    // If the visitor has typed array member functions and the all elements
+    // have the same format, visit the elements at once.
+    template <typename T>
+    static parse_return start_array(Context& c, const char* load_pos, const char* pe, std::size_t& off) {
+        typename value<T>::type size;
+        load<T>(size, load_pos);
+        const char* p = c.m_current + 1;
+        std::size_t typed_size = typed_array_size(c.holder().visitor(), p, pe, static_cast<uint32_t>(size));
+        if (typed_size == 0) {
+            return c.template start_aggregate<T>(typename Context::array_sv(c.holder()), typename Context::array_ev(c.holder()), load_pos, off);
+        }
+        if (!c.holder().visitor().start_array(static_cast<uint32_t>(size))) {
+            return c.after_visit_proc(false, off);
+        }
+        // m_current points the last byte of the array after here
+        c.m_current += typed_size;
+        bool visret =
+            visit_typed_array(c.holder().visitor(), p, typed_size, static_cast<uint32_t>(size)) &&
+            c.holder().visitor().end_array();
+        return c.after_visit_proc(visret, off);
+    }
+};
+
 } // detail
 
 
@@ -633,6 +1194,9 @@ public:
      *             `hook` should be callable with char* parameter.
      *             `parser` gives a chance to prepare finalizer.
      *              See https://github.com/msgpack/msgpack-c/wiki/v2_0_cpp_visitor#parse-api
+     *             If feed() is used, `hook` should also be callable with
+     *             `void (*func)(void*)` and `void* data` parameters. It should call
+     *             `func(data)` when the objects that refer to the fed buffer are destroyed.
      * @param initial_buffer_size The memory size to allocate when unpacker is constructed.
      *
      */
@@ -686,6 +1250,35 @@ public:
      */
     void buffer_consumed(std::size_t size);
 
+    /// Feed a buffer that is owned by the caller.
+    /**
+     * @param data The pointer to the buffer.
+     * @param size The size of the buffer.
+     * @param release The function that is called with `user_data` when the buffer is no longer used.
+     *                If it is null, nothing is called.
+     * @param user_data The parameter that is passed to `release`.
+     *
+     * The buffer is not copied. It is parsed after the bytes given by buffer_consumed()
+     * and the buffers fed before. Parsed objects can refer to the buffer directly, only
+     * the headers and the values that span two buffers are copied to the internal buffer.
+     * `release` is called after the buffer is parsed and the objects that refer to it are
+     * destroyed. See the constructor about the hook. If the hook is callable only with
+     * char*, the buffer is copied to the internal buffer and `release` is called before
+     * feed() returns.
+     *
+     * Don't call buffer_consumed() while fed buffers remain, otherwise the bytes are
+     * parsed in the wrong order. If an exception is thrown, the buffer is not fed and
+     * `release` is not called.
+     */
+    void feed(const char* data, std::size_t size,
+              void (*release)(void*) = MSGPACK_NULLPTR, void* user_data = MSGPACK_NULLPTR);
+
+    /// Get the size of the fed buffers that is not parsed.
+    /**
+     * @return The total size of the bytes that remain in the buffers passed by feed().
+     */
+    std::size_t fed_size() const;
+
     /// Unpack one msgpack::object.
     /**
      *
@@ -701,7 +1294,7 @@ public:
 
     /// Get message size.
     /**
-     * @return Returns parsed_size() + nonparsed_size()
+     * @return Returns parsed_size() + nonparsed_size() + fed_size()
      */
     std::size_t message_size() const;
 
@@ -756,9 +1349,26 @@ protected:
     char* get_raw_buffer() {
         return m_buffer;
     }
+    // Returns true if the fed buffer that is being parsed is referenced
+    // by the objects since the last flush_fed_buffer() call.
+    bool fed_buffer_referenced() const;
+    // Passes the referenced fed buffer to the hook. The parser keeps its
+    // own reference.
+    void flush_fed_buffer();
 private:
     void expand_buffer(std::size_t size);
+    typedef detail::fed_buffer_tag<detail::has_fed_buffer_hook<ReferencedBufferHook>::value> fed_buffer_tag;
+    void feed_imp(const char* data, std::size_t size,
+                  void (*release)(void*), void* user_data, detail::fed_buffer_tag<true>);
+    void feed_imp(const char* data, std::size_t size,
+                  void (*release)(void*), void* user_data, detail::fed_buffer_tag<false>);
     parse_return execute_imp();
+    parse_return execute_fed_buffers(parse_return ret, detail::fed_buffer_tag<true>);
+    parse_return execute_fed_buffers(parse_return ret, detail::fed_buffer_tag<false>) { return ret; }
+    parse_return execute_buffer();
+    parse_return execute_fed_buffer();
+    void fill_trail();
+    void pop_fed_buffer();
 
 private:
     char* m_buffer;
@@ -768,6 +1378,8 @@ private:
     std::size_t m_parsed;
     std::size_t m_initial_buffer_size;
     ReferencedBufferHook& m_referenced_buffer_hook;
+    std::deque<detail::feed_chunk*> m_fed;
+    std::size_t m_fed_off;
 
 #if defined(MSGPACK_USE_CPP03)
 private:
@@ -801,6 +1413,7 @@ inline parser<VisitorHolder, ReferencedBufferHook>::parser(
     m_off = COUNTER_SIZE;
     m_parsed = 0;
     m_initial_buffer_size = initial_buffer_size;
+    m_fed_off = 0;
 
     detail::init_count(m_buffer);
 }
@@ -817,7 +1430,9 @@ inline parser<VisitorHolder, ReferencedBufferHook>::parser(this_type&& other)
      m_off(other.m_off),
      m_parsed(other.m_parsed),
      m_initial_buffer_size(other.m_initial_buffer_size),
-     m_referenced_buffer_hook(other.m_referenced_buffer_hook) {
+     m_referenced_buffer_hook(other.m_referenced_buffer_hook),
+     m_fed_off(other.m_fed_off) {
+    m_fed.swap(other.m_fed);
     other.m_buffer = MSGPACK_NULLPTR;
     other.m_used = 0;
     other.m_free = 0;
@@ -840,6 +1455,9 @@ inline parser<VisitorHolder, ReferencedBufferHook>::~parser()
 {
     // These checks are required for move operations.
     if (m_buffer) detail::decr_count(m_buffer);
+    for (std::size_t i = 0; i != m_fed.size(); ++i) {
+        detail::decr_chunk_count(m_fed[i]);
+    }
 }
 
 
@@ -942,6 +1560,54 @@ inline void parser<VisitorHolder, ReferencedBufferHook>::buffer_consumed(std::si
     m_free -= size;
 }
 
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline void parser<VisitorHolder, ReferencedBufferHook>::feed(
+    const char* data, std::size_t size, void (*release)(void*), void* user_data)
+{
+    feed_imp(data, size, release, user_data, fed_buffer_tag());
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline void parser<VisitorHolder, ReferencedBufferHook>::feed_imp(
+    const char* data, std::size_t size, void (*release)(void*), void* user_data,
+    detail::fed_buffer_tag<false>)
+{
+    reserve_buffer(size);
+    std::memcpy(buffer(), data, size);
+    buffer_consumed(size);
+    if(release) release(user_data);
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline void parser<VisitorHolder, ReferencedBufferHook>::feed_imp(
+    const char* data, std::size_t size, void (*release)(void*), void* user_data,
+    detail::fed_buffer_tag<true>)
+{
+    if(size == 0) {
+        if(release) release(user_data);
+        return;
+    }
+    detail::feed_chunk* c = new detail::feed_chunk(data, size, release, user_data);
+    try {
+        m_fed.push_back(c);
+    }
+    catch (...) {
+        c->release = MSGPACK_NULLPTR;
+        delete c;
+        throw;
+    }
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline std::size_t parser<VisitorHolder, ReferencedBufferHook>::fed_size() const
+{
+    std::size_t size = 0;
+    for (std::size_t i = 0; i != m_fed.size(); ++i) {
+        size += m_fed[i]->size;
+    }
+    return size - m_fed_off;
+}
+
 template <typename VisitorHolder, typename ReferencedBufferHook>
     inline bool parser<VisitorHolder, ReferencedBufferHook>::next()
 {
@@ -951,6 +1617,31 @@ template <typename VisitorHolder, typename ReferencedBufferHook>
 
 template <typename VisitorHolder, typename ReferencedBufferHook>
 inline parse_return parser<VisitorHolder, ReferencedBufferHook>::execute_imp()
+{
+    return execute_fed_buffers(execute_buffer(), fed_buffer_tag());
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline parse_return parser<VisitorHolder, ReferencedBufferHook>::execute_fed_buffers(
+    parse_return ret, detail::fed_buffer_tag<true>)
+{
+    while(ret == PARSE_CONTINUE && !m_fed.empty()) {
+        if(m_off == m_used) {
+            ret = execute_fed_buffer();
+        }
+        else {
+            // The internal buffer has a part of the value that spans
+            // fed buffers. Copy only the rest of the value.
+            fill_trail();
+            if(m_used - m_off < context_type::trail()) break;
+            ret = execute_buffer();
+        }
+    }
+    return ret;
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline parse_return parser<VisitorHolder, ReferencedBufferHook>::execute_buffer()
 {
     std::size_t off = m_off;
     parse_return ret = context_type::execute(m_buffer, m_used, m_off);
@@ -960,6 +1651,95 @@ inline parse_return parser<VisitorHolder, ReferencedBufferHook>::execute_imp()
     return ret;
 }
 
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline parse_return parser<VisitorHolder, ReferencedBufferHook>::execute_fed_buffer()
+{
+    detail::feed_chunk* c = m_fed.front();
+    VisitorHolder& h = static_cast<VisitorHolder&>(*this);
+    // The referenced flag of the visitor is for the internal buffer.
+    // Track the fed buffer's one separately.
+    bool buffer_referenced = h.referenced();
+    h.set_referenced(false);
+    std::size_t off = m_fed_off;
+    parse_return ret;
+    try {
+        ret = context_type::execute(c->data, c->size, m_fed_off);
+    }
+    catch (...) {
+        if(h.referenced()) c->referenced = true;
+        h.set_referenced(buffer_referenced);
+        throw;
+    }
+    if(h.referenced()) c->referenced = true;
+    h.set_referenced(buffer_referenced);
+    m_parsed += m_fed_off - off;
+
+    if(ret == PARSE_CONTINUE && m_fed_off != c->size) {
+        std::size_t rest = c->size - m_fed_off;
+        reserve_buffer(rest);
+        std::memcpy(buffer(), c->data + m_fed_off, rest);
+        buffer_consumed(rest);
+        m_fed_off = c->size;
+    }
+    if(m_fed_off == c->size) {
+        pop_fed_buffer();
+    }
+    return ret;
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline void parser<VisitorHolder, ReferencedBufferHook>::fill_trail()
+{
+    std::size_t need = context_type::trail() - (m_used - m_off);
+    reserve_buffer(need);
+    while(need != 0 && !m_fed.empty()) {
+        detail::feed_chunk* c = m_fed.front();
+        std::size_t size = c->size - m_fed_off;
+        if(size > need) size = need;
+        std::memcpy(buffer(), c->data + m_fed_off, size);
+        buffer_consumed(size);
+        m_fed_off += size;
+        need -= size;
+        if(m_fed_off == c->size) {
+            pop_fed_buffer();
+        }
+    }
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline void parser<VisitorHolder, ReferencedBufferHook>::pop_fed_buffer()
+{
+    detail::feed_chunk* c = m_fed.front();
+    if(c->referenced) {
+        // The parser's reference is moved to the hook.
+        m_referenced_buffer_hook(&detail::decr_chunk_count, static_cast<void*>(c));
+        m_fed.pop_front();
+    }
+    else {
+        m_fed.pop_front();
+        detail::decr_chunk_count(c);
+    }
+    m_fed_off = 0;
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline bool parser<VisitorHolder, ReferencedBufferHook>::fed_buffer_referenced() const
+{
+    // Only the front buffer can be parsed and referenced.
+    return !m_fed.empty() && m_fed.front()->referenced;
+}
+
+template <typename VisitorHolder, typename ReferencedBufferHook>
+inline void parser<VisitorHolder, ReferencedBufferHook>::flush_fed_buffer()
+{
+    if(fed_buffer_referenced()) {
+        detail::feed_chunk* c = m_fed.front();
+        m_referenced_buffer_hook(&detail::decr_chunk_count, static_cast<void*>(c));
+        c->referenced = false;
+        detail::incr_chunk_count(c);
+    }
+}
+
 template <typename VisitorHolder, typename ReferencedBufferHook>
 inline void parser<VisitorHolder, ReferencedBufferHook>::reset()
 {
@@ -971,7 +1751,7 @@ inline void parser<VisitorHolder, ReferencedBufferHook>::reset()
 template <typename VisitorHolder, typename ReferencedBufferHook>
 inline std::size_t parser<VisitorHolder, ReferencedBufferHook>::message_size() const
 {
-    return m_parsed - m_off + m_used;
+    return m_parsed - m_off + m_used + fed_size();
 }
 
 template <typename VisitorHolder, typename ReferencedBufferHook>
@@ -1016,13 +1796,32 @@ inline bool parse(const char* data, size_t len, Visitor& v) {
     return msgpack::parse(data, len, off, v);
 }
 
+inline parse_return skip(const char* data, size_t len, size_t& off) {
+    if(len <= off) {
+        return PARSE_CONTINUE;
+    }
+    return detail::skip_imp(data, len, off);
+}
+
+inline size_t encoded_size(const char* data, size_t len) {
+    std::size_t off = 0;
+    switch (msgpack::v2::skip(data, len, off)) {
+    case PARSE_CONTINUE:
+        throw msgpack::insufficient_bytes("insufficient bytes");
+    case PARSE_PARSE_ERROR:
+        throw msgpack::parse_error("parse error");
+    default:
+        return off;
+    }
+}
+
 namespace detail {
 
 template <typename Visitor>
 struct parse_helper : detail::context<parse_helper<Visitor> > {
     parse_helper(Visitor& v):m_visitor(v) {}
     parse_return execute(const char* data, std::size_t len, std::size_t& off) {
-        return detail::context<parse_helper<Visitor> >::execute(data, len, off);
+        return detail::context<parse_helper<Visitor> >::execute_complete(data, len, off);
     }
     Visitor& visitor() const { return m_visitor; }
     Visitor& m_visitor;
@@ -58,6 +58,33 @@ bool parse(const char* data, size_t len, size_t& off, Visitor& v);
 template <typename Visitor>
 bool parse(const char* data, size_t len, Visitor& v);
 
+/**
+ * Skip one object without a visitor. Nested arrays and maps are skipped
+ * by counting the remaining objects, so the visitor stack and the
+ * callbacks are not used.
+ *
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param off The offset position of the buffer. It is read and overwritten only if the object is skipped.
+ *
+ * @return PARSE_SUCCESS or PARSE_EXTRA_BYTES if the object is skipped,
+ *         PARSE_CONTINUE if the object is incomplete,
+ *         PARSE_PARSE_ERROR if the data is not msgpack format.
+ *
+ */
+parse_return skip(const char* data, size_t len, size_t& off);
+
+/**
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ *
+ * @return The byte size of the first object of the buffer.
+ *         If the object is incomplete, throw msgpack::insufficient_bytes.
+ *         If the data is not msgpack format, throw msgpack::parse_error.
+ *
+ */
+size_t encoded_size(const char* data, size_t len);
+
 namespace detail {
 
 template <typename Visitor>
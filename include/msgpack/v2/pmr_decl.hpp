@@ -0,0 +1,33 @@
+//
+// MessagePack for C++ std::pmr::memory_resource adapter
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_PMR_DECL_HPP
+#define MSGPACK_V2_PMR_DECL_HPP
+
+#include "msgpack/v1/pmr_decl.hpp"
+
+#if defined(MSGPACK_PMR)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+using v1::zone_memory_resource;
+
+using v1::as;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_PMR)
+
+#endif // MSGPACK_V2_PMR_DECL_HPP
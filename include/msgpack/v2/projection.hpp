@@ -0,0 +1,462 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_PROJECTION_HPP
+#define MSGPACK_V2_PROJECTION_HPP
+
+#if MSGPACK_DEFAULT_API_VERSION >= 2
+
+#include "msgpack/v2/projection_decl.hpp"
+#include "msgpack/object.hpp"
+#include "msgpack/parse.hpp"
+#include "msgpack/create_object_visitor.hpp"
+#include "msgpack/null_visitor.hpp"
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+namespace detail {
+
+const std::size_t projection_npos = static_cast<std::size_t>(-1);
+
+} // namespace detail
+
+/// The compiled set of paths for msgpack::projection_visitor.
+/**
+ * A path is a sequence of map keys and array indexes from the root object
+ * such as `user.id`, `items[*].price` and `[2].name`.
+ * `name` matches the map value whose key is the str `name`, `[N]` matches the
+ * N-th array element, and `[*]` matches all array elements.
+ * The empty path matches the root object.
+ */
+class projection {
+public:
+    projection():m_nodes(1) {}
+
+    /// Add a path.
+    /**
+     * @param path The path to add.
+     *
+     * @return The index of the path that is passed to the handler of msgpack::projection_visitor.
+     *         If the same path is already added, its index is returned.
+     *
+     * If the path is malformed, or `[N]` and `[*]` are used at the same position
+     * of different paths, std::invalid_argument is thrown.
+     */
+    std::size_t add(std::string const& path) {
+        std::size_t n = 0;
+        std::string::size_type i = 0;
+        while (i != path.size()) {
+            if (path[i] == '[') {
+                std::string::size_type close = path.find(']', i);
+                if (close == std::string::npos || close == i + 1) throw std::invalid_argument("invalid path");
+                if (close == i + 2 && path[i + 1] == '*') {
+                    n = add_any(n);
+                }
+                else {
+                    n = add_index(n, parse_index(path, i + 1, close));
+                }
+                i = close + 1;
+            }
+            else {
+                if (i != 0) {
+                    if (path[i] != '.') throw std::invalid_argument("invalid path");
+                    ++i;
+                }
+                std::string::size_type end = path.find_first_of(".[", i);
+                if (end == std::string::npos) end = path.size();
+                if (end == i) throw std::invalid_argument("invalid path");
+                n = add_key(n, path.substr(i, end - i));
+                i = end;
+            }
+        }
+        if (m_nodes[n].leaf == detail::projection_npos) {
+            m_nodes[n].leaf = m_paths.size();
+            m_paths.push_back(path);
+        }
+        return m_nodes[n].leaf;
+    }
+
+    /// Get the number of the paths.
+    std::size_t size() const { return m_paths.size(); }
+
+    /// Get the path that has the index `i`.
+    std::string const& path(std::size_t i) const { return m_paths.at(i); }
+
+private:
+    template <typename Handler>
+    friend class projection_visitor;
+
+    struct node {
+        node():any(detail::projection_npos), leaf(detail::projection_npos) {}
+        std::vector<std::pair<std::string, std::size_t> > keys;
+        std::vector<std::pair<uint32_t, std::size_t> > indexes;
+        std::size_t any;
+        std::size_t leaf;
+    };
+
+    static uint32_t parse_index(std::string const& path, std::string::size_type b, std::string::size_type e) {
+        uint64_t v = 0;
+        for (std::string::size_type i = b; i != e; ++i) {
+            if (path[i] < '0' || path[i] > '9') throw std::invalid_argument("invalid path");
+            v = v * 10 + static_cast<uint64_t>(path[i] - '0');
+            if (v > 0xffffffffU) throw std::invalid_argument("invalid path");
+        }
+        return static_cast<uint32_t>(v);
+    }
+
+    std::size_t add_key(std::size_t n, std::string const& key) {
+        std::size_t c = find_key(n, key.data(), static_cast<uint32_t>(key.size()));
+        if (c != detail::projection_npos) return c;
+        c = m_nodes.size();
+        m_nodes.push_back(node());
+        m_nodes[n].keys.push_back(std::make_pair(key, c));
+        return c;
+    }
+
+    std::size_t add_index(std::size_t n, uint32_t index) {
+        if (m_nodes[n].any != detail::projection_npos) throw std::invalid_argument("invalid path");
+        std::size_t c = find_index(n, index);
+        if (c != detail::projection_npos) return c;
+        c = m_nodes.size();
+        m_nodes.push_back(node());
+        m_nodes[n].indexes.push_back(std::make_pair(index, c));
+        return c;
+    }
+
+    std::size_t add_any(std::size_t n) {
+        if (!m_nodes[n].indexes.empty()) throw std::invalid_argument("invalid path");
+        if (m_nodes[n].any == detail::projection_npos) {
+            std::size_t c = m_nodes.size();
+            m_nodes.push_back(node());
+            m_nodes[n].any = c;
+        }
+        return m_nodes[n].any;
+    }
+
+    std::size_t find_key(std::size_t n, const char* key, uint32_t size) const {
+        std::vector<std::pair<std::string, std::size_t> > const& keys = m_nodes[n].keys;
+        for (std::size_t i = 0; i != keys.size(); ++i) {
+            if (keys[i].first.size() == size && std::memcmp(keys[i].first.data(), key, size) == 0) {
+                return keys[i].second;
+            }
+        }
+        return detail::projection_npos;
+    }
+
+    std::size_t find_index(std::size_t n, uint32_t index) const {
+        node const& nd = m_nodes[n];
+        if (nd.any != detail::projection_npos) return nd.any;
+        for (std::size_t i = 0; i != nd.indexes.size(); ++i) {
+            if (nd.indexes[i].first == index) return nd.indexes[i].second;
+        }
+        return detail::projection_npos;
+    }
+
+    std::vector<node> m_nodes;
+    std::vector<std::string> m_paths;
+};
+
+/// The visitor that creates only the objects matched with msgpack::projection.
+/**
+ * Use it with msgpack::parse(). When an object matches a path, the object
+ * is created in the zone and `handler(path_index, obj)` is called, where
+ * obj is `msgpack::object const&`. If a path is a prefix of another path,
+ * the handler is called for both.
+ *
+ * The other objects are not created. Since C++11, msgpack::parse() skips
+ * them without calling visit functions via skip_value().
+ *
+ * @tparam Handler The function object that is called with the matched objects.
+ */
+template <typename Handler>
+class projection_visitor : public msgpack::v2::null_visitor {
+public:
+    /// Constructor
+    /**
+     * @param p The paths to match. It must outlive the visitor.
+     * @param z The zone that the matched objects are created in.
+     * @param h The handler that is called with the matched objects.
+     * @param f A judging function that msgpack::object refer to the buffer.
+     * @param user_data This parameter is passed to f.
+     * @param limit The size limit information of msgpack::object.
+     */
+    projection_visitor(
+        msgpack::projection const& p,
+        msgpack::zone& z,
+        Handler h,
+        unpack_reference_func f = MSGPACK_NULLPTR,
+        void* user_data = MSGPACK_NULLPTR,
+        unpack_limit const& limit = unpack_limit())
+        :m_projection(p),
+         m_handler(h),
+         m_builder(f, user_data, limit),
+         m_next(0),
+         m_build_node(detail::projection_npos),
+         m_build(0),
+         m_ignore(0),
+         m_in_key(false),
+         m_skip(false) {
+        m_builder.set_zone(z);
+    }
+
+    Handler const& handler() const { return m_handler; }
+    Handler& handler() { return m_handler; }
+
+    // Requests the parser to skip the next value.
+    bool skip_value() const {
+        return m_skip;
+    }
+
+    bool visit_nil() {
+        if (!start_scalar()) return true;
+        return m_builder.visit_nil() && end_scalar();
+    }
+    bool visit_boolean(bool v) {
+        if (!start_scalar()) return true;
+        return m_builder.visit_boolean(v) && end_scalar();
+    }
+    bool visit_positive_integer(uint64_t v) {
+        if (!start_scalar()) return true;
+        return m_builder.visit_positive_integer(v) && end_scalar();
+    }
+    bool visit_negative_integer(int64_t v) {
+        if (!start_scalar()) return true;
+        return m_builder.visit_negative_integer(v) && end_scalar();
+    }
+    bool visit_float32(float v) {
+        if (!start_scalar()) return true;
+        return m_builder.visit_float32(v) && end_scalar();
+    }
+    bool visit_float64(double v) {
+        if (!start_scalar()) return true;
+        return m_builder.visit_float64(v) && end_scalar();
+    }
+    bool visit_str(const char* v, uint32_t size) {
+        if (m_in_key && m_build == 0 && m_ignore == 0) {
+            m_frames.back().matched = m_projection.find_key(m_frames.back().node, v, size);
+            return true;
+        }
+        if (!start_scalar()) return true;
+        return m_builder.visit_str(v, size) && end_scalar();
+    }
+    bool visit_bin(const char* v, uint32_t size) {
+        if (!start_scalar()) return true;
+        return m_builder.visit_bin(v, size) && end_scalar();
+    }
+    bool visit_ext(const char* v, uint32_t size) {
+        if (!start_scalar()) return true;
+        return m_builder.visit_ext(v, size) && end_scalar();
+    }
+    bool start_array(uint32_t num_elements) {
+        if (m_build != 0) {
+            ++m_build;
+            return m_builder.start_array(num_elements);
+        }
+        if (start_ignore()) return true;
+        projection::node const& nd = m_projection.m_nodes[m_next];
+        if (nd.leaf != detail::projection_npos) {
+            start_build();
+            return m_builder.start_array(num_elements);
+        }
+        if (nd.indexes.empty() && nd.any == detail::projection_npos) {
+            m_ignore = 1;
+            return true;
+        }
+        m_frames.push_back(frame(m_next));
+        return true;
+    }
+    bool start_array_item() {
+        if (m_build != 0) return m_builder.start_array_item();
+        if (m_ignore != 0) return true;
+        frame& f = m_frames.back();
+        m_next = m_projection.find_index(f.node, f.index);
+        m_skip = m_next == detail::projection_npos;
+        return true;
+    }
+    bool end_array_item() {
+        if (m_build != 0) return m_builder.end_array_item();
+        if (m_ignore != 0) return true;
+        ++m_frames.back().index;
+        m_skip = false;
+        return true;
+    }
+    bool end_array() {
+        if (m_build != 0) {
+            return m_builder.end_array() && end_container();
+        }
+        return end_container();
+    }
+    bool start_map(uint32_t num_kv_pairs) {
+        if (m_build != 0) {
+            ++m_build;
+            return m_builder.start_map(num_kv_pairs);
+        }
+        if (start_ignore()) return true;
+        projection::node const& nd = m_projection.m_nodes[m_next];
+        if (nd.leaf != detail::projection_npos) {
+            start_build();
+            return m_builder.start_map(num_kv_pairs);
+        }
+        if (nd.keys.empty()) {
+            m_ignore = 1;
+            return true;
+        }
+        m_frames.push_back(frame(m_next));
+        return true;
+    }
+    bool start_map_key() {
+        if (m_build != 0) return m_builder.start_map_key();
+        if (m_ignore != 0) return true;
+        m_frames.back().matched = detail::projection_npos;
+        m_in_key = true;
+        m_skip = false;
+        return true;
+    }
+    bool end_map_key() {
+        if (m_build != 0) return m_builder.end_map_key();
+        if (m_ignore != 0) return true;
+        m_in_key = false;
+        return true;
+    }
+    bool start_map_value() {
+        if (m_build != 0) return m_builder.start_map_value();
+        if (m_ignore != 0) return true;
+        m_next = m_frames.back().matched;
+        m_skip = m_next == detail::projection_npos;
+        return true;
+    }
+    bool end_map_value() {
+        if (m_build != 0) return m_builder.end_map_value();
+        if (m_ignore != 0) return true;
+        m_skip = false;
+        return true;
+    }
+    bool end_map() {
+        if (m_build != 0) {
+            return m_builder.end_map() && end_container();
+        }
+        return end_container();
+    }
+
+private:
+    struct frame {
+        frame() {}
+        frame(std::size_t n):node(n), index(0), matched(detail::projection_npos) {}
+        std::size_t node;
+        uint32_t index;
+        std::size_t matched;
+    };
+
+    // Returns true if the value is not matched. A container is ignored
+    // until its end.
+    bool start_ignore() {
+        if (m_ignore != 0) {
+            ++m_ignore;
+            return true;
+        }
+        if (m_in_key || m_next == detail::projection_npos) {
+            m_ignore = 1;
+            return true;
+        }
+        return false;
+    }
+
+    void start_build() {
+        m_builder.init();
+        m_build_node = m_next;
+        m_build = 1;
+    }
+
+    // Returns true if the scalar value is passed to the builder.
+    bool start_scalar() {
+        if (m_build != 0) return true;
+        if (m_ignore != 0 || m_in_key || m_next == detail::projection_npos) return false;
+        if (m_projection.m_nodes[m_next].leaf == detail::projection_npos) return false;
+        m_builder.init();
+        m_build_node = m_next;
+        return true;
+    }
+
+    bool end_scalar() {
+        if (m_build == 0) emit(m_build_node, m_builder.data());
+        return true;
+    }
+
+    bool end_container() {
+        if (m_build != 0) {
+            if (--m_build == 0) emit(m_build_node, m_builder.data());
+        }
+        else if (m_ignore != 0) {
+            --m_ignore;
+        }
+        else {
+            m_frames.pop_back();
+        }
+        // The root object is finished. Prepare for the next parse.
+        if (m_build == 0 && m_ignore == 0 && m_frames.empty()) m_next = 0;
+        return true;
+    }
+
+    void emit(std::size_t n, msgpack::object const& obj) {
+        projection::node const& nd = m_projection.m_nodes[n];
+        if (nd.leaf != detail::projection_npos) m_handler(nd.leaf, obj);
+        switch (obj.type) {
+        case msgpack::type::MAP:
+            if (nd.keys.empty()) break;
+            for (uint32_t i = 0; i != obj.via.map.size; ++i) {
+                msgpack::object_kv const& kv = obj.via.map.ptr[i];
+                if (kv.key.type != msgpack::type::STR) continue;
+                std::size_t c = m_projection.find_key(n, kv.key.via.str.ptr, kv.key.via.str.size);
+                if (c != detail::projection_npos) emit(c, kv.val);
+            }
+            break;
+        case msgpack::type::ARRAY:
+            if (nd.indexes.empty() && nd.any == detail::projection_npos) break;
+            for (uint32_t i = 0; i != obj.via.array.size; ++i) {
+                std::size_t c = m_projection.find_index(n, i);
+                if (c != detail::projection_npos) emit(c, obj.via.array.ptr[i]);
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    msgpack::projection const& m_projection;
+    Handler m_handler;
+    detail::create_object_visitor m_builder;
+    // The node for the next value. projection_npos if it is not matched.
+    std::size_t m_next;
+    std::size_t m_build_node;
+    // The depth of the container that is being created.
+    uint32_t m_build;
+    // The depth of the container that is being ignored.
+    uint32_t m_ignore;
+    bool m_in_key;
+    bool m_skip;
+    detail::embed_stack<frame> m_frames;
+};
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2
+
+#endif // MSGPACK_V2_PROJECTION_HPP
@@ -0,0 +1,30 @@
+//
+// MessagePack for C++ simple buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_SBUFFER_HPP
+#define MSGPACK_V2_SBUFFER_HPP
+
+#include "msgpack/v2/sbuffer_decl.hpp"
+#include "msgpack/v1/sbuffer.hpp"
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+#if defined(MSGPACK_SBUFFER_MMAP)
+using v1::sbuffer_mmap_allocator;
+#endif // defined(MSGPACK_SBUFFER_MMAP)
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V2_SBUFFER_HPP
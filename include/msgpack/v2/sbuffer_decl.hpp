@@ -22,8 +22,14 @@ namespace msgpack {
 MSGPACK_API_VERSION_NAMESPACE(v2) {
 /// @endcond
 
+using v1::sbuffer_allocator;
+
 using v1::sbuffer;
 
+using v1::sbuffer_malloc_allocator;
+
+using v1::sbuffer_pool_allocator;
+
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v2)
 /// @endcond
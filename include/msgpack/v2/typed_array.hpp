@@ -0,0 +1,392 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_TYPED_ARRAY_HPP
+#define MSGPACK_V2_TYPED_ARRAY_HPP
+
+#include "msgpack/v2/typed_array_decl.hpp"
+#include "msgpack/cpp_config.hpp"
+#include "msgpack/object_fwd.hpp"
+
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MSGPACK_TYPED_ARRAY_SSE2
+#include <emmintrin.h>
+#endif
+
+#if !defined(MSGPACK_USE_CPP03)
+#include <type_traits>
+#endif // !defined(MSGPACK_USE_CPP03)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+namespace detail {
+
+// Visitor can optionally have the following member functions.
+// If the all elements of an array have the same format and the whole
+// array is in the buffer, then the parser calls one of them instead of
+// start_array_item(), visit_xxx() and end_array_item() for each element.
+// start_array() and end_array() are called as usual.
+//
+// bool visit_float64_array(const char* data, uint32_t num_elements);
+// bool visit_float32_array(const char* data, uint32_t num_elements);
+// bool visit_positive_integer_array(const char* data, std::size_t size, uint32_t num_elements);
+//
+// data points to the first element (including its header byte). The
+// elements can be decoded by decode_xxx_array().
+// It requires C++11 or later. On C++03, the member functions are never called.
+
+#if !defined(MSGPACK_USE_CPP03)
+
+struct typed_array_visitor_check {
+    template <typename V>
+    static auto float64(V* v) -> decltype(
+        v->visit_float64_array(static_cast<const char*>(MSGPACK_NULLPTR), uint32_t()),
+        std::true_type());
+    template <typename V>
+    static std::false_type float64(...);
+
+    template <typename V>
+    static auto float32(V* v) -> decltype(
+        v->visit_float32_array(static_cast<const char*>(MSGPACK_NULLPTR), uint32_t()),
+        std::true_type());
+    template <typename V>
+    static std::false_type float32(...);
+
+    template <typename V>
+    static auto positive_integer(V* v) -> decltype(
+        v->visit_positive_integer_array(static_cast<const char*>(MSGPACK_NULLPTR), std::size_t(), uint32_t()),
+        std::true_type());
+    template <typename V>
+    static std::false_type positive_integer(...);
+};
+
+template <typename Visitor>
+struct has_visit_float64_array
+    : decltype(typed_array_visitor_check::float64<Visitor>(MSGPACK_NULLPTR)) {};
+
+template <typename Visitor>
+struct has_visit_float32_array
+    : decltype(typed_array_visitor_check::float32<Visitor>(MSGPACK_NULLPTR)) {};
+
+template <typename Visitor>
+struct has_visit_positive_integer_array
+    : decltype(typed_array_visitor_check::positive_integer<Visitor>(MSGPACK_NULLPTR)) {};
+
+template <typename Visitor>
+struct has_typed_array_visitor
+    : std::integral_constant<
+        bool,
+        has_visit_float64_array<Visitor>::value ||
+        has_visit_float32_array<Visitor>::value ||
+        has_visit_positive_integer_array<Visitor>::value> {};
+
+#else  // !defined(MSGPACK_USE_CPP03)
+
+template <typename Visitor>
+struct has_visit_float64_array {
+    static const bool value = false;
+};
+
+template <typename Visitor>
+struct has_visit_float32_array {
+    static const bool value = false;
+};
+
+template <typename Visitor>
+struct has_visit_positive_integer_array {
+    static const bool value = false;
+};
+
+template <typename Visitor>
+struct has_typed_array_visitor {
+    static const bool value = false;
+};
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+template <typename Visitor, bool = has_visit_float64_array<Visitor>::value>
+struct visit_float64_array_helper {
+    static bool call(Visitor&, const char*, uint32_t) { return true; }
+};
+
+template <typename Visitor>
+struct visit_float64_array_helper<Visitor, true> {
+    static bool call(Visitor& v, const char* data, uint32_t num_elements) {
+        return v.visit_float64_array(data, num_elements);
+    }
+};
+
+template <typename Visitor, bool = has_visit_float32_array<Visitor>::value>
+struct visit_float32_array_helper {
+    static bool call(Visitor&, const char*, uint32_t) { return true; }
+};
+
+template <typename Visitor>
+struct visit_float32_array_helper<Visitor, true> {
+    static bool call(Visitor& v, const char* data, uint32_t num_elements) {
+        return v.visit_float32_array(data, num_elements);
+    }
+};
+
+template <typename Visitor, bool = has_visit_positive_integer_array<Visitor>::value>
+struct visit_positive_integer_array_helper {
+    static bool call(Visitor&, const char*, std::size_t, uint32_t) { return true; }
+};
+
+template <typename Visitor>
+struct visit_positive_integer_array_helper<Visitor, true> {
+    static bool call(Visitor& v, const char* data, std::size_t size, uint32_t num_elements) {
+        return v.visit_positive_integer_array(data, size, num_elements);
+    }
+};
+
+// Return the byte size of the elements if all of them are `header`
+// followed by `stride - 1` bytes, otherwise 0.
+inline std::size_t fixed_stride_array_size(
+    const char* p, const char* pe, uint32_t num_elements, char header, std::size_t stride)
+{
+    if (static_cast<std::size_t>(pe - p) / stride < num_elements) return 0;
+    for (uint32_t i = 0; i != num_elements; ++i, p += stride) {
+        if (*p != header) return 0;
+    }
+    return static_cast<std::size_t>(num_elements) * stride;
+}
+
+// Return the byte size of the elements if all of them are positive
+// fixint or uint 8/16/32/64, otherwise 0.
+inline std::size_t positive_integer_array_size(
+    const char* p, const char* pe, uint32_t num_elements)
+{
+    const char* const s = p;
+    for (uint32_t i = 0; i != num_elements; ++i) {
+        if (p == pe) return 0;
+        unsigned char h = static_cast<unsigned char>(*p);
+        if (h < 0x80) {
+            ++p;
+        }
+        else if (h >= 0xcc && h <= 0xcf) {
+            std::size_t len = 1 + (static_cast<std::size_t>(1) << (h - 0xcc));
+            if (static_cast<std::size_t>(pe - p) < len) return 0;
+            p += len;
+        }
+        else {
+            return 0;
+        }
+    }
+    return static_cast<std::size_t>(p - s);
+}
+
+template <typename Visitor>
+inline std::size_t typed_array_size(Visitor& /*v*/, const char* p, const char* pe, uint32_t num_elements)
+{
+    if (!has_typed_array_visitor<Visitor>::value || p == pe) return 0;
+    switch (static_cast<unsigned char>(*p)) {
+    case 0xcb:
+        if (!has_visit_float64_array<Visitor>::value) return 0;
+        return fixed_stride_array_size(p, pe, num_elements, *p, 9);
+    case 0xca:
+        if (!has_visit_float32_array<Visitor>::value) return 0;
+        return fixed_stride_array_size(p, pe, num_elements, *p, 5);
+    default:
+        if (!has_visit_positive_integer_array<Visitor>::value) return 0;
+        return positive_integer_array_size(p, pe, num_elements);
+    }
+}
+
+template <typename Visitor>
+inline bool visit_typed_array(Visitor& v, const char* p, std::size_t size, uint32_t num_elements)
+{
+    switch (static_cast<unsigned char>(*p)) {
+    case 0xcb:
+        return visit_float64_array_helper<Visitor>::call(v, p, num_elements);
+    case 0xca:
+        return visit_float32_array_helper<Visitor>::call(v, p, num_elements);
+    default:
+        return visit_positive_integer_array_helper<Visitor>::call(v, p, size, num_elements);
+    }
+}
+
+template <typename T, bool = std::numeric_limits<T>::is_integer>
+struct positive_integer_cast {
+    static T call(uint64_t v) {
+        if (v > static_cast<uint64_t>(std::numeric_limits<T>::max())) throw msgpack::type_error();
+        return static_cast<T>(v);
+    }
+};
+
+template <typename T>
+struct positive_integer_cast<T, false> {
+    static T call(uint64_t v) {
+        return static_cast<T>(v);
+    }
+};
+
+#if defined(MSGPACK_TYPED_ARRAY_SSE2)
+
+// Zero extend 16 positive fixints in b to Size bytes each.
+template <std::size_t Size>
+struct widen_fixint_sse2;
+
+template <>
+struct widen_fixint_sse2<2> {
+    static void store(char* out, __m128i b) {
+        __m128i z = _mm_setzero_si128();
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi8(b, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(b, z));
+    }
+};
+
+template <>
+struct widen_fixint_sse2<4> {
+    static void store(char* out, __m128i b) {
+        __m128i z = _mm_setzero_si128();
+        __m128i lo = _mm_unpacklo_epi8(b, z);
+        __m128i hi = _mm_unpackhi_epi8(b, z);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_unpacklo_epi16(lo, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi16(lo, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 32), _mm_unpacklo_epi16(hi, z));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 48), _mm_unpackhi_epi16(hi, z));
+    }
+};
+
+template <>
+struct widen_fixint_sse2<8> {
+    static void store(char* out, __m128i b) {
+        __m128i z = _mm_setzero_si128();
+        __m128i lo = _mm_unpacklo_epi8(b, z);
+        __m128i hi = _mm_unpackhi_epi8(b, z);
+        __m128i w[4] = {
+            _mm_unpacklo_epi16(lo, z),
+            _mm_unpackhi_epi16(lo, z),
+            _mm_unpacklo_epi16(hi, z),
+            _mm_unpackhi_epi16(hi, z)
+        };
+        for (int i = 0; i != 4; ++i) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 32), _mm_unpacklo_epi32(w[i], z));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i * 32 + 16), _mm_unpackhi_epi32(w[i], z));
+        }
+    }
+};
+
+template <typename T,
+          bool = std::numeric_limits<T>::is_integer &&
+                 (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)>
+struct widen_fixint {
+    static uint32_t call(T* /*out*/, const char* /*data*/, uint32_t /*num_elements*/) {
+        return 0;
+    }
+};
+
+template <typename T>
+struct widen_fixint<T, true> {
+    // Return the number of the converted elements.
+    static uint32_t call(T* out, const char* data, uint32_t num_elements) {
+        uint32_t i = 0;
+        for (; num_elements - i >= 16; i += 16) {
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+            widen_fixint_sse2<sizeof(T)>::store(reinterpret_cast<char*>(out + i), b);
+        }
+        return i;
+    }
+};
+
+#else  // defined(MSGPACK_TYPED_ARRAY_SSE2)
+
+template <typename T>
+struct widen_fixint {
+    static uint32_t call(T* /*out*/, const char* /*data*/, uint32_t /*num_elements*/) {
+        return 0;
+    }
+};
+
+#endif // defined(MSGPACK_TYPED_ARRAY_SSE2)
+
+} // namespace detail
+
+inline void decode_float64_array(double* out, const char* data, uint32_t num_elements)
+{
+    // Each element has a header byte, so the payloads are not contiguous.
+    // The loop is compiled to a load and a bswap per element.
+    for (uint32_t i = 0; i != num_elements; ++i, data += 9) {
+        union { uint64_t i; double f; } mem;
+        _msgpack_load64(uint64_t, data + 1, &mem.i);
+#if defined(TARGET_OS_IPHONE)
+        // ok
+#elif defined(__arm__) && !(__ARM_EABI__) // arm-oabi
+        // https://github.com/msgpack/msgpack-perl/pull/1
+        mem.i = (mem.i & 0xFFFFFFFFUL) << 32UL | (mem.i >> 32UL);
+#endif
+        out[i] = mem.f;
+    }
+}
+
+inline void decode_float32_array(float* out, const char* data, uint32_t num_elements)
+{
+    for (uint32_t i = 0; i != num_elements; ++i, data += 5) {
+        union { uint32_t i; float f; } mem;
+        _msgpack_load32(uint32_t, data + 1, &mem.i);
+        out[i] = mem.f;
+    }
+}
+
+template <typename T>
+inline void decode_positive_integer_array(T* out, const char* data, std::size_t size, uint32_t num_elements)
+{
+    if (size == num_elements) {
+        // All elements are positive fixint. They are contiguous bytes.
+        uint32_t i = detail::widen_fixint<T>::call(out, data, num_elements);
+        for (; i != num_elements; ++i) {
+            out[i] = static_cast<T>(static_cast<unsigned char>(data[i]));
+        }
+        return;
+    }
+    for (uint32_t i = 0; i != num_elements; ++i) {
+        uint64_t v;
+        switch (static_cast<unsigned char>(*data)) {
+        case 0xcc: {
+            v = static_cast<unsigned char>(data[1]);
+            data += 2;
+        } break;
+        case 0xcd: {
+            uint16_t tmp;
+            _msgpack_load16(uint16_t, data + 1, &tmp);
+            v = tmp;
+            data += 3;
+        } break;
+        case 0xce: {
+            uint32_t tmp;
+            _msgpack_load32(uint32_t, data + 1, &tmp);
+            v = tmp;
+            data += 5;
+        } break;
+        case 0xcf: {
+            _msgpack_load64(uint64_t, data + 1, &v);
+            data += 9;
+        } break;
+        default:
+            v = static_cast<unsigned char>(*data);
+            ++data;
+            break;
+        }
+        out[i] = detail::positive_integer_cast<T>::call(v);
+    }
+}
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V2_TYPED_ARRAY_HPP
@@ -0,0 +1,80 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_TYPED_ARRAY_DECL_HPP
+#define MSGPACK_V2_TYPED_ARRAY_DECL_HPP
+
+#include "msgpack/versioning.hpp"
+#include "msgpack/sysdep.h"
+
+#include <cstddef>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+/// Decode the elements that are passed to visit_float64_array().
+/**
+ * @param out The destination that has at least `num_elements` elements.
+ * @param data The pointer to the first element. Each element is a float 64 format (0xcb).
+ * @param num_elements The number of elements.
+ *
+ */
+void decode_float64_array(double* out, const char* data, uint32_t num_elements);
+
+/// Decode the elements that are passed to visit_float32_array().
+/**
+ * @param out The destination that has at least `num_elements` elements.
+ * @param data The pointer to the first element. Each element is a float 32 format (0xca).
+ * @param num_elements The number of elements.
+ *
+ */
+void decode_float32_array(float* out, const char* data, uint32_t num_elements);
+
+/// Decode the elements that are passed to visit_positive_integer_array().
+/**
+ * @param out The destination that has at least `num_elements` elements.
+ * @param data The pointer to the first element. Each element is a positive fixint or a uint 8/16/32/64 format.
+ * @param size The byte size of the elements.
+ * @param num_elements The number of elements.
+ *
+ * If an element doesn't fit in T, throw msgpack::type_error.
+ */
+template <typename T>
+void decode_positive_integer_array(T* out, const char* data, std::size_t size, uint32_t num_elements);
+
+namespace detail {
+
+template <typename Visitor>
+struct has_visit_float64_array;
+
+template <typename Visitor>
+struct has_visit_float32_array;
+
+template <typename Visitor>
+struct has_visit_positive_integer_array;
+
+template <typename Visitor>
+struct has_typed_array_visitor;
+
+template <typename Visitor>
+std::size_t typed_array_size(Visitor& v, const char* p, const char* pe, uint32_t num_elements);
+
+template <typename Visitor>
+bool visit_typed_array(Visitor& v, const char* p, std::size_t size, uint32_t num_elements);
+
+} // namespace detail
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V2_TYPED_ARRAY_DECL_HPP
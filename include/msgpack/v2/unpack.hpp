@@ -29,9 +29,21 @@ struct zone_push_finalizer {
     void operator()(char* buffer) {
         m_z->push_finalizer(&detail::decr_count, buffer);
     }
+    void operator()(void (*func)(void*), void* data) {
+        m_z->push_finalizer(func, data);
+    }
     msgpack::zone* m_z;
 };
 
+namespace detail {
+
+template <>
+struct has_fed_buffer_hook<zone_push_finalizer> {
+    static const bool value = true;
+};
+
+} // namespace detail
+
 class unpacker : public parser<unpacker, zone_push_finalizer>,
                  public detail::create_object_visitor {
     typedef parser<unpacker, zone_push_finalizer> parser_t;
@@ -92,7 +104,7 @@ private:
 inline bool unpacker::next(msgpack::object_handle& result, bool& referenced) {
     bool ret = parser_t::next();
     if (ret) {
-        referenced = detail::create_object_visitor::referenced();
+        referenced = detail::create_object_visitor::referenced() || fed_buffer_referenced();
         result.zone().reset( release_zone() );
         result.set(data());
         reset();
@@ -141,6 +153,11 @@ inline bool unpacker::flush_zone()
 
         detail::incr_count(get_raw_buffer());
     }
+    try {
+        flush_fed_buffer();
+    } catch (...) {
+        return false;
+    }
 
     return true;
 }
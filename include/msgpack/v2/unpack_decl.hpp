@@ -63,6 +63,7 @@ using v1::detail::unpack_bin;
 using v1::detail::unpack_ext;
 
 using  v1::detail::unpack_stack;
+using v1::detail::embed_stack;
 
 using v1::detail::init_count;
 using v1::detail::decr_count;
@@ -0,0 +1,174 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_UNPACK_EXACT_HPP
+#define MSGPACK_V2_UNPACK_EXACT_HPP
+
+#if MSGPACK_DEFAULT_API_VERSION >= 2
+
+#include "msgpack/v2/unpack_exact_decl.hpp"
+#include "msgpack/null_visitor.hpp"
+#include "msgpack/parse.hpp"
+#include "msgpack/unpack.hpp"
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+namespace detail {
+
+// The visitor that allocates nothing, and follows the allocations of
+// create_object_visitor from an aligned chunk top. The limits are checked
+// as create_object_visitor does, before the zone is allocated.
+class unpacked_zone_size_visitor : public msgpack::null_visitor {
+public:
+    unpacked_zone_size_visitor(unpack_reference_func f, void* user_data, unpack_limit const& limit)
+        :m_func(f), m_user_data(user_data), m_limit(limit), m_size(0), m_depth(1) {}
+    bool visit_str(const char*, uint32_t size) {
+        if (size > m_limit.str()) throw msgpack::str_size_overflow("str size overflow");
+        copy(msgpack::type::STR, size);
+        return true;
+    }
+    bool visit_bin(const char*, uint32_t size) {
+        if (size > m_limit.bin()) throw msgpack::bin_size_overflow("bin size overflow");
+        copy(msgpack::type::BIN, size);
+        return true;
+    }
+    bool visit_ext(const char*, uint32_t size) {
+        if (size > m_limit.ext()) throw msgpack::ext_size_overflow("ext size overflow");
+        copy(msgpack::type::EXT, size);
+        return true;
+    }
+    bool start_array(uint32_t num_elements) {
+        if (num_elements > m_limit.array()) throw msgpack::array_size_overflow("array size overflow");
+        if (m_depth > m_limit.depth()) throw msgpack::depth_size_overflow("depth size overflow");
+        ++m_depth;
+        if (num_elements != 0) {
+            allocate(sizeof(msgpack::object) * num_elements, MSGPACK_ZONE_ALIGNOF(msgpack::object));
+        }
+        return true;
+    }
+    bool end_array() {
+        --m_depth;
+        return true;
+    }
+    bool start_map(uint32_t num_kv_pairs) {
+        if (num_kv_pairs > m_limit.map()) throw msgpack::map_size_overflow("map size overflow");
+        if (m_depth > m_limit.depth()) throw msgpack::depth_size_overflow("depth size overflow");
+        ++m_depth;
+        if (num_kv_pairs != 0) {
+            allocate(sizeof(msgpack::object_kv) * num_kv_pairs, MSGPACK_ZONE_ALIGNOF(msgpack::object_kv));
+        }
+        return true;
+    }
+    bool end_map() {
+        --m_depth;
+        return true;
+    }
+    void parse_error(size_t /*parsed_offset*/, size_t /*error_offset*/) {
+        throw msgpack::parse_error("parse error");
+    }
+    void insufficient_bytes(size_t /*parsed_offset*/, size_t /*error_offset*/) {
+        throw msgpack::insufficient_bytes("insufficient bytes");
+    }
+    std::size_t size() const {
+        return m_size;
+    }
+private:
+    void copy(msgpack::type::object_type type, uint32_t size) {
+        if (!(m_func && m_func(type, size, m_user_data))) {
+            allocate(size, MSGPACK_ZONE_ALIGNOF(char));
+        }
+    }
+    void allocate(std::size_t size, std::size_t align) {
+        m_size = msgpack::aligned_size(m_size, align) + size;
+    }
+private:
+    unpack_reference_func m_func;
+    void* m_user_data;
+    unpack_limit const& m_limit;
+    std::size_t m_size;
+    std::size_t m_depth;
+};
+
+} // namespace detail
+
+inline std::size_t unpacked_zone_size(
+    const char* data, std::size_t len, std::size_t off,
+    unpack_reference_func f, void* user_data,
+    unpack_limit const& limit)
+{
+    detail::unpacked_zone_size_visitor v(f, user_data, limit);
+    detail::parse_imp(data, len, off, v);
+    return v.size();
+}
+
+inline msgpack::object_handle unpack_exact(
+    const char* data, std::size_t len, std::size_t& off, bool& referenced,
+    unpack_reference_func f, void* user_data,
+    unpack_limit const& limit)
+{
+    std::size_t size = msgpack::v2::unpacked_zone_size(data, len, off, f, user_data, limit);
+    msgpack::object obj;
+    msgpack::unique_ptr<msgpack::zone> z(new msgpack::zone(size));
+    referenced = false;
+    std::size_t noff = off;
+    parse_return ret = detail::unpack_imp(
+        data, len, noff, *z, obj, referenced, f, user_data, limit);
+
+    switch(ret) {
+    case PARSE_SUCCESS:
+        off = noff;
+        return msgpack::object_handle(obj, msgpack::move(z));
+    case PARSE_EXTRA_BYTES:
+        off = noff;
+        return msgpack::object_handle(obj, msgpack::move(z));
+    default:
+        break;
+    }
+    return msgpack::object_handle();
+}
+
+inline msgpack::object_handle unpack_exact(
+    const char* data, std::size_t len, std::size_t& off,
+    unpack_reference_func f, void* user_data,
+    unpack_limit const& limit)
+{
+    bool referenced;
+    return msgpack::v2::unpack_exact(data, len, off, referenced, f, user_data, limit);
+}
+
+inline msgpack::object_handle unpack_exact(
+    const char* data, std::size_t len, bool& referenced,
+    unpack_reference_func f, void* user_data,
+    unpack_limit const& limit)
+{
+    std::size_t off = 0;
+    return msgpack::v2::unpack_exact(data, len, off, referenced, f, user_data, limit);
+}
+
+inline msgpack::object_handle unpack_exact(
+    const char* data, std::size_t len,
+    unpack_reference_func f, void* user_data,
+    unpack_limit const& limit)
+{
+    bool referenced;
+    std::size_t off = 0;
+    return msgpack::v2::unpack_exact(data, len, off, referenced, f, user_data, limit);
+}
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2
+
+#endif // MSGPACK_V2_UNPACK_EXACT_HPP
@@ -0,0 +1,115 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_UNPACK_EXACT_DECL_HPP
+#define MSGPACK_V2_UNPACK_EXACT_DECL_HPP
+
+#include "msgpack/unpack_decl.hpp"
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+/// Compute the zone size that unpacking an object from a buffer requires.
+/**
+ * The buffer is scanned without creating any object. The size contains
+ * the arrays of msgpack::object and msgpack::object_kv, the str, bin and
+ * ext values that are copied, and the padding between them.
+ *
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param off The offset position of the buffer.
+ * @param f A judging function that msgpack::object refer to the buffer.
+ * @param user_data This parameter is passed to f.
+ * @param limit The size limit information of msgpack::object.
+ *
+ * @return The size of the zone chunk that the object fits in.
+ *
+ * The exceptions are the same as msgpack::unpack().
+ */
+std::size_t unpacked_zone_size(
+    const char* data, std::size_t len, std::size_t off = 0,
+    unpack_reference_func f = MSGPACK_NULLPTR, void* user_data = MSGPACK_NULLPTR, unpack_limit const& limit = unpack_limit());
+
+/// Unpack msgpack::object from a buffer into a zone that is allocated at once.
+/**
+ * At first, the zone size is computed by msgpack::unpacked_zone_size().
+ * Then the object is unpacked into a zone whose only chunk has that size,
+ * so the object is contiguous and the zone doesn't allocate any more.
+ * f is called in both passes.
+ *
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param off The offset position of the buffer. It is read and overwritten.
+ * @param referenced If the unpacked object contains reference of the buffer, then set as true, otherwise false.
+ * @param f A judging function that msgpack::object refer to the buffer.
+ * @param user_data This parameter is passed to f.
+ * @param limit The size limit information of msgpack::object.
+ *
+ * @return object_handle that contains unpacked data.
+ *
+ */
+msgpack::object_handle unpack_exact(
+    const char* data, std::size_t len, std::size_t& off, bool& referenced,
+    unpack_reference_func f = MSGPACK_NULLPTR, void* user_data = MSGPACK_NULLPTR, unpack_limit const& limit = unpack_limit());
+
+/// Unpack msgpack::object from a buffer into a zone that is allocated at once.
+/**
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param off The offset position of the buffer. It is read and overwritten.
+ * @param f A judging function that msgpack::object refer to the buffer.
+ * @param user_data This parameter is passed to f.
+ * @param limit The size limit information of msgpack::object.
+ *
+ * @return object_handle that contains unpacked data.
+ *
+ */
+msgpack::object_handle unpack_exact(
+    const char* data, std::size_t len, std::size_t& off,
+    unpack_reference_func f = MSGPACK_NULLPTR, void* user_data = MSGPACK_NULLPTR, unpack_limit const& limit = unpack_limit());
+
+/// Unpack msgpack::object from a buffer into a zone that is allocated at once.
+/**
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param referenced If the unpacked object contains reference of the buffer, then set as true, otherwise false.
+ * @param f A judging function that msgpack::object refer to the buffer.
+ * @param user_data This parameter is passed to f.
+ * @param limit The size limit information of msgpack::object.
+ *
+ * @return object_handle that contains unpacked data.
+ *
+ */
+msgpack::object_handle unpack_exact(
+    const char* data, std::size_t len, bool& referenced,
+    unpack_reference_func f = MSGPACK_NULLPTR, void* user_data = MSGPACK_NULLPTR, unpack_limit const& limit = unpack_limit());
+
+/// Unpack msgpack::object from a buffer into a zone that is allocated at once.
+/**
+ * @param data The pointer to the buffer.
+ * @param len The length of the buffer.
+ * @param f A judging function that msgpack::object refer to the buffer.
+ * @param user_data This parameter is passed to f.
+ * @param limit The size limit information of msgpack::object.
+ *
+ * @return object_handle that contains unpacked data.
+ *
+ */
+msgpack::object_handle unpack_exact(
+    const char* data, std::size_t len,
+    unpack_reference_func f = MSGPACK_NULLPTR, void* user_data = MSGPACK_NULLPTR, unpack_limit const& limit = unpack_limit());
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V2_UNPACK_EXACT_DECL_HPP
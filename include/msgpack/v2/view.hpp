@@ -0,0 +1,457 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V2_VIEW_HPP
+#define MSGPACK_V2_VIEW_HPP
+
+#if MSGPACK_DEFAULT_API_VERSION >= 2
+
+#include "msgpack/v2/view_decl.hpp"
+#include "msgpack/object.hpp"
+#include "msgpack/parse.hpp"
+#include "msgpack/unpack.hpp"
+#include "msgpack/null_visitor.hpp"
+
+#include <cstring>
+#include <string>
+#include <stdexcept>
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v2) {
+/// @endcond
+
+namespace detail {
+
+// Creates msgpack::object from a non container object without a zone.
+// str, bin and ext refer to the buffer.
+struct view_scalar_visitor : msgpack::v2::null_visitor {
+    bool visit_nil() {
+        m_obj.type = msgpack::type::NIL;
+        return true;
+    }
+    bool visit_boolean(bool v) {
+        m_obj.type = msgpack::type::BOOLEAN;
+        m_obj.via.boolean = v;
+        return true;
+    }
+    bool visit_positive_integer(uint64_t v) {
+        m_obj.type = msgpack::type::POSITIVE_INTEGER;
+        m_obj.via.u64 = v;
+        return true;
+    }
+    bool visit_negative_integer(int64_t v) {
+        if(v >= 0) {
+            m_obj.type = msgpack::type::POSITIVE_INTEGER;
+            m_obj.via.u64 = static_cast<uint64_t>(v);
+        }
+        else {
+            m_obj.type = msgpack::type::NEGATIVE_INTEGER;
+            m_obj.via.i64 = v;
+        }
+        return true;
+    }
+    bool visit_float32(float v) {
+        m_obj.type = msgpack::type::FLOAT32;
+        m_obj.via.f64 = v;
+        return true;
+    }
+    bool visit_float64(double v) {
+        m_obj.type = msgpack::type::FLOAT64;
+        m_obj.via.f64 = v;
+        return true;
+    }
+    bool visit_str(const char* v, uint32_t size) {
+        m_obj.type = msgpack::type::STR;
+        m_obj.via.str.ptr = v;
+        m_obj.via.str.size = size;
+        return true;
+    }
+    bool visit_bin(const char* v, uint32_t size) {
+        m_obj.type = msgpack::type::BIN;
+        m_obj.via.bin.ptr = v;
+        m_obj.via.bin.size = size;
+        return true;
+    }
+    bool visit_ext(const char* v, uint32_t size) {
+        m_obj.type = msgpack::type::EXT;
+        m_obj.via.ext.ptr = v;
+        m_obj.via.ext.size = static_cast<uint32_t>(size - 1);
+        return true;
+    }
+    bool start_array(uint32_t /*num_elements*/) {
+        return false;
+    }
+    bool start_map(uint32_t /*num_kv_pairs*/) {
+        return false;
+    }
+    void parse_error(size_t /*parsed_offset*/, size_t /*error_offset*/) {
+        throw msgpack::parse_error("parse error");
+    }
+    void insufficient_bytes(size_t /*parsed_offset*/, size_t /*error_offset*/) {
+        throw msgpack::insufficient_bytes("insufficient bytes");
+    }
+    msgpack::object m_obj;
+};
+
+} // namespace detail
+
+/// Read only view of a serialized object.
+/**
+ * The view refers to the buffer, so the buffer must outlive the view.
+ * Nothing is unpacked until it is accessed. When an element of an array
+ * or a map is accessed, the offsets of the elements are recorded in the
+ * view that is accessed, only as far as needed. The other subtrees are
+ * just skipped.
+ *
+ * If the buffer is not a valid msgpack format, msgpack::parse_error or
+ * msgpack::insufficient_bytes is thrown when it is accessed.
+ *
+ * The const member functions record the offsets too, so a view is not
+ * thread safe even if it is only read. Give each thread its own copy of
+ * the view. The copies can share the buffer.
+ */
+class view {
+public:
+    /// Constructor of an invalid view.
+    view():m_data(MSGPACK_NULLPTR), m_len(0) {}
+
+    /// Constructor
+    /**
+     * @param data The pointer to the first byte of the object.
+     * @param len The length of the buffer. It can be longer than the object.
+     */
+    view(const char* data, std::size_t len):m_data(data), m_len(len) {}
+
+    /// Return false if the view is default constructed or returned by find() and the key is not found.
+    bool valid() const { return m_data != MSGPACK_NULLPTR; }
+
+    /// Get the pointer to the first byte of the object.
+    const char* data() const { return m_data; }
+
+    /// Get the type of the object.
+    /**
+     * The type is the same as the type of the unpacked msgpack::object.
+     */
+    msgpack::type::object_type type() const;
+
+    /// Get the number of elements of an array, key value pairs of a map, or bytes of str, bin and ext.
+    /**
+     * If the object is another type, msgpack::type_error is thrown.
+     */
+    uint32_t size() const;
+
+    /// Get an element of an array.
+    /**
+     * If the object is not an array, msgpack::type_error is thrown.
+     * If index is out of range, std::out_of_range is thrown.
+     */
+    view operator[](std::size_t index) const;
+
+    /// Get a key of a map.
+    view key(std::size_t index) const;
+
+    /// Get a value of a map.
+    view value(std::size_t index) const;
+
+    /// Find the value that has the str key from a map.
+    /**
+     * If the object is not a map, msgpack::type_error is thrown.
+     * @return The value. If the key is not found, the invalid view.
+     */
+    view find(const char* key, std::size_t key_size) const;
+    view find(const char* key) const;
+    view find(std::string const& key) const;
+
+    /// Unpack the object.
+    /**
+     * str, bin and ext of the result refer to the buffer.
+     */
+    msgpack::object to_object(msgpack::zone& z) const;
+
+    /// Get value as T
+    /**
+     * If the object can't be converted to T, msgpack::type_error would be thrown.
+     * Only arrays and maps use a zone to unpack.
+     */
+    template <typename T>
+    T as() const;
+
+    /// Convert the object
+    template <typename T>
+    T& convert(T& v) const;
+
+private:
+    static bool reference_func(msgpack::type::object_type /*type*/, std::size_t /*len*/, void*) {
+        return true;
+    }
+    std::size_t load_header(uint32_t& size) const;
+    std::size_t skip(std::size_t off) const;
+    view item(std::size_t index) const;
+    view map_item(std::size_t index) const;
+    bool is_str(const char* str, std::size_t str_size) const;
+    msgpack::object scalar_object() const;
+
+    const char* m_data;
+    std::size_t m_len;
+    // Offsets of the elements that are already found. For a map, keys and
+    // values are stored alternately. The last one is the end of the
+    // last found element. It is updated by the const accessors.
+    mutable v1::detail::embed_stack<std::size_t, 16> m_index;
+};
+
+inline msgpack::type::object_type view::type() const
+{
+    if (m_len == 0) throw msgpack::insufficient_bytes("insufficient bytes");
+    detail::header_info const& hi = detail::header_table()[*reinterpret_cast<const unsigned char*>(m_data)];
+    switch(hi.kind) {
+    case detail::header_info::positive_fixint:
+        return msgpack::type::POSITIVE_INTEGER;
+    case detail::header_info::negative_fixint:
+        return msgpack::type::NEGATIVE_INTEGER;
+    case detail::header_info::fixstr:
+        return msgpack::type::STR;
+    case detail::header_info::fixarray:
+        return msgpack::type::ARRAY;
+    case detail::header_info::fixmap:
+        return msgpack::type::MAP;
+    case detail::header_info::nil:
+        return msgpack::type::NIL;
+    case detail::header_info::boolean_false:
+    case detail::header_info::boolean_true:
+        return msgpack::type::BOOLEAN;
+    case MSGPACK_CS_FLOAT:
+        return msgpack::type::FLOAT32;
+    case MSGPACK_CS_DOUBLE:
+        return msgpack::type::FLOAT64;
+    case MSGPACK_CS_UINT_8:
+    case MSGPACK_CS_UINT_16:
+    case MSGPACK_CS_UINT_32:
+    case MSGPACK_CS_UINT_64:
+        return msgpack::type::POSITIVE_INTEGER;
+    case MSGPACK_CS_INT_8:
+    case MSGPACK_CS_INT_16:
+    case MSGPACK_CS_INT_32:
+    case MSGPACK_CS_INT_64:
+        // The sign bit is the most significant bit of the first trail byte.
+        if (m_len < 2) throw msgpack::insufficient_bytes("insufficient bytes");
+        return static_cast<signed char>(m_data[1]) < 0 ? msgpack::type::NEGATIVE_INTEGER : msgpack::type::POSITIVE_INTEGER;
+    case MSGPACK_CS_STR_8:
+    case MSGPACK_CS_STR_16:
+    case MSGPACK_CS_STR_32:
+        return msgpack::type::STR;
+    case MSGPACK_CS_BIN_8:
+    case MSGPACK_CS_BIN_16:
+    case MSGPACK_CS_BIN_32:
+        return msgpack::type::BIN;
+    case MSGPACK_CS_EXT_8:
+    case MSGPACK_CS_EXT_16:
+    case MSGPACK_CS_EXT_32:
+    case MSGPACK_CS_FIXEXT_1:
+    case MSGPACK_CS_FIXEXT_2:
+    case MSGPACK_CS_FIXEXT_4:
+    case MSGPACK_CS_FIXEXT_8:
+    case MSGPACK_CS_FIXEXT_16:
+        return msgpack::type::EXT;
+    case MSGPACK_CS_ARRAY_16:
+    case MSGPACK_CS_ARRAY_32:
+        return msgpack::type::ARRAY;
+    case MSGPACK_CS_MAP_16:
+    case MSGPACK_CS_MAP_32:
+        return msgpack::type::MAP;
+    default:
+        throw msgpack::parse_error("parse error");
+    }
+}
+
+// Return the byte size of the header. The size field is set to size.
+inline std::size_t view::load_header(uint32_t& size) const
+{
+    if (m_len == 0) throw msgpack::insufficient_bytes("insufficient bytes");
+    unsigned char h = *reinterpret_cast<const unsigned char*>(m_data);
+    detail::header_info const& hi = detail::header_table()[h];
+    switch(hi.kind) {
+    case detail::header_info::fixstr:
+        size = h & 0x1f;
+        return 1;
+    case detail::header_info::fixarray:
+    case detail::header_info::fixmap:
+        size = h & 0x0f;
+        return 1;
+    case MSGPACK_CS_FIXEXT_1:
+    case MSGPACK_CS_FIXEXT_2:
+    case MSGPACK_CS_FIXEXT_4:
+    case MSGPACK_CS_FIXEXT_8:
+    case MSGPACK_CS_FIXEXT_16:
+        // the trail includes the type byte
+        size = static_cast<uint32_t>(hi.trail - 1);
+        return 1;
+    case MSGPACK_CS_STR_8:
+    case MSGPACK_CS_STR_16:
+    case MSGPACK_CS_STR_32:
+    case MSGPACK_CS_BIN_8:
+    case MSGPACK_CS_BIN_16:
+    case MSGPACK_CS_BIN_32:
+    case MSGPACK_CS_EXT_8:
+    case MSGPACK_CS_EXT_16:
+    case MSGPACK_CS_EXT_32:
+    case MSGPACK_CS_ARRAY_16:
+    case MSGPACK_CS_ARRAY_32:
+    case MSGPACK_CS_MAP_16:
+    case MSGPACK_CS_MAP_32:
+        if (m_len <= hi.trail) throw msgpack::insufficient_bytes("insufficient bytes");
+        size = detail::load_size(hi.trail, m_data + 1);
+        return static_cast<std::size_t>(hi.trail) + 1;
+    case detail::header_info::never_used:
+        throw msgpack::parse_error("parse error");
+    default:
+        throw msgpack::type_error();
+    }
+}
+
+inline uint32_t view::size() const
+{
+    uint32_t size;
+    load_header(size);
+    return size;
+}
+
+inline std::size_t view::skip(std::size_t off) const
+{
+    switch (msgpack::v2::skip(m_data, m_len, off)) {
+    case PARSE_CONTINUE:
+        throw msgpack::insufficient_bytes("insufficient bytes");
+    case PARSE_PARSE_ERROR:
+        throw msgpack::parse_error("parse error");
+    default:
+        return off;
+    }
+}
+
+inline view view::item(std::size_t index) const
+{
+    if (m_index.empty()) {
+        uint32_t size;
+        m_index.push_back(load_header(size));
+    }
+    while (m_index.size() <= index + 1) {
+        m_index.push_back(skip(m_index.back()));
+    }
+    return view(m_data + m_index[index], m_index[index + 1] - m_index[index]);
+}
+
+inline view view::operator[](std::size_t index) const
+{
+    if (type() != msgpack::type::ARRAY) throw msgpack::type_error();
+    if (index >= size()) throw std::out_of_range("view index out of range");
+    return item(index);
+}
+
+inline view view::map_item(std::size_t index) const
+{
+    if (type() != msgpack::type::MAP) throw msgpack::type_error();
+    if (index >= static_cast<std::size_t>(size()) * 2) throw std::out_of_range("view index out of range");
+    return item(index);
+}
+
+inline view view::key(std::size_t index) const
+{
+    return map_item(index * 2);
+}
+
+inline view view::value(std::size_t index) const
+{
+    return map_item(index * 2 + 1);
+}
+
+inline bool view::is_str(const char* str, std::size_t str_size) const
+{
+    if (type() != msgpack::type::STR) return false;
+    uint32_t size;
+    std::size_t header_size = load_header(size);
+    return size == str_size && std::memcmp(m_data + header_size, str, str_size) == 0;
+}
+
+inline view view::find(const char* key, std::size_t key_size) const
+{
+    if (type() != msgpack::type::MAP) throw msgpack::type_error();
+    std::size_t num_items = static_cast<std::size_t>(size()) * 2;
+    for (std::size_t i = 0; i != num_items; i += 2) {
+        if (item(i).is_str(key, key_size)) return item(i + 1);
+    }
+    return view();
+}
+
+inline view view::find(const char* key) const
+{
+    return find(key, std::strlen(key));
+}
+
+inline view view::find(std::string const& key) const
+{
+    return find(key.data(), key.size());
+}
+
+inline msgpack::object view::scalar_object() const
+{
+    detail::view_scalar_visitor v;
+    std::size_t off = 0;
+    msgpack::v2::parse(m_data, m_len, off, v);
+    return v.m_obj;
+}
+
+inline msgpack::object view::to_object(msgpack::zone& z) const
+{
+    switch (type()) {
+    case msgpack::type::ARRAY:
+    case msgpack::type::MAP: {
+        std::size_t off = 0;
+        return msgpack::v2::unpack(z, m_data, m_len, off, &view::reference_func);
+    }
+    default:
+        return scalar_object();
+    }
+}
+
+template <typename T>
+inline T view::as() const
+{
+    switch (type()) {
+    case msgpack::type::ARRAY:
+    case msgpack::type::MAP: {
+        msgpack::zone z;
+        return to_object(z).as<T>();
+    }
+    default:
+        return scalar_object().as<T>();
+    }
+}
+
+template <typename T>
+inline T& view::convert(T& v) const
+{
+    switch (type()) {
+    case msgpack::type::ARRAY:
+    case msgpack::type::MAP: {
+        msgpack::zone z;
+        return to_object(z).convert(v);
+    }
+    default:
+        return scalar_object().convert(v);
+    }
+}
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v2)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2
+
+#endif // MSGPACK_V2_VIEW_HPP
@@ -39,6 +39,7 @@ using v2::remove_volatile;
 using v2::remove_cv;
 
 using v2::is_pointer;
+using v2::is_trivially_destructible;
 
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v3)
@@ -72,6 +73,7 @@ using v2::remove_volatile;
 using v2::remove_cv;
 
 using v2::is_pointer;
+using v2::is_trivially_destructible;
 
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v3)
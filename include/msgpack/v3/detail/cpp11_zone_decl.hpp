@@ -19,6 +19,14 @@ MSGPACK_API_VERSION_NAMESPACE(v3) {
 /// @endcond
 
 using v2::zone;
+using v2::inline_zone;
+using v2::zone_allocator;
+using v2::zone_stats;
+
+using v2::zone_growth;
+using v2::ZONE_GROWTH_FIXED;
+using v2::ZONE_GROWTH_GEOMETRIC;
+using v2::ZONE_GROWTH_CAPPED_GEOMETRIC;
 
 using v2::aligned_size;
 
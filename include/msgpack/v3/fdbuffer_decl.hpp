@@ -0,0 +1,37 @@
+//
+// MessagePack for C++ file descriptor buffer implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V3_FDBUFFER_DECL_HPP
+#define MSGPACK_V3_FDBUFFER_DECL_HPP
+
+#include "msgpack/v2/fdbuffer_decl.hpp"
+
+#if defined(MSGPACK_FDBUFFER)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v3) {
+/// @endcond
+
+using v2::fdbuffer_flags;
+using v2::FDBUFFER_DEFAULT;
+using v2::FDBUFFER_FDATASYNC;
+using v2::FDBUFFER_FADVISE_DONTNEED;
+using v2::FDBUFFER_BACKGROUND;
+
+using v2::fdbuffer;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v3)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_FDBUFFER)
+
+#endif // MSGPACK_V3_FDBUFFER_DECL_HPP
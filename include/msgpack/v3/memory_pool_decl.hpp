@@ -0,0 +1,29 @@
+//
+// MessagePack for C++ memory pool
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V3_MEMORY_POOL_DECL_HPP
+#define MSGPACK_V3_MEMORY_POOL_DECL_HPP
+
+#include "msgpack/v2/memory_pool_decl.hpp"
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v3) {
+/// @endcond
+
+using v2::memory_pool_stats;
+
+using v2::memory_pool;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v3)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V3_MEMORY_POOL_DECL_HPP
@@ -0,0 +1,31 @@
+//
+// MessagePack for C++ memory mapped file unpacker
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V3_MMAP_UNPACKER_DECL_HPP
+#define MSGPACK_V3_MMAP_UNPACKER_DECL_HPP
+
+#include "msgpack/v2/mmap_unpacker_decl.hpp"
+
+#if defined(MSGPACK_MMAP_UNPACKER)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v3) {
+/// @endcond
+
+using v2::mmap_unpacker;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v3)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_MMAP_UNPACKER)
+
+#endif // MSGPACK_V3_MMAP_UNPACKER_DECL_HPP
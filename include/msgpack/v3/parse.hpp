@@ -15,6 +15,7 @@
 #include <cstddef>
 
 #include "msgpack/parse_return.hpp"
+#include "msgpack/v2/parse.hpp"
 
 namespace msgpack {
 
@@ -24,6 +25,9 @@ MSGPACK_API_VERSION_NAMESPACE(v3) {
 
 namespace detail {
 
+using v2::detail::header_info;
+using v2::detail::header_table;
+
 template <typename VisitorHolder>
 class context {
 public:
@@ -42,13 +46,17 @@ public:
 
     parse_return execute(const char* data, std::size_t len, std::size_t& off);
 
-private:
-    template <typename T>
-    static uint32_t next_cs(T p)
-    {
-        return static_cast<uint32_t>(*p) & 0x1f;
+    // The buffer must contain the whole message. Unlike execute(), the
+    // parsing is not resumable and m_cs and m_trail are not used.
+    // If the message is incomplete, PARSE_CONTINUE is returned and the
+    // parsing needs to be restarted from the beginning.
+    parse_return execute_complete(const char* data, std::size_t len, std::size_t& off) {
+        return v2::detail::complete_parser<context>::execute(*this, data, len, off);
     }
 
+private:
+    friend struct v2::detail::complete_parser<context>;
+
     VisitorHolder& holder() {
         return static_cast<VisitorHolder&>(*this);
     }
@@ -144,13 +152,11 @@ private:
 
     struct unpack_stack {
         struct stack_elem {
+            stack_elem() {}
             stack_elem(msgpack_container_type type, uint32_t rest):m_type(type), m_rest(rest) {}
             msgpack_container_type m_type;
             uint32_t m_rest;
         };
-        unpack_stack() {
-            m_stack.reserve(MSGPACK_EMBED_STACK_SIZE);
-        }
         parse_return push(VisitorHolder& visitor_holder, msgpack_container_type type, uint32_t rest) {
             m_stack.push_back(stack_elem(type, rest));
             switch (type) {
@@ -219,7 +225,7 @@ private:
         bool empty() const { return m_stack.empty(); }
         void clear() { m_stack.clear(); }
     private:
-        std::vector<stack_elem> m_stack;
+        embed_stack<stack_elem> m_stack;
     };
 
     char const* m_start;
@@ -258,52 +264,21 @@ inline parse_return context<VisitorHolder>::execute(const char* data, std::size_
     do {
         if (m_cs == MSGPACK_CS_HEADER) {
             fixed_trail_again = false;
-            int selector = *reinterpret_cast<const unsigned char*>(m_current);
-            if (0x00 <= selector && selector <= 0x7f) { // Positive Fixnum
+            header_info const& hi = header_table()[*reinterpret_cast<const unsigned char*>(m_current)];
+            switch(hi.kind) {
+            case header_info::positive_fixint: {
                 uint8_t tmp = *reinterpret_cast<const uint8_t*>(m_current);
                 bool visret = holder().visitor().visit_positive_integer(tmp);
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else if(0xe0 <= selector && selector <= 0xff) { // Negative Fixnum
+            } break;
+            case header_info::negative_fixint: {
                 int8_t tmp = *reinterpret_cast<const int8_t*>(m_current);
                 bool visret = holder().visitor().visit_negative_integer(tmp);
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else if (0xc4 <= selector && selector <= 0xdf) {
-                const uint32_t trail[] = {
-                    1, // bin     8  0xc4
-                    2, // bin    16  0xc5
-                    4, // bin    32  0xc6
-                    1, // ext     8  0xc7
-                    2, // ext    16  0xc8
-                    4, // ext    32  0xc9
-                    4, // float  32  0xca
-                    8, // float  64  0xcb
-                    1, // uint    8  0xcc
-                    2, // uint   16  0xcd
-                    4, // uint   32  0xce
-                    8, // uint   64  0xcf
-                    1, // int     8  0xd0
-                    2, // int    16  0xd1
-                    4, // int    32  0xd2
-                    8, // int    64  0xd3
-                    2, // fixext  1  0xd4
-                    3, // fixext  2  0xd5
-                    5, // fixext  4  0xd6
-                    9, // fixext  8  0xd7
-                    17,// fixext 16  0xd8
-                    1, // str     8  0xd9
-                    2, // str    16  0xda
-                    4, // str    32  0xdb
-                    2, // array  16  0xdc
-                    4, // array  32  0xdd
-                    2, // map    16  0xde
-                    4, // map    32  0xdf
-                };
-                m_trail = trail[selector - 0xc4];
-                m_cs = next_cs(m_current);
-                fixed_trail_again = true;
-            } else if(0xa0 <= selector && selector <= 0xbf) { // FixStr
+            } break;
+            case header_info::fixstr: {
                 m_trail = static_cast<uint32_t>(*m_current) & 0x1f;
                 if(m_trail == 0) {
                     bool visret = holder().visitor().visit_str(n, static_cast<uint32_t>(m_trail));
@@ -314,29 +289,41 @@ inline parse_return context<VisitorHolder>::execute(const char* data, std::size_
                     m_cs = MSGPACK_ACS_STR_VALUE;
                     fixed_trail_again = true;
                 }
-            } else if(0x90 <= selector && selector <= 0x9f) { // FixArray
+            } break;
+            case header_info::fixarray: {
                 parse_return ret = start_aggregate<fix_tag>(array_sv(holder()), array_ev(holder()), m_current, off);
                 if (ret != PARSE_CONTINUE) return ret;
-            } else if(0x80 <= selector && selector <= 0x8f) { // FixMap
+            } break;
+            case header_info::fixmap: {
                 parse_return ret = start_aggregate<fix_tag>(map_sv(holder()), map_ev(holder()), m_current, off);
                 if (ret != PARSE_CONTINUE) return ret;
-            } else if(selector == 0xc2) { // false
-                bool visret = holder().visitor().visit_boolean(false);
+            } break;
+            case header_info::nil: {
+                bool visret = holder().visitor().visit_nil();
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else if(selector == 0xc3) { // true
-                bool visret = holder().visitor().visit_boolean(true);
+            } break;
+            case header_info::boolean_false: {
+                bool visret = holder().visitor().visit_boolean(false);
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else if(selector == 0xc0) { // nil
-                bool visret = holder().visitor().visit_nil();
+            } break;
+            case header_info::boolean_true: {
+                bool visret = holder().visitor().visit_boolean(true);
                 parse_return upr = after_visit_proc(visret, off);
                 if (upr != PARSE_CONTINUE) return upr;
-            } else {
+            } break;
+            case header_info::never_used: {
                 off = static_cast<std::size_t>(m_current - m_start);
                 holder().visitor().parse_error(off - 1, off);
                 return PARSE_PARSE_ERROR;
             }
+            default: // fixed size trail
+                m_trail = hi.trail;
+                m_cs = hi.kind;
+                fixed_trail_again = true;
+                break;
+            }
             // end MSGPACK_CS_HEADER
         }
         if (m_cs != MSGPACK_CS_HEADER || fixed_trail_again) {
@@ -630,7 +617,7 @@ template <typename Visitor>
 struct parse_helper : detail::context<parse_helper<Visitor> > {
     parse_helper(Visitor& v):m_visitor(v) {}
     parse_return execute(const char* data, std::size_t len, std::size_t& off) {
-        return detail::context<parse_helper<Visitor> >::execute(data, len, off);
+        return detail::context<parse_helper<Visitor> >::execute_complete(data, len, off);
     }
     Visitor& visitor() const { return m_visitor; }
     Visitor& m_visitor;
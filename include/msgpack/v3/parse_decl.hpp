@@ -27,6 +27,8 @@ class context;
 
 using v2::parser;
 using v2::parse;
+using v2::skip;
+using v2::encoded_size;
 
 namespace detail {
 
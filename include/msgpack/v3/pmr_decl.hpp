@@ -0,0 +1,33 @@
+//
+// MessagePack for C++ std::pmr::memory_resource adapter
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V3_PMR_DECL_HPP
+#define MSGPACK_V3_PMR_DECL_HPP
+
+#include "msgpack/v2/pmr_decl.hpp"
+
+#if defined(MSGPACK_PMR)
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v3) {
+/// @endcond
+
+using v2::zone_memory_resource;
+
+using v2::as;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v3)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // defined(MSGPACK_PMR)
+
+#endif // MSGPACK_V3_PMR_DECL_HPP
@@ -22,8 +22,14 @@ namespace msgpack {
 MSGPACK_API_VERSION_NAMESPACE(v3) {
 /// @endcond
 
+using v2::sbuffer_allocator;
+
 using v2::sbuffer;
 
+using v2::sbuffer_malloc_allocator;
+
+using v2::sbuffer_pool_allocator;
+
 /// @cond
 }  // MSGPACK_API_VERSION_NAMESPACE(v3)
 /// @endcond
@@ -0,0 +1,40 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V3_TYPED_ARRAY_DECL_HPP
+#define MSGPACK_V3_TYPED_ARRAY_DECL_HPP
+
+#include "msgpack/v2/typed_array_decl.hpp"
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v3) {
+/// @endcond
+
+using v2::decode_float64_array;
+using v2::decode_float32_array;
+using v2::decode_positive_integer_array;
+
+namespace detail {
+
+using v2::detail::has_visit_float64_array;
+using v2::detail::has_visit_float32_array;
+using v2::detail::has_visit_positive_integer_array;
+using v2::detail::has_typed_array_visitor;
+using v2::detail::typed_array_size;
+using v2::detail::visit_typed_array;
+
+} // namespace detail
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v3)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V3_TYPED_ARRAY_DECL_HPP
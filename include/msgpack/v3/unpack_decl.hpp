@@ -63,6 +63,7 @@ using v2::detail::unpack_bin;
 using v2::detail::unpack_ext;
 
 using  v2::detail::unpack_stack;
+using v2::detail::embed_stack;
 
 using v2::detail::init_count;
 using v2::detail::decr_count;
@@ -0,0 +1,28 @@
+//
+// MessagePack for C++ deserializing routine
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_V3_UNPACK_EXACT_DECL_HPP
+#define MSGPACK_V3_UNPACK_EXACT_DECL_HPP
+
+#include "msgpack/v2/unpack_exact_decl.hpp"
+
+namespace msgpack {
+
+/// @cond
+MSGPACK_API_VERSION_NAMESPACE(v3) {
+/// @endcond
+
+using v2::unpacked_zone_size;
+using v2::unpack_exact;
+
+/// @cond
+}  // MSGPACK_API_VERSION_NAMESPACE(v3)
+/// @endcond
+
+}  // namespace msgpack
+
+#endif // MSGPACK_V3_UNPACK_EXACT_DECL_HPP
@@ -15,6 +15,8 @@
 
 #if defined(unix) || defined(__unix) || defined(__linux__) || defined(__APPLE__) || defined(__OpenBSD__) || defined(__NetBSD__) || defined(__QNX__) || defined(__QNXTO__) || defined(__HAIKU__)
 #include <sys/uio.h>
+#include <sys/types.h>
+#define MSGPACK_VREFBUFFER_WRITEV
 #else
 struct iovec {
     void  *iov_base;
@@ -90,6 +92,25 @@ int msgpack_vrefbuffer_migrate(msgpack_vrefbuffer* vbuf, msgpack_vrefbuffer* to)
 MSGPACK_DLLEXPORT
 void msgpack_vrefbuffer_clear(msgpack_vrefbuffer* vref);
 
+/**
+ * Marks the first len bytes of msgpack_vrefbuffer_vec() as sent.
+ * The chunks that are no longer referred to are released, and the
+ * buffer is cleared when everything is sent.
+ * len must not exceed the total length of msgpack_vrefbuffer_vec().
+ */
+MSGPACK_DLLEXPORT
+void msgpack_vrefbuffer_consume(msgpack_vrefbuffer* vref, size_t len);
+
+#if defined(MSGPACK_VREFBUFFER_WRITEV)
+/**
+ * Writes msgpack_vrefbuffer_vec() to fd by writev() until everything
+ * is sent or fd would block, and consumes the written bytes.
+ * Returns the number of bytes written, or -1 if writev() fails.
+ */
+MSGPACK_DLLEXPORT
+ssize_t msgpack_vrefbuffer_write_to_fd(msgpack_vrefbuffer* vref, int fd);
+#endif /* MSGPACK_VREFBUFFER_WRITEV */
+
 /** @} */
 
 
@@ -55,6 +55,15 @@ typedef struct msgpack_zone {
 
 MSGPACK_DLLEXPORT
 bool msgpack_zone_init(msgpack_zone* zone, size_t chunk_size);
+/**
+ * Initializes the zone whose first chunk is the buffer supplied by the caller.
+ * The allocations are served from the buffer until it is exhausted, and then
+ * from chunks of chunk_size bytes on the heap. The buffer is not freed by the
+ * zone, and it must outlive the zone. If the buffer is too small to hold the
+ * chunk header, the first chunk is allocated on the heap.
+ */
+MSGPACK_DLLEXPORT
+bool msgpack_zone_init_buffer(msgpack_zone* zone, void* buffer, size_t size, size_t chunk_size);
 MSGPACK_DLLEXPORT
 void msgpack_zone_destroy(msgpack_zone* zone);
 
@@ -0,0 +1,15 @@
+//
+// MessagePack for C++ inflating unpacker implementation
+//
+//    Distributed under the Boost Software License, Version 1.0.
+//    (See accompanying file LICENSE_1_0.txt or copy at
+//    http://www.boost.org/LICENSE_1_0.txt)
+//
+#ifndef MSGPACK_ZUNPACKER_HPP
+#define MSGPACK_ZUNPACKER_HPP
+
+#include "msgpack/zunpacker_decl.hpp"
+
+#include "msgpack/v1/zunpacker.hpp"
+
+#endif // MSGPACK_ZUNPACKER_HPP
@@ -3,6 +3,7 @@
 c_headers=(
     include/msgpack.h
     include/msgpack/gcc_atomic.h
+    include/msgpack/memory_pool.h
     include/msgpack/pack.h
     include/msgpack/pack_define.h
     include/msgpack/pack_template.h
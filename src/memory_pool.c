@@ -0,0 +1,206 @@
+/*
+ * MessagePack for C memory pool
+ *
+ *    Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *    http://www.boost.org/LICENSE_1_0.txt)
+ */
+#include "msgpack/memory_pool.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(MSGPACK_MEMORY_POOL_USE_PTHREAD)
+#include <pthread.h>
+#endif /* defined(MSGPACK_MEMORY_POOL_USE_PTHREAD) */
+
+#if defined(_MSC_VER)
+#define MSGPACK_THREAD_LOCAL __declspec(thread)
+#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L
+#define MSGPACK_THREAD_LOCAL _Thread_local
+#elif defined(__GNUC__)
+#define MSGPACK_THREAD_LOCAL __thread
+#endif
+
+static size_t memory_pool_class(size_t size)
+{
+    size_t index = 0;
+    size_t block = MSGPACK_MEMORY_POOL_MIN_SIZE;
+    while(block < size) {
+        block *= 2;
+        ++index;
+    }
+    return index;
+}
+
+size_t msgpack_memory_pool_block_size(size_t size)
+{
+    if(size > MSGPACK_MEMORY_POOL_MAX_SIZE) {
+        return size;
+    }
+    return (size_t)MSGPACK_MEMORY_POOL_MIN_SIZE << memory_pool_class(size);
+}
+
+#if defined(MSGPACK_THREAD_LOCAL)
+
+/* enough for 2^63 bytes */
+#define MSGPACK_MEMORY_POOL_CLASSES 64
+
+/* The pooled blocks of a size class are linked through their first bytes. */
+typedef struct memory_pool_block {
+    struct memory_pool_block* next;
+} memory_pool_block;
+
+typedef struct memory_pool_state {
+    bool enabled;
+    size_t max_blocks;
+    memory_pool_block* heads[MSGPACK_MEMORY_POOL_CLASSES];
+    size_t counts[MSGPACK_MEMORY_POOL_CLASSES];
+    msgpack_memory_pool_stats stats;
+} memory_pool_state;
+
+static MSGPACK_THREAD_LOCAL memory_pool_state s_pool;
+
+static void memory_pool_release(memory_pool_state* pool)
+{
+    size_t i;
+    pool->enabled = false;
+    for(i = 0; i != MSGPACK_MEMORY_POOL_CLASSES; ++i) {
+        memory_pool_block* b = pool->heads[i];
+        while(b != NULL) {
+            memory_pool_block* n = b->next;
+            free(b);
+            b = n;
+        }
+        pool->heads[i] = NULL;
+        pool->counts[i] = 0;
+    }
+}
+
+#if defined(MSGPACK_MEMORY_POOL_USE_PTHREAD)
+
+static pthread_key_t s_key;
+static pthread_once_t s_key_once = PTHREAD_ONCE_INIT;
+static bool s_key_created;
+
+/* Called at the exit of a thread that enabled the pool. The thread local
+ * storage of the thread is still valid here. */
+static void memory_pool_thread_exit(void* pool)
+{
+    memory_pool_release((memory_pool_state*)pool);
+}
+
+static void memory_pool_create_key(void)
+{
+    s_key_created = pthread_key_create(&s_key, memory_pool_thread_exit) == 0;
+}
+
+#endif /* defined(MSGPACK_MEMORY_POOL_USE_PTHREAD) */
+
+bool msgpack_memory_pool_enable(size_t max_blocks)
+{
+#if defined(MSGPACK_MEMORY_POOL_USE_PTHREAD)
+    pthread_once(&s_key_once, memory_pool_create_key);
+    if(!s_key_created || pthread_setspecific(s_key, &s_pool) != 0) {
+        return false;
+    }
+#endif /* defined(MSGPACK_MEMORY_POOL_USE_PTHREAD) */
+    s_pool.enabled = true;
+    s_pool.max_blocks = max_blocks;
+    return true;
+}
+
+void msgpack_memory_pool_disable(void)
+{
+    memory_pool_release(&s_pool);
+}
+
+bool msgpack_memory_pool_enabled(void)
+{
+    return s_pool.enabled;
+}
+
+msgpack_memory_pool_stats msgpack_memory_pool_get_stats(void)
+{
+    return s_pool.stats;
+}
+
+void msgpack_memory_pool_reset_stats(void)
+{
+    memset(&s_pool.stats, 0, sizeof(s_pool.stats));
+}
+
+void* msgpack_memory_pool_malloc(size_t size)
+{
+    size_t bs = msgpack_memory_pool_block_size(size);
+    if(s_pool.enabled && bs <= MSGPACK_MEMORY_POOL_MAX_SIZE) {
+        size_t index = memory_pool_class(bs);
+        memory_pool_block* b = s_pool.heads[index];
+        if(b != NULL) {
+            s_pool.heads[index] = b->next;
+            --s_pool.counts[index];
+            ++s_pool.stats.hits;
+            return b;
+        }
+        ++s_pool.stats.misses;
+    }
+    return malloc(bs);
+}
+
+void msgpack_memory_pool_free(void* p, size_t size)
+{
+    if(p == NULL) { return; }
+    if(s_pool.enabled && size <= MSGPACK_MEMORY_POOL_MAX_SIZE) {
+        size_t index = memory_pool_class(size);
+        if(s_pool.counts[index] != s_pool.max_blocks) {
+            memory_pool_block* b = (memory_pool_block*)p;
+            b->next = s_pool.heads[index];
+            s_pool.heads[index] = b;
+            ++s_pool.counts[index];
+            ++s_pool.stats.returns;
+            return;
+        }
+        ++s_pool.stats.discards;
+    }
+    free(p);
+}
+
+#else  /* defined(MSGPACK_THREAD_LOCAL) */
+
+bool msgpack_memory_pool_enable(size_t max_blocks)
+{
+    (void)max_blocks;
+    return false;
+}
+
+void msgpack_memory_pool_disable(void)
+{
+}
+
+bool msgpack_memory_pool_enabled(void)
+{
+    return false;
+}
+
+msgpack_memory_pool_stats msgpack_memory_pool_get_stats(void)
+{
+    msgpack_memory_pool_stats stats;
+    memset(&stats, 0, sizeof(stats));
+    return stats;
+}
+
+void msgpack_memory_pool_reset_stats(void)
+{
+}
+
+void* msgpack_memory_pool_malloc(size_t size)
+{
+    return malloc(msgpack_memory_pool_block_size(size));
+}
+
+void msgpack_memory_pool_free(void* p, size_t size)
+{
+    (void)size;
+    free(p);
+}
+
+#endif /* defined(MSGPACK_THREAD_LOCAL) */
@@ -0,0 +1,67 @@
+/*
+ * MessagePack for C simple buffer implementation
+ *
+ *    Distributed under the Boost Software License, Version 1.0.
+ *    (See accompanying file LICENSE_1_0.txt or copy at
+ *    http://www.boost.org/LICENSE_1_0.txt)
+ */
+#if defined(MSGPACK_SBUFFER_USE_MMAP) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE /* mremap() */
+#endif
+
+#include "msgpack/sbuffer.h"
+
+#if defined(MSGPACK_SBUFFER_USE_MMAP)
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+static size_t sbuffer_mmap_size(size_t size)
+{
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return (size + page - 1) / page * page;
+}
+
+static void* sbuffer_mmap_reallocate(void* data, void* ptr, size_t old_size, size_t new_size)
+{
+    void* p;
+    (void)data;
+    if(ptr == NULL) {
+        p = mmap(NULL, sbuffer_mmap_size(new_size), PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#if defined(MADV_HUGEPAGE)
+        if(p != MAP_FAILED) {
+            /* a hint only, the mapping is usable without huge pages */
+            madvise(p, sbuffer_mmap_size(new_size), MADV_HUGEPAGE);
+        }
+#endif /* defined(MADV_HUGEPAGE) */
+    } else {
+        /* The pages are moved by the page table, not copied. */
+        p = mremap(ptr, sbuffer_mmap_size(old_size), sbuffer_mmap_size(new_size), MREMAP_MAYMOVE);
+    }
+    return p == MAP_FAILED ? NULL : p;
+}
+
+static void sbuffer_mmap_deallocate(void* data, void* ptr, size_t size)
+{
+    (void)data;
+    munmap(ptr, sbuffer_mmap_size(size));
+}
+
+static const msgpack_sbuffer_allocator sbuffer_mmap = {
+    sbuffer_mmap_reallocate, sbuffer_mmap_deallocate, NULL
+};
+
+const msgpack_sbuffer_allocator* msgpack_sbuffer_mmap_allocator(void)
+{
+    return &sbuffer_mmap;
+}
+
+#else  /* defined(MSGPACK_SBUFFER_USE_MMAP) */
+
+const msgpack_sbuffer_allocator* msgpack_sbuffer_mmap_allocator(void)
+{
+    return NULL;
+}
+
+#endif /* defined(MSGPACK_SBUFFER_USE_MMAP) */
@@ -10,11 +10,25 @@
 #include "msgpack/vrefbuffer.h"
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+
+#if defined(MSGPACK_VREFBUFFER_WRITEV)
+#include <unistd.h>
+#include <errno.h>
+#endif /* MSGPACK_VREFBUFFER_WRITEV */
 
 #define MSGPACK_PACKER_MAX_BUFFER_SIZE 9
 
+#if defined(IOV_MAX)
+#define MSGPACK_VREFBUFFER_IOV_MAX IOV_MAX
+#else
+#define MSGPACK_VREFBUFFER_IOV_MAX 1024
+#endif
+
 struct msgpack_vrefbuffer_chunk {
     struct msgpack_vrefbuffer_chunk* next;
+    /* one past the index of the last iovec that refers to the chunk */
+    size_t vec_end;
     /* data ... */
 };
 
@@ -66,6 +80,7 @@ bool msgpack_vrefbuffer_init(msgpack_vrefbuffer* vbuf,
         ib->ptr  = ((char*)chunk) + sizeof(msgpack_vrefbuffer_chunk);
         ib->head = chunk;
         chunk->next = NULL;
+        chunk->vec_end = 0;
 
         return true;
     }
@@ -100,6 +115,7 @@ void msgpack_vrefbuffer_clear(msgpack_vrefbuffer* vbuf)
         msgpack_vrefbuffer_inner_buffer* const ib = &vbuf->inner_buffer;
         msgpack_vrefbuffer_chunk* chunk = ib->head;
         chunk->next = NULL;
+        chunk->vec_end = 0;
         ib->free = vbuf->chunk_size;
         ib->ptr  = ((char*)chunk) + sizeof(msgpack_vrefbuffer_chunk);
 
@@ -155,6 +171,7 @@ int msgpack_vrefbuffer_append_copy(msgpack_vrefbuffer* vbuf,
         }
 
         chunk->next = ib->head;
+        chunk->vec_end = 0;
         ib->head = chunk;
         ib->free = sz;
         ib->ptr  = ((char*)chunk) + sizeof(msgpack_vrefbuffer_chunk);
@@ -168,10 +185,11 @@ int msgpack_vrefbuffer_append_copy(msgpack_vrefbuffer* vbuf,
     if(vbuf->tail != vbuf->array && m ==
             (const char*)((vbuf->tail-1)->iov_base) + (vbuf->tail-1)->iov_len) {
         (vbuf->tail-1)->iov_len += len;
-        return 0;
-    } else {
-        return msgpack_vrefbuffer_append_ref(vbuf, m, len);
+    } else if(msgpack_vrefbuffer_append_ref(vbuf, m, len) != 0) {
+        return -1;
     }
+    ib->head->vec_end = (size_t)(vbuf->tail - vbuf->array);
+    return 0;
 }
 
 int msgpack_vrefbuffer_migrate(msgpack_vrefbuffer* vbuf, msgpack_vrefbuffer* to)
@@ -190,12 +208,13 @@ int msgpack_vrefbuffer_migrate(msgpack_vrefbuffer* vbuf, msgpack_vrefbuffer* to)
     }
 
     empty->next = NULL;
+    empty->vec_end = 0;
 
     {
         const size_t nused = (size_t)(vbuf->tail - vbuf->array);
+        const size_t tosize = (size_t)(to->tail - to->array);
         if(to->tail + nused < vbuf->end) {
             struct iovec* nvec;
-            const size_t tosize = (size_t)(to->tail - to->array);
             const size_t reqsize = nused + tosize;
             size_t nnext = (size_t)(to->end - to->array) * 2;
             while(nnext < reqsize) {
@@ -229,15 +248,25 @@ int msgpack_vrefbuffer_migrate(msgpack_vrefbuffer* vbuf, msgpack_vrefbuffer* to)
             msgpack_vrefbuffer_inner_buffer* const toib = &to->inner_buffer;
 
             msgpack_vrefbuffer_chunk* last = ib->head;
-            while(last->next != NULL) {
+            while(true) {
+                if(last->vec_end != 0) {
+                    last->vec_end += tosize;
+                }
+                if(last->next == NULL) {
+                    break;
+                }
                 last = last->next;
             }
-            last->next = toib->head;
-            toib->head = ib->head;
 
+            /* the chunk that has the free space is kept at the head */
             if(toib->free < ib->free) {
+                last->next = toib->head;
+                toib->head = ib->head;
                 toib->free = ib->free;
                 toib->ptr  = ib->ptr;
+            } else {
+                last->next = toib->head->next;
+                toib->head->next = ib->head;
             }
 
             ib->head = empty;
@@ -248,3 +277,92 @@ int msgpack_vrefbuffer_migrate(msgpack_vrefbuffer* vbuf, msgpack_vrefbuffer* to)
 
     return 0;
 }
+
+/* Skips the iovecs from vec that len bytes cover, and returns the first
+ * iovec that is not sent. The iovec that is sent partially is cut. */
+static inline struct iovec* skip_sent_vec(msgpack_vrefbuffer* vbuf,
+        struct iovec* vec, size_t len)
+{
+    while(len != 0 && vec != vbuf->tail) {
+        if(len < vec->iov_len) {
+            vec->iov_base = (char*)vec->iov_base + len;
+            vec->iov_len -= len;
+            break;
+        }
+        len -= vec->iov_len;
+        ++vec;
+    }
+    return vec;
+}
+
+/* Removes the iovecs before vec, and frees the chunks that only they refer to. */
+static void remove_sent_vec(msgpack_vrefbuffer* vbuf, struct iovec* vec)
+{
+    const size_t sent = (size_t)(vec - vbuf->array);
+    msgpack_vrefbuffer_chunk* head;
+    msgpack_vrefbuffer_chunk** p;
+
+    if(sent == 0) {
+        return;
+    }
+    if(vec == vbuf->tail) {
+        msgpack_vrefbuffer_clear(vbuf);
+        return;
+    }
+
+    /* the iovecs that are not sent are moved to the front of array */
+    memmove(vbuf->array, vec, sizeof(struct iovec) * (size_t)(vbuf->tail - vec));
+    vbuf->tail -= sent;
+
+    /* the current chunk is kept for the following writes */
+    head = vbuf->inner_buffer.head;
+    head->vec_end = head->vec_end > sent ? head->vec_end - sent : 0;
+    p = &head->next;
+    while(*p != NULL) {
+        msgpack_vrefbuffer_chunk* c = *p;
+        if(c->vec_end <= sent) {
+            *p = c->next;
+            free(c);
+        } else {
+            c->vec_end -= sent;
+            p = &c->next;
+        }
+    }
+}
+
+void msgpack_vrefbuffer_consume(msgpack_vrefbuffer* vbuf, size_t len)
+{
+    remove_sent_vec(vbuf, skip_sent_vec(vbuf, vbuf->array, len));
+}
+
+#if defined(MSGPACK_VREFBUFFER_WRITEV)
+
+ssize_t msgpack_vrefbuffer_write_to_fd(msgpack_vrefbuffer* vbuf, int fd)
+{
+    struct iovec* vec = vbuf->array;
+    ssize_t total = 0;
+    while(vec != vbuf->tail) {
+        size_t cnt = (size_t)(vbuf->tail - vec);
+        ssize_t len;
+        if(cnt > MSGPACK_VREFBUFFER_IOV_MAX) {
+            cnt = MSGPACK_VREFBUFFER_IOV_MAX;
+        }
+        len = writev(fd, vec, (int)cnt);
+        if(len < 0) {
+            if(errno == EINTR) {
+                continue;
+            }
+            if(errno != EAGAIN && errno != EWOULDBLOCK) {
+                total = -1;
+            }
+            break;
+        }
+        vec = skip_sent_vec(vbuf, vec, (size_t)len);
+        total += len;
+    }
+    /* the sent iovecs are removed once, not for each writev() */
+    remove_sent_vec(vbuf, vec);
+    return total;
+}
+
+#endif /* MSGPACK_VREFBUFFER_WRITEV */
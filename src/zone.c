@@ -8,18 +8,63 @@
  *    http://www.boost.org/LICENSE_1_0.txt)
  */
 #include "msgpack/zone.h"
+#include "msgpack/memory_pool.h"
 #include <stdlib.h>
 #include <string.h>
 
 struct msgpack_zone_chunk {
     struct msgpack_zone_chunk* next;
+    /* The size of the block from the memory pool, 0 if it is from malloc(),
+     * and EXTERNAL_CHUNK if it is the buffer supplied by the caller. */
+    size_t size;
+    /* The usable size, that msgpack_zone_clear() restores for the oldest chunk. */
+    size_t capacity;
     /* data ... */
 };
 
+#define EXTERNAL_CHUNK ((size_t)-1)
+
+/* While the memory pool is enabled, the chunk takes the whole block
+ * and *size is updated to the usable size. */
+static inline msgpack_zone_chunk* malloc_chunk(size_t* size)
+{
+    msgpack_zone_chunk* chunk;
+    if(msgpack_memory_pool_enabled()) {
+        size_t bs = msgpack_memory_pool_block_size(sizeof(msgpack_zone_chunk) + *size);
+        chunk = (msgpack_zone_chunk*)msgpack_memory_pool_malloc(bs);
+        if(chunk == NULL) {
+            return NULL;
+        }
+        chunk->size = bs;
+        *size = bs - sizeof(msgpack_zone_chunk);
+        chunk->capacity = *size;
+    } else {
+        chunk = (msgpack_zone_chunk*)malloc(
+                sizeof(msgpack_zone_chunk) + *size);
+        if(chunk == NULL) {
+            return NULL;
+        }
+        chunk->size = 0;
+        chunk->capacity = *size;
+    }
+    return chunk;
+}
+
+static inline void free_chunk(msgpack_zone_chunk* chunk)
+{
+    if(chunk->size == EXTERNAL_CHUNK) {
+        return;
+    }
+    if(chunk->size != 0) {
+        msgpack_memory_pool_free(chunk, chunk->size);
+    } else {
+        free(chunk);
+    }
+}
+
 static inline bool init_chunk_list(msgpack_zone_chunk_list* cl, size_t chunk_size)
 {
-    msgpack_zone_chunk* chunk = (msgpack_zone_chunk*)malloc(
-            sizeof(msgpack_zone_chunk) + chunk_size);
+    msgpack_zone_chunk* chunk = malloc_chunk(&chunk_size);
     if(chunk == NULL) {
         return false;
     }
@@ -32,12 +77,36 @@ static inline bool init_chunk_list(msgpack_zone_chunk_list* cl, size_t chunk_siz
     return true;
 }
 
+static inline bool init_chunk_list_buffer(msgpack_zone_chunk_list* cl,
+        void* buffer, size_t size, size_t chunk_size)
+{
+    char* aligned = (char*)(
+        ((size_t)buffer + (MSGPACK_ZONE_ALIGN - 1)) / MSGPACK_ZONE_ALIGN * MSGPACK_ZONE_ALIGN);
+    size_t header = (size_t)(aligned - (char*)buffer) + sizeof(msgpack_zone_chunk);
+    msgpack_zone_chunk* chunk;
+
+    if(buffer == NULL || size <= header) {
+        return init_chunk_list(cl, chunk_size);
+    }
+
+    chunk = (msgpack_zone_chunk*)aligned;
+    chunk->size = EXTERNAL_CHUNK;
+    chunk->capacity = size - header;
+    chunk->next = NULL;
+
+    cl->head = chunk;
+    cl->free = chunk->capacity;
+    cl->ptr  = aligned + sizeof(msgpack_zone_chunk);
+
+    return true;
+}
+
 static inline void destroy_chunk_list(msgpack_zone_chunk_list* cl)
 {
     msgpack_zone_chunk* c = cl->head;
     while(true) {
         msgpack_zone_chunk* n = c->next;
-        free(c);
+        free_chunk(c);
         if(n != NULL) {
             c = n;
         } else {
@@ -46,13 +115,13 @@ static inline void destroy_chunk_list(msgpack_zone_chunk_list* cl)
     }
 }
 
-static inline void clear_chunk_list(msgpack_zone_chunk_list* cl, size_t chunk_size)
+static inline void clear_chunk_list(msgpack_zone_chunk_list* cl)
 {
     msgpack_zone_chunk* c = cl->head;
     while(true) {
         msgpack_zone_chunk* n = c->next;
         if(n != NULL) {
-            free(c);
+            free_chunk(c);
             c = n;
         } else {
             cl->head = c;
@@ -60,7 +129,7 @@ static inline void clear_chunk_list(msgpack_zone_chunk_list* cl, size_t chunk_si
         }
     }
     cl->head->next = NULL;
-    cl->free = chunk_size;
+    cl->free = cl->head->capacity;
     cl->ptr  = ((char*)cl->head) + sizeof(msgpack_zone_chunk);
 }
 
@@ -80,8 +149,7 @@ void* msgpack_zone_malloc_expand(msgpack_zone* zone, size_t size)
         sz = tmp_sz;
     }
 
-    chunk = (msgpack_zone_chunk*)malloc(
-            sizeof(msgpack_zone_chunk) + sz);
+    chunk = malloc_chunk(&sz);
     if (chunk == NULL) {
         return NULL;
     }
@@ -164,7 +232,8 @@ bool msgpack_zone_is_empty(msgpack_zone* zone)
 {
     msgpack_zone_chunk_list* const cl = &zone->chunk_list;
     msgpack_zone_finalizer_array* const fa = &zone->finalizer_array;
-    return cl->free == zone->chunk_size && cl->head->next == NULL &&
+    return cl->ptr == ((char*)cl->head) + sizeof(msgpack_zone_chunk) &&
+        cl->head->next == NULL &&
         fa->tail == fa->array;
 }
 
@@ -178,7 +247,7 @@ void msgpack_zone_destroy(msgpack_zone* zone)
 void msgpack_zone_clear(msgpack_zone* zone)
 {
     clear_finalizer_array(&zone->finalizer_array);
-    clear_chunk_list(&zone->chunk_list, zone->chunk_size);
+    clear_chunk_list(&zone->chunk_list);
 }
 
 bool msgpack_zone_init(msgpack_zone* zone, size_t chunk_size)
@@ -194,9 +263,22 @@ bool msgpack_zone_init(msgpack_zone* zone, size_t chunk_size)
     return true;
 }
 
+bool msgpack_zone_init_buffer(msgpack_zone* zone, void* buffer, size_t size, size_t chunk_size)
+{
+    zone->chunk_size = chunk_size;
+
+    if(!init_chunk_list_buffer(&zone->chunk_list, buffer, size, chunk_size)) {
+        return false;
+    }
+
+    init_finalizer_array(&zone->finalizer_array);
+
+    return true;
+}
+
 msgpack_zone* msgpack_zone_new(size_t chunk_size)
 {
-    msgpack_zone* zone = (msgpack_zone*)malloc(
+    msgpack_zone* zone = (msgpack_zone*)msgpack_memory_pool_malloc(
             sizeof(msgpack_zone));
     if(zone == NULL) {
         return NULL;
@@ -205,7 +287,7 @@ msgpack_zone* msgpack_zone_new(size_t chunk_size)
     zone->chunk_size = chunk_size;
 
     if(!init_chunk_list(&zone->chunk_list, chunk_size)) {
-        free(zone);
+        msgpack_memory_pool_free(zone, sizeof(msgpack_zone));
         return NULL;
     }
 
@@ -218,5 +300,5 @@ void msgpack_zone_free(msgpack_zone* zone)
 {
     if(zone == NULL) { return; }
     msgpack_zone_destroy(zone);
-    free(zone);
+    msgpack_memory_pool_free(zone, sizeof(msgpack_zone));
 }
@@ -1,5 +1,6 @@
 #include <msgpack.hpp>
 #include <msgpack/fbuffer.hpp>
+#include <msgpack/fdbuffer.hpp>
 #include <msgpack/zbuffer.hpp>
 
 #if defined(__GNUC__)
@@ -13,8 +14,19 @@
 #pragma GCC diagnostic pop
 #endif //defined(__GNUC__)
 
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include <string.h>
 
+#if defined(MSGPACK_VREFBUFFER_WRITEV) || defined(MSGPACK_FDBUFFER)
+#include <fcntl.h>
+#include <stdlib.h>
+#include <unistd.h>
+#endif // defined(MSGPACK_VREFBUFFER_WRITEV) || defined(MSGPACK_FDBUFFER)
+
 TEST(buffer, sbuffer)
 {
     msgpack::sbuffer sbuf;
@@ -71,6 +83,369 @@ TEST(buffer, vrefbuffer)
     EXPECT_TRUE( memcmp(sbuf.data(), "aaa", 3) == 0 );
 }
 
+TEST(buffer, sbuffer_prepare_commit)
+{
+    msgpack::sbuffer sbuf(1);
+    sbuf.write("a", 1);
+    char* p = sbuf.prepare(4);
+    memcpy(p, "bcde", 4);
+    sbuf.commit(2);
+    sbuf.write("f", 1);
+
+    EXPECT_EQ(4ul, sbuf.size());
+    EXPECT_TRUE( memcmp(sbuf.data(), "abcf", 4) == 0 );
+}
+
+struct counting_allocator {
+    counting_allocator():allocated(0), reallocated(0), deallocated(0) {}
+    static void* reallocate(void* user_data, void* ptr, size_t old_size, size_t new_size) {
+        counting_allocator* self = static_cast<counting_allocator*>(user_data);
+        if (ptr) {
+            ++self->reallocated;
+            self->allocated -= old_size;
+        }
+        self->allocated += new_size;
+        self->sizes.push_back(new_size);
+        return realloc(ptr, new_size);
+    }
+    static void deallocate(void* user_data, void* ptr, size_t size) {
+        counting_allocator* self = static_cast<counting_allocator*>(user_data);
+        ++self->deallocated;
+        self->allocated -= size;
+        free(ptr);
+    }
+    size_t allocated;
+    int reallocated;
+    int deallocated;
+    std::vector<size_t> sizes;
+};
+
+TEST(buffer, sbuffer_allocator_grow_limit)
+{
+    counting_allocator c;
+    msgpack::sbuffer_allocator a = {
+        &counting_allocator::reallocate, &counting_allocator::deallocate, &c
+    };
+    {
+        msgpack::sbuffer sbuf(4, 16, a);
+        std::string str(100, 'x');
+        sbuf.write(str.data(), 40);
+        sbuf.write(str.data(), 1);
+        EXPECT_EQ(41ul, sbuf.size());
+        EXPECT_EQ(48ul, sbuf.capacity());
+        EXPECT_EQ(48ul, c.allocated);
+
+        // doubled up to 16 bytes, and then 16 bytes each
+        ASSERT_EQ(2u, c.sizes.size());
+        EXPECT_EQ(4ul, c.sizes[0]);
+        EXPECT_EQ(48ul, c.sizes[1]);
+        sbuf.write(str.data(), 8);
+        EXPECT_EQ(64ul, sbuf.capacity());
+        EXPECT_TRUE( memcmp(sbuf.data(), str.data(), 49) == 0 );
+    }
+    EXPECT_EQ(0ul, c.allocated);
+    EXPECT_EQ(1, c.deallocated);
+}
+
+TEST(buffer, sbuffer_reserve_shrink_to_fit)
+{
+    msgpack::sbuffer sbuf(0);
+    EXPECT_EQ(0ul, sbuf.capacity());
+    sbuf.reserve(100);
+    EXPECT_EQ(100ul, sbuf.capacity());
+    sbuf.reserve(10);
+    EXPECT_EQ(100ul, sbuf.capacity());
+    sbuf.write("abc", 3);
+    sbuf.shrink_to_fit();
+    EXPECT_EQ(3ul, sbuf.capacity());
+    EXPECT_TRUE( memcmp(sbuf.data(), "abc", 3) == 0 );
+    sbuf.clear();
+    sbuf.shrink_to_fit();
+    EXPECT_EQ(0ul, sbuf.capacity());
+    EXPECT_TRUE(sbuf.data() == MSGPACK_NULLPTR);
+    sbuf.write("d", 1);
+    EXPECT_EQ(1ul, sbuf.size());
+    EXPECT_EQ('d', sbuf.data()[0]);
+}
+
+#if defined(MSGPACK_SBUFFER_MMAP)
+
+TEST(buffer, sbuffer_mmap_allocator)
+{
+    msgpack::sbuffer sbuf(1, 0, msgpack::sbuffer_mmap_allocator());
+    std::string str(10000, 'x');
+    for (int i = 0; i != 1000; ++i) {
+        str[0] = static_cast<char>(i);
+        sbuf.write(str.data(), str.size());
+    }
+    EXPECT_EQ(10000000ul, sbuf.size());
+    for (int i = 0; i != 1000; ++i) {
+        EXPECT_EQ(static_cast<char>(i), sbuf.data()[i * 10000]);
+    }
+    sbuf.shrink_to_fit();
+    EXPECT_EQ(static_cast<char>(999), sbuf.data()[999 * 10000]);
+    EXPECT_EQ('x', sbuf.data()[sbuf.size() - 1]);
+}
+
+#endif // defined(MSGPACK_SBUFFER_MMAP)
+
+TEST(buffer, vrefbuffer_prepare_commit)
+{
+    msgpack::vrefbuffer vbuf(10, 4);
+    vbuf.write("a", 1);
+    char* p = vbuf.prepare(8);
+    memcpy(p, "bcdefghi", 8);
+    vbuf.commit(8);
+    vbuf.write("j", 1);
+
+    const struct iovec* vec = vbuf.vector();
+    size_t veclen = vbuf.vector_size();
+
+    msgpack::sbuffer sbuf;
+    for(size_t i=0; i < veclen; ++i) {
+        sbuf.write((const char*)vec[i].iov_base, vec[i].iov_len);
+    }
+
+    EXPECT_EQ(10ul, sbuf.size());
+    EXPECT_TRUE( memcmp(sbuf.data(), "abcdefghij", 10) == 0 );
+}
+
+static std::string vrefbuffer_str(msgpack::vrefbuffer const& vbuf)
+{
+    std::string str;
+    const struct iovec* vec = vbuf.vector();
+    for(size_t i=0; i < vbuf.vector_size(); ++i) {
+        str.append(static_cast<const char*>(vec[i].iov_base), vec[i].iov_len);
+    }
+    return str;
+}
+
+TEST(buffer, vrefbuffer_consume)
+{
+    msgpack::vrefbuffer vbuf(16, 8);
+    std::string ref(20, 'r');
+    std::string expected;
+    for(int i = 0; i != 10; ++i) {
+        std::string copy(6, static_cast<char>('a' + i));
+        vbuf.write(copy.data(), copy.size());
+        vbuf.write(ref.data(), ref.size());
+        expected += copy + ref;
+    }
+    EXPECT_EQ(expected, vrefbuffer_str(vbuf));
+
+    // partially in an iovec, and then across iovecs
+    vbuf.consume(3);
+    expected.erase(0, 3);
+    EXPECT_EQ(expected, vrefbuffer_str(vbuf));
+    vbuf.consume(50);
+    expected.erase(0, 50);
+    EXPECT_EQ(expected, vrefbuffer_str(vbuf));
+
+    // the written data is appended after the unsent data
+    vbuf.write("xyz", 3);
+    expected += "xyz";
+    EXPECT_EQ(expected, vrefbuffer_str(vbuf));
+
+    vbuf.consume(expected.size() - 1);
+    EXPECT_EQ(1u, vbuf.vector_size());
+    EXPECT_EQ("z", vrefbuffer_str(vbuf));
+    vbuf.consume(1);
+    EXPECT_EQ(0u, vbuf.vector_size());
+
+    vbuf.write("abc", 3);
+    EXPECT_EQ("abc", vrefbuffer_str(vbuf));
+}
+
+#if defined(MSGPACK_VREFBUFFER_WRITEV)
+
+TEST(buffer, vrefbuffer_write_to_fd)
+{
+    msgpack::vrefbuffer vbuf;
+    std::string ref(100, 'r');
+    std::string expected;
+    // more iovecs than IOV_MAX
+    for(size_t i = 0; i != 3000; ++i) {
+        char c = static_cast<char>(i);
+        vbuf.write(&c, 1);
+        vbuf.write(ref.data(), ref.size());
+        expected += c;
+        expected += ref;
+    }
+
+    char filename[] = "/tmp/mp.XXXXXX";
+    int fd = mkstemp(filename);
+    ASSERT_LT(0, fd);
+    EXPECT_EQ(expected.size(), vbuf.write_to_fd(fd));
+    EXPECT_EQ(0u, vbuf.vector_size());
+
+    std::string actual(expected.size(), '\0');
+    lseek(fd, 0, SEEK_SET);
+    EXPECT_EQ(static_cast<ssize_t>(actual.size()), read(fd, &actual[0], actual.size()));
+    EXPECT_EQ(expected, actual);
+    close(fd);
+    unlink(filename);
+}
+
+TEST(buffer, vrefbuffer_write_to_fd_nonblock)
+{
+    msgpack::vrefbuffer vbuf;
+    std::string expected;
+    for(int i = 0; i != 100000; ++i) {
+        expected += static_cast<char>(i);
+        msgpack::pack(vbuf, i);
+    }
+    std::string packed = vrefbuffer_str(vbuf);
+
+    int fds[2];
+    ASSERT_EQ(0, pipe(fds));
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+
+    // the pipe is filled and then drained until everything is sent
+    std::string actual;
+    while(vbuf.vector_size() != 0) {
+        vbuf.write_to_fd(fds[1]);
+        char buf[4096];
+        ssize_t len = read(fds[0], buf, sizeof(buf));
+        ASSERT_LT(0, len);
+        actual.append(buf, static_cast<size_t>(len));
+    }
+    close(fds[1]);
+    char buf[4096];
+    ssize_t len;
+    while((len = read(fds[0], buf, sizeof(buf))) > 0) {
+        actual.append(buf, static_cast<size_t>(len));
+    }
+    close(fds[0]);
+    EXPECT_EQ(packed, actual);
+}
+
+#endif // defined(MSGPACK_VREFBUFFER_WRITEV)
+
+struct prepare_commit_stream {
+    prepare_commit_stream():prepared(0), written(0) {}
+    void write(const char* buf, size_t len) {
+        sbuf.write(buf, len);
+        ++written;
+    }
+    char* prepare(size_t len) {
+        ++prepared;
+        return sbuf.prepare(len);
+    }
+    void commit(size_t len) {
+        sbuf.commit(len);
+    }
+    msgpack::sbuffer sbuf;
+    int prepared;
+    int written;
+};
+
+TEST(buffer, packer_prepare_commit)
+{
+    std::map<std::string, std::vector<long long> > m;
+    m["a"].push_back(1);
+    m["a"].push_back(-200);
+    m["b"].push_back(70000);
+    m["b"].push_back(-5000000000LL);
+
+    prepare_commit_stream s;
+    msgpack::pack(s, m);
+    msgpack::pack(s, 1.5);
+    msgpack::pack(s, true);
+
+    // std::stringstream doesn't have prepare() and commit()
+    std::stringstream ss;
+    msgpack::pack(ss, m);
+    msgpack::pack(ss, 1.5);
+    msgpack::pack(ss, true);
+
+    EXPECT_EQ(ss.str(), std::string(s.sbuf.data(), s.sbuf.size()));
+    // only the str bodies are written
+    EXPECT_EQ(2, s.written);
+    // the elements of each vector are prepared at once
+    EXPECT_EQ(9, s.prepared);
+}
+
+#if defined(MSGPACK_FDBUFFER)
+
+static std::string read_file(int fd)
+{
+    std::string str(static_cast<size_t>(lseek(fd, 0, SEEK_END)), '\0');
+    lseek(fd, 0, SEEK_SET);
+    if (!str.empty()) {
+        EXPECT_EQ(static_cast<ssize_t>(str.size()), read(fd, &str[0], str.size()));
+    }
+    return str;
+}
+
+TEST(buffer, fdbuffer)
+{
+    const int flags[] = {
+        msgpack::FDBUFFER_DEFAULT,
+        msgpack::FDBUFFER_FDATASYNC | msgpack::FDBUFFER_FADVISE_DONTNEED,
+        msgpack::FDBUFFER_BACKGROUND,
+        msgpack::FDBUFFER_BACKGROUND | msgpack::FDBUFFER_FADVISE_DONTNEED
+    };
+    for (size_t f = 0; f != sizeof(flags) / sizeof(flags[0]); ++f) {
+        char filename[] = "/tmp/mp.XXXXXX";
+        int fd = mkstemp(filename);
+        ASSERT_LT(0, fd);
+
+        msgpack::sbuffer expected;
+        {
+            msgpack::fdbuffer fdbuf(fd, 100, flags[f]);
+            for (int i = 0; i != 1000; ++i) {
+                std::map<std::string, std::vector<int> > m;
+                m[std::string(static_cast<size_t>(i % 40), 'k')].push_back(i);
+                msgpack::pack(fdbuf, m);
+                msgpack::pack(expected, m);
+                EXPECT_GT(100u, fdbuf.size());
+            }
+            // larger than the buffer
+            std::string large(1000, 'l');
+            fdbuf.write(large.data(), large.size());
+            expected.write(large.data(), large.size());
+            msgpack::pack(fdbuf, 1);
+            msgpack::pack(expected, 1);
+        }
+        EXPECT_EQ(std::string(expected.data(), expected.size()), read_file(fd));
+        close(fd);
+        unlink(filename);
+    }
+}
+
+TEST(buffer, fdbuffer_flush)
+{
+    char filename[] = "/tmp/mp.XXXXXX";
+    int fd = mkstemp(filename);
+    ASSERT_LT(0, fd);
+
+    msgpack::fdbuffer fdbuf(fd);
+    msgpack::pack(fdbuf, std::string("abc"));
+    EXPECT_EQ(4u, fdbuf.size());
+    EXPECT_EQ("", read_file(fd));
+    fdbuf.flush();
+    EXPECT_EQ(0u, fdbuf.size());
+    EXPECT_EQ("\xa3" "abc", read_file(fd));
+    close(fd);
+    unlink(filename);
+}
+
+TEST(buffer, fdbuffer_error)
+{
+    msgpack::fdbuffer fdbuf(-1, 16);
+    fdbuf.write("abc", 3);
+    EXPECT_THROW(fdbuf.flush(), std::runtime_error);
+    EXPECT_THROW(fdbuf.write(std::string(16, 'a').data(), 16), std::runtime_error);
+
+#if !defined(MSGPACK_USE_CPP03)
+    msgpack::fdbuffer bgbuf(-1, 16, msgpack::FDBUFFER_BACKGROUND);
+    bgbuf.write("abc", 3);
+    EXPECT_THROW(bgbuf.flush(), std::runtime_error);
+#endif // !defined(MSGPACK_USE_CPP03)
+}
+
+#endif // defined(MSGPACK_FDBUFFER)
+
 TEST(buffer, zbuffer)
 {
     msgpack::zbuffer zbuf;
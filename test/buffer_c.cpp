@@ -85,6 +85,62 @@ TEST(buffer, sbuffer_c)
     msgpack_sbuffer_free(sbuf);
 }
 
+TEST(buffer, sbuffer_c_reserve_shrink_to_fit)
+{
+    msgpack_sbuffer sbuf;
+    msgpack_sbuffer_init(&sbuf);
+    EXPECT_EQ(0, msgpack_sbuffer_reserve(&sbuf, 4));
+    EXPECT_EQ(4U, sbuf.alloc);
+    EXPECT_EQ(0, msgpack_sbuffer_write(&sbuf, "abc", 3));
+    EXPECT_EQ(4U, sbuf.alloc);
+    EXPECT_EQ(0, msgpack_sbuffer_shrink_to_fit(&sbuf));
+    EXPECT_EQ(3U, sbuf.alloc);
+    EXPECT_EQ(0, memcmp(sbuf.data, "abc", 3));
+    msgpack_sbuffer_destroy(&sbuf);
+}
+
+TEST(buffer, sbuffer_c_grow_limit)
+{
+    msgpack_sbuffer_ex sbuf;
+    char data[100];
+    memset(data, 'x', sizeof(data));
+    msgpack_sbuffer_ex_init(&sbuf, 16, NULL);
+    EXPECT_EQ(0, msgpack_sbuffer_ex_reserve(&sbuf, 4));
+    EXPECT_EQ(4U, sbuf.buf.alloc);
+    EXPECT_EQ(0, msgpack_sbuffer_ex_write(&sbuf, data, 40));
+    EXPECT_EQ(48U, sbuf.buf.alloc);
+    EXPECT_EQ(0, msgpack_sbuffer_ex_write(&sbuf, data, 9));
+    EXPECT_EQ(64U, sbuf.buf.alloc);
+    EXPECT_EQ(0, msgpack_sbuffer_ex_shrink_to_fit(&sbuf));
+    EXPECT_EQ(49U, sbuf.buf.alloc);
+    EXPECT_EQ(0, memcmp(sbuf.buf.data, data, 49));
+    msgpack_sbuffer_clear(&sbuf.buf);
+    EXPECT_EQ(0, msgpack_sbuffer_ex_shrink_to_fit(&sbuf));
+    EXPECT_TRUE(sbuf.buf.data == NULL);
+    msgpack_sbuffer_ex_destroy(&sbuf);
+}
+
+TEST(buffer, sbuffer_c_mmap_allocator)
+{
+    msgpack_sbuffer_ex sbuf;
+    char data[10000];
+    int i;
+    if (msgpack_sbuffer_mmap_allocator() == NULL) {
+        return;
+    }
+    memset(data, 'x', sizeof(data));
+    msgpack_sbuffer_ex_init(&sbuf, 0, msgpack_sbuffer_mmap_allocator());
+    for (i = 0; i != 1000; ++i) {
+        data[0] = (char)i;
+        EXPECT_EQ(0, msgpack_sbuffer_ex_write(&sbuf, data, sizeof(data)));
+    }
+    EXPECT_EQ(10000000U, sbuf.buf.size);
+    for (i = 0; i != 1000; ++i) {
+        EXPECT_EQ((char)i, sbuf.buf.data[i * 10000]);
+    }
+    msgpack_sbuffer_ex_destroy(&sbuf);
+}
+
 TEST(buffer, vrefbuffer_c)
 {
     const char *raw = "I was about to sail away in a junk,"
@@ -146,3 +202,128 @@ TEST(buffer, vrefbuffer_c)
     free(buf);
     msgpack_vrefbuffer_free(vbuf);
 }
+
+TEST(buffer, vrefbuffer_c_consume)
+{
+    msgpack_vrefbuffer vbuf;
+    char ref[20];
+    size_t i;
+    memset(ref, 'r', sizeof(ref));
+    EXPECT_TRUE(msgpack_vrefbuffer_init(&vbuf, 16, 8));
+    for (i = 0; i < 10; i++) {
+        char copy[6];
+        memset(copy, 'a' + (int)i, sizeof(copy));
+        EXPECT_EQ(0, msgpack_vrefbuffer_write(&vbuf, copy, sizeof(copy)));
+        EXPECT_EQ(0, msgpack_vrefbuffer_write(&vbuf, ref, sizeof(ref)));
+    }
+    EXPECT_EQ(20u, msgpack_vrefbuffer_veclen(&vbuf));
+
+    msgpack_vrefbuffer_consume(&vbuf, 3);
+    EXPECT_EQ(20u, msgpack_vrefbuffer_veclen(&vbuf));
+    EXPECT_EQ(3u, msgpack_vrefbuffer_vec(&vbuf)->iov_len);
+    EXPECT_EQ('a', *(const char*)msgpack_vrefbuffer_vec(&vbuf)->iov_base);
+
+    msgpack_vrefbuffer_consume(&vbuf, 3 + 20 + 6 + 5);
+    EXPECT_EQ(17u, msgpack_vrefbuffer_veclen(&vbuf));
+    EXPECT_EQ(15u, msgpack_vrefbuffer_vec(&vbuf)->iov_len);
+
+    EXPECT_EQ(0, msgpack_vrefbuffer_write(&vbuf, "xyz", 3));
+    EXPECT_EQ(18u, msgpack_vrefbuffer_veclen(&vbuf));
+    msgpack_vrefbuffer_consume(&vbuf, 15 + 8 * 26 + 2);
+    EXPECT_EQ(1u, msgpack_vrefbuffer_veclen(&vbuf));
+    EXPECT_EQ('z', *(const char*)msgpack_vrefbuffer_vec(&vbuf)->iov_base);
+    msgpack_vrefbuffer_consume(&vbuf, 1);
+    EXPECT_EQ(0u, msgpack_vrefbuffer_veclen(&vbuf));
+
+    msgpack_vrefbuffer_destroy(&vbuf);
+}
+
+#if defined(MSGPACK_VREFBUFFER_WRITEV)
+
+#include <fcntl.h>
+
+TEST(buffer, vrefbuffer_c_write_to_fd)
+{
+    msgpack_vrefbuffer vbuf;
+    char ref[100];
+    char filename[] = "/tmp/mp.XXXXXX";
+    char* buf;
+    size_t i, len = 0;
+    int fd;
+    memset(ref, 'r', sizeof(ref));
+    EXPECT_TRUE(msgpack_vrefbuffer_init(&vbuf, 0, 0));
+    /* more iovecs than IOV_MAX */
+    for (i = 0; i < 3000; i++) {
+        char c = (char)i;
+        EXPECT_EQ(0, msgpack_vrefbuffer_write(&vbuf, &c, 1));
+        EXPECT_EQ(0, msgpack_vrefbuffer_write(&vbuf, ref, sizeof(ref)));
+        len += 1 + sizeof(ref);
+    }
+
+    fd = mkstemp(filename);
+    EXPECT_LT(0, fd);
+    EXPECT_EQ((ssize_t)len, msgpack_vrefbuffer_write_to_fd(&vbuf, fd));
+    EXPECT_EQ(0u, msgpack_vrefbuffer_veclen(&vbuf));
+
+    buf = (char*)malloc(len);
+    lseek(fd, 0, SEEK_SET);
+    EXPECT_EQ((ssize_t)len, read(fd, buf, len));
+    for (i = 0; i < 3000; i++) {
+        EXPECT_EQ((char)i, buf[i * (1 + sizeof(ref))]);
+    }
+    free(buf);
+    close(fd);
+    unlink(filename);
+    msgpack_vrefbuffer_destroy(&vbuf);
+}
+
+TEST(buffer, vrefbuffer_c_write_to_fd_nonblock)
+{
+    msgpack_vrefbuffer vbuf;
+    char ref[100];
+    char buf[4096];
+    char* actual;
+    size_t i, len = 0, received = 0;
+    ssize_t n;
+    int fds[2];
+    memset(ref, 'r', sizeof(ref));
+    EXPECT_TRUE(msgpack_vrefbuffer_init(&vbuf, 0, 0));
+    /* more iovecs than IOV_MAX, and more bytes than the pipe holds */
+    for (i = 0; i < 3000; i++) {
+        char c = (char)i;
+        EXPECT_EQ(0, msgpack_vrefbuffer_write(&vbuf, &c, 1));
+        EXPECT_EQ(0, msgpack_vrefbuffer_write(&vbuf, ref, sizeof(ref)));
+        len += 1 + sizeof(ref);
+    }
+
+    ASSERT_EQ(0, pipe(fds));
+    fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+
+    /* the pipe is filled and then drained until everything is sent */
+    actual = (char*)malloc(len);
+    while (msgpack_vrefbuffer_veclen(&vbuf) != 0) {
+        size_t veclen = msgpack_vrefbuffer_veclen(&vbuf);
+        EXPECT_LE(0, msgpack_vrefbuffer_write_to_fd(&vbuf, fds[1]));
+        EXPECT_GE(veclen, msgpack_vrefbuffer_veclen(&vbuf));
+        n = read(fds[0], buf, sizeof(buf));
+        ASSERT_LT(0, n);
+        memcpy(actual + received, buf, (size_t)n);
+        received += (size_t)n;
+    }
+    close(fds[1]);
+    while ((n = read(fds[0], buf, sizeof(buf))) > 0) {
+        memcpy(actual + received, buf, (size_t)n);
+        received += (size_t)n;
+    }
+    close(fds[0]);
+
+    EXPECT_EQ(len, received);
+    for (i = 0; i < 3000; i++) {
+        EXPECT_EQ((char)i, actual[i * (1 + sizeof(ref))]);
+        EXPECT_EQ(0, memcmp(actual + i * (1 + sizeof(ref)) + 1, ref, sizeof(ref)));
+    }
+    free(actual);
+    msgpack_vrefbuffer_destroy(&vbuf);
+}
+
+#endif /* MSGPACK_VREFBUFFER_WRITEV */
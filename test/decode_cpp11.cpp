@@ -0,0 +1,273 @@
+#include <msgpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#if !defined(MSGPACK_USE_CPP03)
+
+struct decode_inner {
+    int a;
+    std::string b;
+    MSGPACK_DEFINE_ARRAY(a, b);
+};
+
+struct decode_outer {
+    int id;
+    double score;
+    std::string name;
+    std::vector<decode_inner> inners;
+    std::map<std::string, std::vector<int> > groups;
+    std::list<int> others;
+    bool flag;
+    MSGPACK_DEFINE_MAP(id, score, name, inners, groups, others, flag);
+};
+
+struct decode_base {
+    int x;
+    MSGPACK_DEFINE_MAP(x);
+};
+
+struct decode_derived : decode_base {
+    int y;
+    MSGPACK_DEFINE_MAP(MSGPACK_BASE_MAP(decode_base), y);
+};
+
+struct decode_nvp {
+    int v;
+    MSGPACK_DEFINE_MAP(MSGPACK_NVP("value", v));
+};
+
+static decode_outer make_outer()
+{
+    decode_outer o;
+    o.id = 42;
+    o.score = 1.5;
+    o.name = "outer";
+    o.inners.push_back(decode_inner{1, "one"});
+    o.inners.push_back(decode_inner{-2, "two"});
+    o.groups["g1"] = std::vector<int>{1, 2, 3};
+    o.groups["g2"] = std::vector<int>();
+    o.others = std::list<int>{7, 8};
+    o.flag = true;
+    return o;
+}
+
+static void expect_outer(decode_outer const& e, decode_outer const& a)
+{
+    EXPECT_EQ(e.id, a.id);
+    EXPECT_EQ(e.score, a.score);
+    EXPECT_EQ(e.name, a.name);
+    ASSERT_EQ(e.inners.size(), a.inners.size());
+    for (std::size_t i = 0; i != e.inners.size(); ++i) {
+        EXPECT_EQ(e.inners[i].a, a.inners[i].a);
+        EXPECT_EQ(e.inners[i].b, a.inners[i].b);
+    }
+    EXPECT_EQ(e.groups, a.groups);
+    EXPECT_EQ(e.others, a.others);
+    EXPECT_EQ(e.flag, a.flag);
+}
+
+TEST(decode, define_map)
+{
+    decode_outer o = make_outer();
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, o);
+
+    decode_outer d;
+    std::size_t off = 0;
+    msgpack::decode(sbuf.data(), sbuf.size(), off, d);
+    EXPECT_EQ(sbuf.size(), off);
+    expect_outer(o, d);
+
+    decode_outer c = msgpack::unpack(sbuf.data(), sbuf.size())->as<decode_outer>();
+    expect_outer(c, d);
+}
+
+TEST(decode, define_array_size_mismatch)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, std::make_tuple(3, std::string("x"), std::vector<int>{1}, 4));
+    msgpack::pack(sbuf, std::make_tuple(5));
+
+    decode_inner d{0, "keep"};
+    std::size_t off = 0;
+    msgpack::decode(sbuf.data(), sbuf.size(), off, d);
+    EXPECT_EQ(3, d.a);
+    EXPECT_EQ("x", d.b);
+    msgpack::decode(sbuf.data(), sbuf.size(), off, d);
+    EXPECT_EQ(5, d.a);
+    EXPECT_EQ("x", d.b);
+    EXPECT_EQ(sbuf.size(), off);
+}
+
+TEST(decode, define_map_unknown_and_missing_keys)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::packer<msgpack::sbuffer> pk(sbuf);
+    pk.pack_map(2);
+    pk.pack(std::string("unknown"));
+    pk.pack(std::map<int, std::vector<int> >{{1, {2, 3}}});
+    pk.pack(std::string("id"));
+    pk.pack(7);
+
+    decode_outer d = make_outer();
+    msgpack::decode(sbuf.data(), sbuf.size(), d);
+    EXPECT_EQ(7, d.id);
+    EXPECT_EQ("outer", d.name);
+}
+
+TEST(decode, base_and_nvp)
+{
+    decode_derived dd;
+    dd.x = 1;
+    dd.y = 2;
+    decode_nvp n;
+    n.v = 3;
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, dd);
+    msgpack::pack(sbuf, n);
+
+    decode_derived rd;
+    decode_nvp rn;
+    std::size_t off = 0;
+    msgpack::decode(sbuf.data(), sbuf.size(), off, rd);
+    msgpack::decode(sbuf.data(), sbuf.size(), off, rn);
+    EXPECT_EQ(1, rd.x);
+    EXPECT_EQ(2, rd.y);
+    EXPECT_EQ(3, rn.v);
+}
+
+TEST(decode, stl)
+{
+    std::unordered_map<std::string, std::vector<double> > um;
+    um["a"] = std::vector<double>{1.0, -2.5};
+    std::vector<char> bin{'a', 'b'};
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, um);
+    msgpack::pack(sbuf, bin);
+    msgpack::pack(sbuf, std::vector<bool>{true, false});
+    msgpack::pack(sbuf, -100000);
+    msgpack::pack(sbuf, 1.5f);
+    msgpack::pack(sbuf, msgpack::type::nil_t());
+
+    std::unordered_map<std::string, std::vector<double> > rum;
+    std::vector<char> rbin;
+    std::vector<bool> rvb;
+    long long i;
+    float f;
+    std::vector<int> v{1};
+    std::size_t off = 0;
+    msgpack::decode(sbuf.data(), sbuf.size(), off, rum);
+    msgpack::decode(sbuf.data(), sbuf.size(), off, rbin);
+    msgpack::decode(sbuf.data(), sbuf.size(), off, rvb);
+    msgpack::decode(sbuf.data(), sbuf.size(), off, i);
+    msgpack::decode(sbuf.data(), sbuf.size(), off, f);
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), off, v), msgpack::type_error);
+    EXPECT_EQ(um, rum);
+    EXPECT_EQ(bin, rbin);
+    EXPECT_EQ((std::vector<bool>{true, false}), rvb);
+    EXPECT_EQ(-100000, i);
+    EXPECT_EQ(1.5f, f);
+}
+
+TEST(decode, type_error)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, std::vector<int>{1, 2});
+    decode_outer d;
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), d), msgpack::type_error);
+
+    sbuf.clear();
+    std::map<int, int> m;
+    m[1] = 2;
+    msgpack::pack(sbuf, m);
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), d), msgpack::type_error);
+
+    sbuf.clear();
+    msgpack::pack(sbuf, 300);
+    unsigned char c;
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), c), msgpack::type_error);
+}
+
+TEST(decode, insufficient_bytes)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, make_outer());
+    for (std::size_t len = 1; len < sbuf.size(); ++len) {
+        decode_outer d;
+        std::size_t off = 0;
+        EXPECT_THROW(msgpack::decode(sbuf.data(), len, off, d), msgpack::insufficient_bytes);
+        EXPECT_EQ(0u, off);
+    }
+}
+
+TEST(decode, broken_size)
+{
+    // array32 with 0xffffffff elements
+    const char data[] = { static_cast<char>(0xdd), static_cast<char>(0xff), static_cast<char>(0xff),
+                          static_cast<char>(0xff), static_cast<char>(0xff), 0x01 };
+    std::vector<int> v;
+    EXPECT_THROW(msgpack::decode(data, sizeof(data), v), msgpack::insufficient_bytes);
+}
+
+TEST(decode, parse_error)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::packer<msgpack::sbuffer> pk(sbuf);
+    pk.pack_array(2);
+    pk.pack(1);
+    sbuf.write("\xc1", 1);
+    std::vector<int> v;
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), v), msgpack::parse_error);
+}
+
+TEST(decode, limit)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, make_outer());
+    decode_outer d;
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), d, msgpack::unpack_limit(1, 100)),
+                 msgpack::array_size_overflow);
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), d, msgpack::unpack_limit(100, 2)),
+                 msgpack::map_size_overflow);
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), d, msgpack::unpack_limit(100, 100, 2)),
+                 msgpack::str_size_overflow);
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), d, msgpack::unpack_limit(100, 100, 100, 100, 100, 2)),
+                 msgpack::depth_size_overflow);
+}
+
+TEST(decode, limit_depth_of_fallback)
+{
+    // std::list is converted by unpack() and the convert adaptor
+    std::vector<std::list<std::list<int> > > v{{{1}}};
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, v);
+    std::vector<std::list<std::list<int> > > d;
+    EXPECT_THROW(msgpack::decode(sbuf.data(), sbuf.size(), d, msgpack::unpack_limit(100, 100, 100, 100, 100, 2)),
+                 msgpack::depth_size_overflow);
+    msgpack::decode(sbuf.data(), sbuf.size(), d, msgpack::unpack_limit(100, 100, 100, 100, 100, 3));
+    EXPECT_EQ(v, d);
+    EXPECT_THROW(msgpack::unpack(sbuf.data(), sbuf.size(), MSGPACK_NULLPTR, MSGPACK_NULLPTR,
+                                 msgpack::unpack_limit(100, 100, 100, 100, 100, 2)),
+                 msgpack::depth_size_overflow);
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+TEST(decode, dummy)
+{
+}
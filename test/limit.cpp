@@ -324,6 +324,44 @@ TEST(limit, unpack_depth_over)
     }
 }
 
+TEST(limit, unpack_depth_over_embed_stack)
+{
+    // deeper than MSGPACK_EMBED_STACK_SIZE
+    std::string str(100, static_cast<char>(0x91u));
+    str.push_back(0x01);
+    msgpack::object_handle unp;
+    msgpack::unpack(unp, str.data(), str.size(), MSGPACK_NULLPTR, MSGPACK_NULLPTR,
+                    msgpack::unpack_limit(1, 0, 0, 0, 0, 100));
+    msgpack::object const* obj = &unp.get();
+    for (std::size_t i = 0; i != 100; ++i) {
+        EXPECT_EQ(msgpack::type::ARRAY, obj->type);
+        EXPECT_EQ(1u, obj->via.array.size);
+        obj = obj->via.array.ptr;
+    }
+    EXPECT_EQ(1, obj->as<int>());
+
+    msgpack::unpacker unpacker;
+    unpacker.reserve_buffer(str.size());
+    std::memcpy(unpacker.buffer(), str.data(), str.size());
+    unpacker.buffer_consumed(str.size());
+    msgpack::object_handle unp_stream;
+    EXPECT_TRUE(unpacker.next(unp_stream));
+    EXPECT_EQ(unp.get(), unp_stream.get());
+
+    msgpack::object_handle unp_v1;
+    msgpack::v1::unpack(unp_v1, str.data(), str.size());
+    EXPECT_EQ(unp.get(), unp_v1.get());
+
+    try {
+        msgpack::unpack(unp, str.data(), str.size(), MSGPACK_NULLPTR, MSGPACK_NULLPTR,
+                        msgpack::unpack_limit(1, 0, 0, 0, 0, 99));
+        EXPECT_TRUE(false);
+    }
+    catch(msgpack::depth_size_overflow const&) {
+        EXPECT_TRUE(true);
+    }
+}
+
 
 
 #if !defined(MSGPACK_USE_CPP03)
@@ -0,0 +1,46 @@
+#include <msgpack.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+TEST(memory_pool, zone_c)
+{
+    if (!msgpack_memory_pool_enable(MSGPACK_MEMORY_POOL_MAX_BLOCKS)) {
+        return;
+    }
+    msgpack_memory_pool_reset_stats();
+
+    msgpack_zone* z = msgpack_zone_new(MSGPACK_ZONE_CHUNK_SIZE);
+    EXPECT_TRUE(z != NULL);
+    EXPECT_TRUE(msgpack_zone_is_empty(z));
+    EXPECT_TRUE(msgpack_zone_malloc(z, 100) != NULL);
+    EXPECT_FALSE(msgpack_zone_is_empty(z));
+    msgpack_zone_free(z);
+
+    msgpack_memory_pool_stats s = msgpack_memory_pool_get_stats();
+    EXPECT_EQ(0u, s.hits);
+    EXPECT_EQ(2u, s.misses);
+    EXPECT_EQ(2u, s.returns);
+
+    // the zone object and the chunk are reused
+    z = msgpack_zone_new(MSGPACK_ZONE_CHUNK_SIZE);
+    EXPECT_TRUE(msgpack_zone_malloc(z, MSGPACK_ZONE_CHUNK_SIZE + 100) != NULL);
+    msgpack_zone_clear(z);
+    EXPECT_TRUE(msgpack_zone_is_empty(z));
+    msgpack_zone_free(z);
+    EXPECT_EQ(2u, msgpack_memory_pool_get_stats().hits);
+
+    msgpack_memory_pool_disable();
+    EXPECT_FALSE(msgpack_memory_pool_enabled());
+    z = msgpack_zone_new(MSGPACK_ZONE_CHUNK_SIZE);
+    msgpack_zone_free(z);
+    EXPECT_EQ(2u, msgpack_memory_pool_get_stats().hits);
+}
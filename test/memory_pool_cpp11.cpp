@@ -0,0 +1,175 @@
+#include <msgpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+#if !defined(MSGPACK_USE_CPP03)
+
+TEST(memory_pool, block_size)
+{
+    EXPECT_EQ(64u, msgpack::memory_pool::block_size(0));
+    EXPECT_EQ(64u, msgpack::memory_pool::block_size(64));
+    EXPECT_EQ(128u, msgpack::memory_pool::block_size(65));
+    EXPECT_EQ(16384u, msgpack::memory_pool::block_size(8200));
+    std::size_t large = MSGPACK_MEMORY_POOL_MAX_SIZE + 1;
+    EXPECT_EQ(large, msgpack::memory_pool::block_size(large));
+}
+
+TEST(memory_pool, allocate)
+{
+    EXPECT_FALSE(msgpack::memory_pool::enabled());
+    msgpack::memory_pool::enable(1);
+    msgpack::memory_pool::reset_stats();
+
+    void* p1 = msgpack::memory_pool::allocate(100);
+    void* p2 = msgpack::memory_pool::allocate(128);
+    msgpack::memory_pool::deallocate(p1, 100);
+    // the size class keeps only one block
+    msgpack::memory_pool::deallocate(p2, 128);
+    void* p3 = msgpack::memory_pool::allocate(65);
+    EXPECT_EQ(p1, p3);
+    msgpack::memory_pool::deallocate(p3, 65);
+
+    msgpack::memory_pool_stats s = msgpack::memory_pool::stats();
+    EXPECT_EQ(1u, s.hits);
+    EXPECT_EQ(2u, s.misses);
+    EXPECT_EQ(2u, s.returns);
+    EXPECT_EQ(1u, s.discards);
+
+    msgpack::memory_pool::disable();
+    EXPECT_FALSE(msgpack::memory_pool::enabled());
+    void* p4 = msgpack::memory_pool::allocate(100);
+    msgpack::memory_pool::deallocate(p4, 100);
+    EXPECT_EQ(1u, msgpack::memory_pool::stats().hits);
+    EXPECT_EQ(2u, msgpack::memory_pool::stats().misses);
+}
+
+TEST(memory_pool, object_handle_zone)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, std::string(100, 'a'));
+
+    msgpack::memory_pool::enable();
+    msgpack::memory_pool::reset_stats();
+    {
+        msgpack::object_handle oh = msgpack::unpack(sbuf.data(), sbuf.size());
+        EXPECT_EQ(std::string(100, 'a'), oh.get().as<std::string>());
+    }
+    // the zone object and its chunk
+    EXPECT_EQ(0u, msgpack::memory_pool::stats().hits);
+    EXPECT_EQ(2u, msgpack::memory_pool::stats().returns);
+    {
+        msgpack::object_handle oh = msgpack::unpack(sbuf.data(), sbuf.size());
+        EXPECT_EQ(std::string(100, 'a'), oh.get().as<std::string>());
+    }
+    EXPECT_EQ(2u, msgpack::memory_pool::stats().hits);
+
+    // the first chunk takes the whole block
+    msgpack::zone z;
+    void* p = z.allocate_no_align(MSGPACK_ZONE_CHUNK_SIZE + 100);
+    EXPECT_EQ(3u, msgpack::memory_pool::stats().hits);
+    (void)p;
+    msgpack::memory_pool::disable();
+}
+
+TEST(memory_pool, unpacker_release_zone)
+{
+    msgpack::sbuffer sbuf;
+    for (int i = 0; i < 10; ++i) {
+        msgpack::pack(sbuf, std::string(100, 'a'));
+    }
+
+    msgpack::memory_pool::enable();
+    msgpack::memory_pool::reset_stats();
+    msgpack::unpacker unp;
+    unp.reserve_buffer(sbuf.size());
+    std::memcpy(unp.buffer(), sbuf.data(), sbuf.size());
+    unp.buffer_consumed(sbuf.size());
+    msgpack::object_handle oh;
+    int count = 0;
+    while (unp.next(oh)) {
+        EXPECT_EQ(std::string(100, 'a'), oh.get().as<std::string>());
+        ++count;
+    }
+    EXPECT_EQ(10, count);
+    // each next() gets a zone from the previous object_handle
+    EXPECT_LE(16u, msgpack::memory_pool::stats().hits);
+    msgpack::memory_pool::disable();
+}
+
+TEST(memory_pool, buffers)
+{
+    msgpack::memory_pool::enable();
+    msgpack::memory_pool::reset_stats();
+    std::string str(100, 'b');
+    for (int i = 0; i < 2; ++i) {
+        msgpack::vrefbuffer vbuf;
+        vbuf.write(str.data(), str.size());
+        vbuf.write("c", 1);
+        msgpack::sbuffer sbuf(1024, 0, msgpack::sbuffer_pool_allocator());
+        sbuf.write(str.data(), str.size());
+        sbuf.write(str.data(), str.size());
+        EXPECT_EQ(200u, sbuf.size());
+    }
+    // the chunk of vrefbuffer and the buffer of sbuffer
+    EXPECT_EQ(2u, msgpack::memory_pool::stats().hits);
+
+    msgpack::sbuffer sbuf(0, 0, msgpack::sbuffer_pool_allocator());
+    sbuf.write(str.data(), str.size());
+    sbuf.shrink_to_fit();
+    EXPECT_EQ(100u, sbuf.size());
+    EXPECT_EQ(str, std::string(sbuf.data(), sbuf.size()));
+    std::free(sbuf.release());
+    msgpack::memory_pool::disable();
+}
+
+TEST(memory_pool, thread)
+{
+    msgpack::memory_pool::enable();
+    bool enabled = true;
+    std::thread t([&enabled] { enabled = msgpack::memory_pool::enabled(); });
+    t.join();
+    EXPECT_FALSE(enabled);
+    msgpack::memory_pool::disable();
+}
+
+// Deallocates after the pool state of the thread is destroyed.
+struct late_deallocator {
+    late_deallocator():p(MSGPACK_NULLPTR), enabled(MSGPACK_NULLPTR) {}
+    ~late_deallocator()
+    {
+        msgpack::memory_pool::enable();
+        *enabled = msgpack::memory_pool::enabled();
+        msgpack::memory_pool::deallocate(p, 100);
+    }
+    void* p;
+    bool* enabled;
+};
+
+TEST(memory_pool, thread_exit)
+{
+    bool enabled = true;
+    std::thread t([&enabled] {
+        // constructed before the pool state, so destroyed after it
+        static thread_local late_deallocator d;
+        d.enabled = &enabled;
+        msgpack::memory_pool::enable();
+        d.p = msgpack::memory_pool::allocate(100);
+    });
+    t.join();
+    EXPECT_FALSE(enabled);
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
@@ -0,0 +1,165 @@
+#include <msgpack.hpp>
+#include <msgpack/mmap_unpacker.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(MSGPACK_MMAP_UNPACKER) && MSGPACK_DEFAULT_API_VERSION >= 2
+
+#include <stdlib.h>
+#include <unistd.h>
+
+class mmap_file {
+public:
+    mmap_file(msgpack::sbuffer const& sbuf, std::size_t len) {
+        char name[] = "/tmp/mp.XXXXXX";
+        int fd = mkstemp(name);
+        EXPECT_LT(0, fd);
+        EXPECT_EQ(static_cast<ssize_t>(len), ::write(fd, sbuf.data(), len));
+        ::close(fd);
+        m_name = name;
+    }
+    ~mmap_file() {
+        ::unlink(m_name.c_str());
+    }
+    const char* name() const { return m_name.c_str(); }
+private:
+    std::string m_name;
+};
+
+static void pack_records(msgpack::sbuffer& sbuf)
+{
+    for (int i = 0; i != 100; ++i) {
+        msgpack::packer<msgpack::sbuffer> pk(sbuf);
+        pk.pack_array(3);
+        pk.pack(i);
+        pk.pack(std::string(static_cast<std::size_t>(i), 's'));
+        pk.pack_bin(4);
+        pk.pack_bin_body("bin", 4);
+    }
+}
+
+TEST(mmap_unpacker, next)
+{
+    msgpack::sbuffer sbuf;
+    pack_records(sbuf);
+    mmap_file f(sbuf, sbuf.size());
+
+    msgpack::mmap_unpacker unp(f.name());
+    EXPECT_EQ(sbuf.size(), unp.size());
+    msgpack::object_handle oh;
+    int i = 0;
+    while (unp.next(oh)) {
+        msgpack::object const& o = oh.get();
+        ASSERT_EQ(3u, o.via.array.size);
+        EXPECT_EQ(i, o.via.array.ptr[0].as<int>());
+        EXPECT_EQ(std::string(static_cast<std::size_t>(i), 's'), o.via.array.ptr[1].as<std::string>());
+        // str and bin refer to the mapping
+        const char* str = o.via.array.ptr[1].via.str.ptr;
+        const char* bin = o.via.array.ptr[2].via.bin.ptr;
+        if (i != 0) {
+            EXPECT_TRUE(unp.data() <= str && str < unp.data() + unp.size());
+        }
+        EXPECT_TRUE(unp.data() <= bin && bin < unp.data() + unp.size());
+        EXPECT_EQ(0, memcmp(bin, "bin", 4));
+        ++i;
+    }
+    EXPECT_EQ(100, i);
+    EXPECT_EQ(unp.size(), unp.offset());
+    EXPECT_FALSE(unp.next(oh));
+}
+
+static bool copy_str(msgpack::type::object_type type, std::size_t, void*)
+{
+    return type != msgpack::type::STR;
+}
+
+TEST(mmap_unpacker, reference_func)
+{
+    msgpack::sbuffer sbuf;
+    pack_records(sbuf);
+    mmap_file f(sbuf, sbuf.size());
+
+    msgpack::mmap_unpacker unp(f.name(), copy_str);
+    msgpack::object_handle oh;
+    for (int i = 0; i != 10; ++i) {
+        ASSERT_TRUE(unp.next(oh));
+    }
+    const char* str = oh.get().via.array.ptr[1].via.str.ptr;
+    const char* bin = oh.get().via.array.ptr[2].via.bin.ptr;
+    EXPECT_FALSE(unp.data() <= str && str < unp.data() + unp.size());
+    EXPECT_TRUE(unp.data() <= bin && bin < unp.data() + unp.size());
+}
+
+struct count_visitor : msgpack::null_visitor {
+    count_visitor():m_ints(0) {}
+    bool visit_positive_integer(uint64_t) {
+        ++m_ints;
+        return true;
+    }
+    int m_ints;
+};
+
+TEST(mmap_unpacker, visitor)
+{
+    msgpack::sbuffer sbuf;
+    pack_records(sbuf);
+    mmap_file f(sbuf, sbuf.size());
+
+    msgpack::mmap_unpacker unp(f.name());
+    count_visitor v;
+    int n = 0;
+    while (unp.next(v)) {
+        ++n;
+    }
+    EXPECT_EQ(100, n);
+    EXPECT_EQ(100, v.m_ints);
+}
+
+TEST(mmap_unpacker, insufficient_bytes)
+{
+    msgpack::sbuffer sbuf;
+    pack_records(sbuf);
+    mmap_file f(sbuf, sbuf.size() - 1);
+
+    msgpack::mmap_unpacker unp(f.name());
+    msgpack::object_handle oh;
+    for (int i = 0; i != 99; ++i) {
+        ASSERT_TRUE(unp.next(oh));
+    }
+    std::size_t off = unp.offset();
+    EXPECT_THROW(unp.next(oh), msgpack::insufficient_bytes);
+    EXPECT_EQ(off, unp.offset());
+}
+
+TEST(mmap_unpacker, empty_and_missing)
+{
+    msgpack::sbuffer sbuf;
+    mmap_file f(sbuf, 0);
+    msgpack::mmap_unpacker unp(f.name());
+    msgpack::object_handle oh;
+    EXPECT_EQ(0u, unp.size());
+    EXPECT_FALSE(unp.next(oh));
+
+    EXPECT_THROW(msgpack::mmap_unpacker("/nonexistent/msgpack"), std::runtime_error);
+}
+
+#endif // defined(MSGPACK_MMAP_UNPACKER) && MSGPACK_DEFAULT_API_VERSION >= 2
+
+TEST(mmap_unpacker, dummy)
+{
+}
@@ -1569,3 +1569,44 @@ TEST(buffer, vrefbuffer_map)
         EXPECT_EQ(MSGPACK_OBJECT_POSITIVE_INTEGER, obj.via.map.ptr[0].val.type);
         EXPECT_EQ(3U, obj.via.map.ptr[0].val.via.u64));
 }
+
+TEST(MSGPACKC, zone_init_buffer)
+{
+    msgpack_sbuffer sbuf;
+    msgpack_sbuffer_init(&sbuf);
+    msgpack_packer pk;
+    msgpack_packer_init(&pk, &sbuf, msgpack_sbuffer_write);
+    msgpack_pack_map(&pk, 2);
+    msgpack_pack_int(&pk, 1);
+    msgpack_pack_true(&pk);
+    msgpack_pack_int(&pk, 2);
+    msgpack_pack_false(&pk);
+
+    char buffer[1024];
+    msgpack_zone z;
+    EXPECT_TRUE(msgpack_zone_init_buffer(&z, buffer, sizeof(buffer), 2048));
+    EXPECT_TRUE(msgpack_zone_is_empty(&z));
+    msgpack_object obj;
+    EXPECT_EQ(MSGPACK_UNPACK_SUCCESS, msgpack_unpack(sbuf.data, sbuf.size, NULL, &z, &obj));
+    EXPECT_EQ(MSGPACK_OBJECT_MAP, obj.type);
+    EXPECT_EQ(2u, obj.via.map.size);
+    EXPECT_TRUE(reinterpret_cast<char*>(obj.via.map.ptr) >= buffer);
+    EXPECT_TRUE(reinterpret_cast<char*>(obj.via.map.ptr + 2) <= buffer + sizeof(buffer));
+
+    // spill to the heap, and back to the buffer after clear
+    EXPECT_TRUE(msgpack_zone_malloc(&z, sizeof(buffer)) != NULL);
+    EXPECT_FALSE(msgpack_zone_is_empty(&z));
+    msgpack_zone_clear(&z);
+    EXPECT_TRUE(msgpack_zone_is_empty(&z));
+    char* p = static_cast<char*>(msgpack_zone_malloc(&z, sizeof(buffer) / 2));
+    EXPECT_TRUE(p >= buffer && p < buffer + sizeof(buffer));
+    msgpack_zone_destroy(&z);
+
+    // too small to hold the chunk header
+    EXPECT_TRUE(msgpack_zone_init_buffer(&z, buffer, 1, 2048));
+    p = static_cast<char*>(msgpack_zone_malloc(&z, 16));
+    EXPECT_TRUE(p < buffer || p >= buffer + sizeof(buffer));
+    msgpack_zone_destroy(&z);
+
+    msgpack_sbuffer_destroy(&sbuf);
+}
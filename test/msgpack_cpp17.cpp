@@ -350,4 +350,107 @@ TEST(MSGPACK_CPP17, carray_byte_object_with_zone)
     }
 }
 
+#if defined(MSGPACK_PMR)
+
+// The null resource makes the allocations that are not from the zone throw.
+class pmr_null_default_resource {
+public:
+    pmr_null_default_resource()
+        :m_prev(std::pmr::set_default_resource(std::pmr::null_memory_resource())) {}
+    ~pmr_null_default_resource()
+    {
+        std::pmr::set_default_resource(m_prev);
+    }
+private:
+    std::pmr::memory_resource* m_prev;
+};
+
+TEST(MSGPACK_CPP17, pmr_zone_memory_resource)
+{
+    msgpack::zone z;
+    msgpack::zone_memory_resource r(z);
+    EXPECT_EQ(&z, &r.zone());
+    EXPECT_TRUE(r.is_equal(r));
+    msgpack::zone_memory_resource r2(z);
+    EXPECT_FALSE(r.is_equal(r2));
+
+    std::size_t requested = z.stats().requested;
+    void* p = r.allocate(100, 64);
+    EXPECT_EQ(0u, reinterpret_cast<std::size_t>(p) % 64);
+    EXPECT_LE(requested + 100, z.stats().requested);
+    r.deallocate(p, 100, 64);
+}
+
+TEST(MSGPACK_CPP17, pmr_map_vector_string_as)
+{
+    typedef std::map<std::string, std::vector<std::string> > std_type;
+    typedef std::pmr::map<std::pmr::string, std::pmr::vector<std::pmr::string> > pmr_type;
+    std_type val1;
+    val1["the key that is longer than sso 1"].push_back("the value that is longer than sso 1");
+    val1["the key that is longer than sso 1"].push_back("the value that is longer than sso 2");
+    val1["the key that is longer than sso 2"];
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, val1);
+
+    msgpack::object_handle oh = msgpack::unpack(sbuf.data(), sbuf.size());
+    msgpack::zone_memory_resource r(*oh.zone());
+    std::size_t requested = oh.zone()->stats().requested;
+    pmr_null_default_resource nr;
+    pmr_type val2 = msgpack::as<pmr_type>(oh.get(), &r);
+    EXPECT_LT(requested, oh.zone()->stats().requested);
+    EXPECT_EQ(&r, val2.get_allocator().resource());
+    ASSERT_EQ(2u, val2.size());
+    pmr_type::const_iterator it = val2.begin();
+    EXPECT_EQ(&r, it->first.get_allocator().resource());
+    EXPECT_EQ("the key that is longer than sso 1", it->first);
+    EXPECT_EQ(&r, it->second.get_allocator().resource());
+    ASSERT_EQ(2u, it->second.size());
+    EXPECT_EQ(&r, it->second[1].get_allocator().resource());
+    EXPECT_EQ("the value that is longer than sso 2", it->second[1]);
+    ++it;
+    EXPECT_EQ("the key that is longer than sso 2", it->first);
+    EXPECT_TRUE(it->second.empty());
+
+    // convert() keeps the resource of the destination
+    pmr_type val3(&r);
+    oh.get().convert(val3);
+    EXPECT_TRUE(val2 == val3);
+}
+
+TEST(MSGPACK_CPP17, pmr_unordered_map_as)
+{
+    typedef std::pmr::unordered_map<std::pmr::string, std::pmr::string> pmr_type;
+    msgpack::zone z;
+    msgpack::zone_memory_resource r(z);
+    pmr_type val1(&r);
+    val1["the key that is longer than sso 1"] = "the value that is longer than sso 1";
+    val1["the key that is longer than sso 2"] = "the value that is longer than sso 2";
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, val1);
+
+    msgpack::object_handle oh = msgpack::unpack(sbuf.data(), sbuf.size());
+    pmr_null_default_resource nr;
+    pmr_type val2 = msgpack::as<pmr_type>(oh.get(), &r);
+    EXPECT_EQ(&r, val2.get_allocator().resource());
+    EXPECT_TRUE(val1 == val2);
+    for (pmr_type::const_iterator it = val2.begin(); it != val2.end(); ++it) {
+        EXPECT_EQ(&r, it->first.get_allocator().resource());
+        EXPECT_EQ(&r, it->second.get_allocator().resource());
+    }
+}
+
+TEST(MSGPACK_CPP17, pmr_string_object_with_zone)
+{
+    msgpack::zone z;
+    msgpack::zone_memory_resource r(z);
+    std::pmr::string val1("the string that is longer than sso", &r);
+    msgpack::object obj(val1, z);
+    EXPECT_EQ(msgpack::type::STR, obj.type);
+    std::pmr::string val2 = msgpack::as<std::pmr::string>(obj, &r);
+    EXPECT_EQ(val1, val2);
+    EXPECT_THROW(msgpack::as<std::pmr::string>(msgpack::object(1), &r), msgpack::type_error);
+}
+
+#endif // defined(MSGPACK_PMR)
+
 #endif // !defined(MSGPACK_USE_CPP03) && __cplusplus >= 201703
@@ -11,7 +11,10 @@
 #pragma GCC diagnostic pop
 #endif //defined(__GNUC__)
 
+#include <limits>
 #include <sstream>
+#include <string>
+#include <vector>
 
 TEST(pack, num)
 {
@@ -53,6 +56,112 @@ struct myclass {
 };
 
 
+template <typename T>
+static void check_array_body(std::vector<T> const& v)
+{
+    uint32_t size = static_cast<uint32_t>(v.size());
+    std::stringstream expected;
+    msgpack::packer<std::stringstream> epk(expected);
+    epk.pack_array(size);
+    for (std::size_t i = 0; i != v.size(); ++i) {
+        epk.pack(v[i]);
+    }
+
+    msgpack::sbuffer sbuf;
+    msgpack::packer<msgpack::sbuffer> spk(sbuf);
+    spk.pack_array(size);
+    if (size != 0) spk.pack_array_body(&v.front(), size);
+    EXPECT_EQ(expected.str(), std::string(sbuf.data(), sbuf.size()));
+
+    std::stringstream ss;
+    msgpack::packer<std::stringstream> pk(ss);
+    pk.pack_array(size);
+    if (size != 0) pk.pack_array_body(&v.front(), size);
+    EXPECT_EQ(expected.str(), ss.str());
+}
+
+template <typename T>
+static void check_integer_array_body()
+{
+    static const long long boundaries[] = {
+        0, 1, 31, 32, 127, 128, 255, 256, 65535, 65536,
+        4294967295LL, 4294967296LL,
+        -1, -32, -33, -128, -129, -32768, -32769,
+        -2147483647LL - 1, -2147483647LL - 2
+    };
+    std::vector<T> v;
+    v.push_back(std::numeric_limits<T>::min());
+    v.push_back(std::numeric_limits<T>::max());
+    for (std::size_t i = 0; i != sizeof(boundaries) / sizeof(boundaries[0]); ++i) {
+        v.push_back(static_cast<T>(boundaries[i]));
+    }
+    // more than a batch
+    for (int i = 0; i != 300; ++i) {
+        v.push_back(static_cast<T>(i * 997));
+    }
+    check_array_body(v);
+}
+
+TEST(pack, array_body)
+{
+    check_integer_array_body<char>();
+    check_integer_array_body<signed char>();
+    check_integer_array_body<unsigned char>();
+    check_integer_array_body<short>();
+    check_integer_array_body<unsigned short>();
+    check_integer_array_body<int>();
+    check_integer_array_body<unsigned int>();
+    check_integer_array_body<long>();
+    check_integer_array_body<unsigned long>();
+    check_integer_array_body<long long>();
+    check_integer_array_body<unsigned long long>();
+
+    std::vector<float> f;
+    std::vector<double> d;
+    for (int i = 0; i != 200; ++i) {
+        f.push_back(static_cast<float>(i) * -0.5f);
+        d.push_back(static_cast<double>(i) * 1.25);
+    }
+    f.push_back(std::numeric_limits<float>::max());
+    d.push_back(std::numeric_limits<double>::min());
+    check_array_body(f);
+    check_array_body(d);
+
+    check_array_body(std::vector<std::string>(3, "abc"));
+    check_array_body(std::vector<int>());
+
+    std::vector<int> v(100, -100000);
+    std::stringstream expected;
+    msgpack::packer<std::stringstream> epk(expected);
+    epk.pack_array(100);
+    for (int i = 0; i != 100; ++i) epk.pack(-100000);
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, v);
+    EXPECT_EQ(expected.str(), std::string(sbuf.data(), sbuf.size()));
+}
+
+TEST(pack, carray_body)
+{
+    int a[70];
+    bool b[3] = { true, false, true };
+    std::stringstream expected;
+    msgpack::packer<std::stringstream> epk(expected);
+    epk.pack_array(70);
+    for (int i = 0; i != 70; ++i) {
+        a[i] = (i - 35) * 1000;
+        epk.pack(a[i]);
+    }
+    epk.pack_array(3);
+    epk.pack(true);
+    epk.pack(false);
+    epk.pack(true);
+
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, a);
+    msgpack::pack(sbuf, b);
+    EXPECT_EQ(expected.str(), std::string(sbuf.data(), sbuf.size()));
+}
+
 TEST(pack, myclass)
 {
     msgpack::sbuffer sbuf;
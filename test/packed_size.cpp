@@ -0,0 +1,165 @@
+#include <msgpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <cstring>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+template <typename T>
+static void check_packed_size(T const& v)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, v);
+    EXPECT_EQ(sbuf.size(), msgpack::packed_size(v));
+}
+
+template <typename T>
+static void check_integer()
+{
+    check_packed_size(std::numeric_limits<T>::min());
+    check_packed_size(std::numeric_limits<T>::max());
+    check_packed_size(static_cast<T>(0));
+    check_packed_size(static_cast<T>(127));
+    check_packed_size(static_cast<T>(-32));
+    check_packed_size(static_cast<T>(-33));
+    EXPECT_EQ(1 + sizeof(T), msgpack::max_packed_size<T>::value);
+
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, std::numeric_limits<T>::min());
+    EXPECT_GE(msgpack::max_packed_size<T>::value, sbuf.size());
+    sbuf.clear();
+    msgpack::pack(sbuf, std::numeric_limits<T>::max());
+    EXPECT_GE(msgpack::max_packed_size<T>::value, sbuf.size());
+}
+
+struct packed_size_array {
+    int a;
+    std::string b;
+    MSGPACK_DEFINE_ARRAY(a, b);
+};
+
+struct packed_size_map {
+    std::vector<packed_size_array> v;
+    std::map<std::string, double> m;
+    MSGPACK_DEFINE_MAP(v, m);
+};
+
+TEST(packed_size, scalar)
+{
+    check_integer<char>();
+    check_integer<signed char>();
+    check_integer<unsigned char>();
+    check_integer<short>();
+    check_integer<unsigned short>();
+    check_integer<int>();
+    check_integer<unsigned int>();
+    check_integer<long>();
+    check_integer<unsigned long>();
+    check_integer<long long>();
+    check_integer<unsigned long long>();
+    check_packed_size(1.5f);
+    check_packed_size(1.5);
+    check_packed_size(true);
+    check_packed_size(msgpack::type::nil_t());
+    EXPECT_EQ(5u, msgpack::max_packed_size<float>::value);
+    EXPECT_EQ(9u, msgpack::max_packed_size<double>::value);
+    EXPECT_EQ(1u, msgpack::max_packed_size<bool>::value);
+    EXPECT_EQ(1u, msgpack::max_packed_size<msgpack::type::nil_t>::value);
+}
+
+TEST(packed_size, str_bin_ext)
+{
+    std::size_t const sizes[] = { 0, 31, 32, 255, 256, 65535, 65536 };
+    for (std::size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+        check_packed_size(std::string(sizes[i], 'a'));
+        check_packed_size(std::vector<char>(sizes[i], 'a'));
+        check_packed_size(std::vector<int>(sizes[i], 1));
+        msgpack::type::ext e(1, std::string(sizes[i], 'a').data(), static_cast<uint32_t>(sizes[i]));
+        check_packed_size(e);
+    }
+}
+
+TEST(packed_size, counter_large_prepare)
+{
+    msgpack::v1::detail::packed_size_counter c;
+    const std::size_t len = 100000;
+    char* p = c.prepare(len);
+    std::memset(p, 0, len);
+    c.commit(len);
+    c.write(p, 5);
+    EXPECT_EQ(len + 5, c.size());
+}
+
+TEST(packed_size, define)
+{
+    packed_size_map m;
+    packed_size_array a;
+    a.a = 1000;
+    a.b = "abc";
+    m.v.push_back(a);
+    m.v.push_back(a);
+    m.m["x"] = 1.0;
+    m.m["y"] = 2.0;
+    check_packed_size(m);
+    check_packed_size(a);
+
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, m);
+    msgpack::object_handle oh = msgpack::unpack(sbuf.data(), sbuf.size());
+    check_packed_size(oh.get());
+}
+
+TEST(packed_size, fixed_shape)
+{
+    int a[3] = { 1, -1000000, 70000 };
+    check_packed_size(a);
+    EXPECT_EQ(1u + 3u * 5u, msgpack::max_packed_size<int[3]>::value);
+
+    unsigned char b[300] = { 0 };
+    check_packed_size(b);
+    EXPECT_EQ(msgpack::packed_size(b), msgpack::max_packed_size<unsigned char[300]>::value);
+
+    char c[4] = "ab";
+    check_packed_size(c);
+    EXPECT_EQ(5u, msgpack::max_packed_size<char[4]>::value);
+
+    std::pair<int, double> p(1, 2.0);
+    check_packed_size(p);
+    EXPECT_EQ(1u + 5u + 9u, (msgpack::max_packed_size<std::pair<int, double> >::value));
+
+    EXPECT_EQ(3u + 20u * 9u, msgpack::max_packed_size<double[20]>::value);
+}
+
+#if !defined(MSGPACK_USE_CPP03)
+
+TEST(packed_size, fixed_shape_cpp11)
+{
+    std::array<uint32_t, 4> a = {{ 1, 2, 70000, 4000000000u }};
+    check_packed_size(a);
+    static_assert(msgpack::max_packed_size<std::array<uint32_t, 4>>::value == 1 + 4 * 5, "");
+
+    std::array<char, 16> b = {{ 0 }};
+    check_packed_size(b);
+    static_assert(msgpack::max_packed_size<std::array<char, 16>>::value == 18, "");
+
+    std::tuple<bool, int8_t, std::pair<float, uint64_t>, std::array<int16_t, 2>> t(
+        true, int8_t(-1), std::make_pair(1.0f, uint64_t(1) << 40), std::array<int16_t, 2>{{ 1, -300 }});
+    check_packed_size(t);
+    static_assert(msgpack::max_packed_size<decltype(t)>::value == 1 + 1 + 2 + (1 + 5 + 9) + (1 + 3 + 3), "");
+    char buf[msgpack::max_packed_size<decltype(t)>::value];
+    EXPECT_GE(sizeof(buf), msgpack::packed_size(t));
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
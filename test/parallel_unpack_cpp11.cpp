@@ -0,0 +1,132 @@
+#include <msgpack.hpp>
+#include <msgpack/parallel_unpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <map>
+#include <string>
+#include <vector>
+
+#if !defined(MSGPACK_USE_CPP03)
+
+static void pack_messages(msgpack::sbuffer& sbuf, int num)
+{
+    for (int i = 0; i < num; ++i) {
+        std::map<std::string, std::vector<int> > m;
+        m["key"] = std::vector<int>(static_cast<std::size_t>(i % 7), i);
+        msgpack::pack(sbuf, m);
+        msgpack::pack(sbuf, std::string(static_cast<std::size_t>(i % 40), 'x'));
+    }
+}
+
+static void check_parallel_unpack(std::size_t num_threads)
+{
+    msgpack::sbuffer sbuf;
+    pack_messages(sbuf, 100);
+
+    std::vector<msgpack::object_handle> expected;
+    std::size_t off = 0;
+    while (off != sbuf.size()) {
+        expected.push_back(msgpack::unpack(sbuf.data(), sbuf.size(), off));
+    }
+
+    std::vector<msgpack::object_handle> result;
+    off = 0;
+    msgpack::parallel_unpack(result, sbuf.data(), sbuf.size(), off, num_threads);
+    EXPECT_EQ(sbuf.size(), off);
+    ASSERT_EQ(expected.size(), result.size());
+    for (std::size_t i = 0; i != result.size(); ++i) {
+        EXPECT_EQ(expected[i].get(), result[i].get());
+    }
+}
+
+TEST(parallel_unpack, single_thread)
+{
+    check_parallel_unpack(1);
+}
+
+TEST(parallel_unpack, multi_thread)
+{
+    check_parallel_unpack(4);
+}
+
+TEST(parallel_unpack, default_threads)
+{
+    check_parallel_unpack(0);
+}
+
+TEST(parallel_unpack, more_threads_than_objects)
+{
+    check_parallel_unpack(1000);
+}
+
+TEST(parallel_unpack, offset_and_partial)
+{
+    msgpack::sbuffer sbuf;
+    sbuf.write("\xc0", 1);
+    msgpack::pack(sbuf, 1);
+    msgpack::pack(sbuf, "abc");
+    std::size_t complete = sbuf.size();
+    sbuf.write("\x93\x01", 2);
+
+    std::vector<msgpack::object_handle> result;
+    std::size_t off = 1;
+    msgpack::parallel_unpack(result, sbuf.data(), sbuf.size(), off, 2);
+    EXPECT_EQ(complete, off);
+    ASSERT_EQ(2u, result.size());
+    EXPECT_EQ(1, result[0].get().as<int>());
+    EXPECT_EQ("abc", result[1].get().as<std::string>());
+}
+
+TEST(parallel_unpack, empty)
+{
+    std::vector<msgpack::object_handle> result(1);
+    std::size_t off = 0;
+    msgpack::parallel_unpack(result, "", 0, off);
+    EXPECT_EQ(0u, off);
+    EXPECT_TRUE(result.empty());
+}
+
+TEST(parallel_unpack, parse_error)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, 1);
+    sbuf.write("\xc1", 1);
+
+    std::vector<msgpack::object_handle> result;
+    std::size_t off = 0;
+    EXPECT_THROW(msgpack::parallel_unpack(result, sbuf.data(), sbuf.size(), off, 2),
+                 msgpack::parse_error);
+    EXPECT_EQ(0u, off);
+}
+
+TEST(parallel_unpack, limit_error)
+{
+    msgpack::sbuffer sbuf;
+    pack_messages(sbuf, 10);
+    msgpack::pack(sbuf, std::vector<int>(10));
+
+    std::vector<msgpack::object_handle> result;
+    std::size_t off = 0;
+    EXPECT_THROW(msgpack::parallel_unpack(result, sbuf.data(), sbuf.size(), off, 3,
+                                          MSGPACK_NULLPTR, MSGPACK_NULLPTR,
+                                          msgpack::unpack_limit(9, 10)),
+                 msgpack::array_size_overflow);
+    EXPECT_EQ(0u, off);
+    EXPECT_TRUE(result.empty());
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+TEST(parallel_unpack, dummy)
+{
+}
@@ -0,0 +1,169 @@
+#include <msgpack.hpp>
+#include <msgpack/parallel_zbuffer.hpp>
+#include <msgpack/zbuffer.hpp>
+#include <msgpack/zunpacker.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <string>
+#include <vector>
+
+#if !defined(MSGPACK_USE_CPP03)
+
+static std::string inflate_all(const char* data, std::size_t len)
+{
+    msgpack::sbuffer sbuf;
+    z_stream s;
+    s.zalloc = Z_NULL;
+    s.zfree = Z_NULL;
+    s.opaque = Z_NULL;
+    s.next_in = Z_NULL;
+    s.avail_in = 0;
+    EXPECT_EQ(Z_OK, inflateInit(&s));
+    s.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data));
+    s.avail_in = static_cast<uInt>(len);
+    int ret = Z_OK;
+    while (ret == Z_OK) {
+        char* p = sbuf.prepare(4096);
+        s.next_out = reinterpret_cast<Bytef*>(p);
+        s.avail_out = 4096;
+        ret = inflate(&s, Z_NO_FLUSH);
+        sbuf.commit(4096 - s.avail_out);
+    }
+    EXPECT_EQ(Z_STREAM_END, ret);
+    EXPECT_EQ(0u, s.avail_in);
+    inflateEnd(&s);
+    return std::string(sbuf.data(), sbuf.size());
+}
+
+static std::string make_input(std::size_t n)
+{
+    msgpack::sbuffer sbuf;
+    for (std::size_t i = 0; i != n; ++i) {
+        msgpack::pack(sbuf, std::make_tuple(i, std::string(i % 50, 'a'), static_cast<double>(i) * 0.5));
+    }
+    return std::string(sbuf.data(), sbuf.size());
+}
+
+TEST(parallel_zbuffer, zlib_stream)
+{
+    std::string input = make_input(10000);
+    for (std::size_t block_size : {100u, 1000u, 65536u, 1000000u}) {
+        for (int level : {Z_DEFAULT_COMPRESSION, 1, 9}) {
+            msgpack::parallel_zbuffer pz(level, block_size, 4);
+            // written in uneven pieces
+            for (std::size_t off = 0; off < input.size(); off += 777) {
+                pz.write(input.data() + off, std::min<std::size_t>(777, input.size() - off));
+            }
+            pz.flush();
+            EXPECT_EQ(input, inflate_all(pz.data(), pz.size()));
+        }
+    }
+}
+
+TEST(parallel_zbuffer, empty)
+{
+    msgpack::parallel_zbuffer pz;
+    pz.flush();
+    EXPECT_EQ(std::string(), inflate_all(pz.data(), pz.size()));
+}
+
+TEST(parallel_zbuffer, ratio)
+{
+    // the blocks are primed with the previous block
+    std::string input = make_input(100000);
+    msgpack::parallel_zbuffer pz(Z_DEFAULT_COMPRESSION, 16384, 4);
+    msgpack::zbuffer z;
+    pz.write(input.data(), input.size());
+    z.write(input.data(), input.size());
+    pz.flush();
+    z.flush();
+    EXPECT_GT(z.size() * 11 / 10, pz.size());
+}
+
+TEST(parallel_zbuffer, reset_and_zunpacker)
+{
+    msgpack::parallel_zbuffer pz(Z_DEFAULT_COMPRESSION, 100, 2);
+    msgpack::unpacker unp;
+    msgpack::zunpacker zunp;
+    for (int n = 0; n != 3; ++n) {
+        for (int i = 0; i != 1000; ++i) {
+            msgpack::pack(pz, i + n);
+        }
+        pz.flush();
+        zunp.feed(pz.data(), pz.size());
+        msgpack::object_handle oh;
+        for (int i = 0; i != 1000; ++i) {
+            ASSERT_TRUE(zunp.next(unp, oh));
+            EXPECT_EQ(i + n, oh.get().as<int>());
+        }
+        EXPECT_FALSE(zunp.next(unp, oh));
+        pz.reset();
+        EXPECT_EQ(0u, pz.size());
+    }
+}
+
+TEST(parallel_zbuffer, reset_buffer)
+{
+    // the compressed data is taken in pieces while writing
+    std::string input = make_input(10000);
+    msgpack::parallel_zbuffer pz(Z_DEFAULT_COMPRESSION, 1000, 3);
+    std::string compressed;
+    for (std::size_t off = 0; off < input.size(); off += 5000) {
+        pz.write(input.data() + off, std::min<std::size_t>(5000, input.size() - off));
+        compressed.append(pz.data(), pz.size());
+        pz.reset_buffer();
+    }
+    pz.flush();
+    compressed.append(pz.data(), pz.size());
+    EXPECT_EQ(input, inflate_all(compressed.data(), compressed.size()));
+
+    char* p = pz.release_buffer();
+    EXPECT_TRUE(p != MSGPACK_NULLPTR);
+    EXPECT_TRUE(pz.data() == MSGPACK_NULLPTR);
+    free(p);
+}
+
+TEST(parallel_zbuffer, flush_twice)
+{
+    std::string input = make_input(1000);
+    msgpack::parallel_zbuffer pz(Z_DEFAULT_COMPRESSION, 1000, 2);
+    pz.write(input.data(), input.size());
+    char* p = pz.flush();
+    std::size_t size = pz.size();
+    EXPECT_EQ(p, pz.flush());
+    EXPECT_EQ(size, pz.size());
+    EXPECT_EQ(input, inflate_all(pz.data(), pz.size()));
+    EXPECT_THROW(pz.write("a", 1), std::logic_error);
+    pz.reset();
+    pz.write(input.data(), input.size());
+    pz.flush();
+    EXPECT_EQ(input, inflate_all(pz.data(), pz.size()));
+}
+
+TEST(parallel_zbuffer, reset_while_compressing)
+{
+    // the queued blocks are dropped
+    std::string input = make_input(10000);
+    msgpack::parallel_zbuffer pz(9, 100, 2);
+    pz.write(input.data(), input.size());
+    pz.reset();
+    pz.write(input.data(), 1000);
+    pz.flush();
+    EXPECT_EQ(input.substr(0, 1000), inflate_all(pz.data(), pz.size()));
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
+
+TEST(parallel_zbuffer, dummy)
+{
+}
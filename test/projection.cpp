@@ -0,0 +1,267 @@
+#include <msgpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <map>
+#include <string>
+#include <vector>
+#include <utility>
+#include <stdexcept>
+
+struct collector {
+    collector(std::vector<std::pair<std::size_t, msgpack::object> >& r):m_r(r) {}
+    void operator()(std::size_t index, msgpack::object const& obj) const {
+        m_r.push_back(std::make_pair(index, obj));
+    }
+    std::vector<std::pair<std::size_t, msgpack::object> >& m_r;
+};
+
+static void pack_message(msgpack::sbuffer& sbuf)
+{
+    msgpack::packer<msgpack::sbuffer> pk(sbuf);
+    pk.pack_map(6);
+    pk.pack(std::string("pad1"));
+    pk.pack(std::vector<int>(10, 1));
+    pk.pack(std::string("user"));
+    pk.pack_map(3);
+    pk.pack(std::string("name"));
+    pk.pack(std::string("alice"));
+    pk.pack(std::string("id"));
+    pk.pack(42);
+    pk.pack(std::string("tags"));
+    pk.pack(std::vector<std::string>(2, "t"));
+    pk.pack(std::string("items"));
+    pk.pack_array(3);
+    for (int i = 0; i < 3; ++i) {
+        pk.pack_map(2);
+        pk.pack(std::string("price"));
+        pk.pack(1.5 * i);
+        pk.pack(std::string("qty"));
+        pk.pack(i);
+    }
+    pk.pack(std::string("meta"));
+    std::map<std::string, int> meta;
+    meta["ts"] = 123;
+    meta["seq"] = 7;
+    pk.pack(meta);
+    pk.pack(1);
+    pk.pack(std::string("int key"));
+    pk.pack(std::string("pad2"));
+    pk.pack(std::map<std::string, std::string>());
+}
+
+TEST(projection, paths)
+{
+    msgpack::sbuffer sbuf;
+    pack_message(sbuf);
+
+    msgpack::projection p;
+    std::size_t user_id = p.add("user.id");
+    std::size_t price = p.add("items[*].price");
+    std::size_t ts = p.add("meta.ts");
+    std::size_t none = p.add("meta.none");
+    EXPECT_EQ(4u, p.size());
+    EXPECT_EQ("items[*].price", p.path(price));
+
+    msgpack::zone z;
+    std::vector<std::pair<std::size_t, msgpack::object> > r;
+    msgpack::projection_visitor<collector> v(p, z, collector(r));
+    EXPECT_TRUE(msgpack::parse(sbuf.data(), sbuf.size(), v));
+
+    ASSERT_EQ(5u, r.size());
+    EXPECT_EQ(user_id, r[0].first);
+    EXPECT_EQ(42, r[0].second.as<int>());
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(price, r[i + 1].first);
+        EXPECT_EQ(1.5 * static_cast<double>(i), r[i + 1].second.as<double>());
+    }
+    EXPECT_EQ(ts, r[4].first);
+    EXPECT_EQ(123, r[4].second.as<int>());
+    EXPECT_NE(none, r[4].first);
+}
+
+TEST(projection, container_and_prefix)
+{
+    msgpack::sbuffer sbuf;
+    pack_message(sbuf);
+
+    msgpack::projection p;
+    std::size_t user = p.add("user");
+    std::size_t name = p.add("user.name");
+    std::size_t tag = p.add("user.tags[1]");
+    std::size_t qty = p.add("items[2].qty");
+    EXPECT_EQ(name, p.add("user.name"));
+
+    msgpack::zone z;
+    std::vector<std::pair<std::size_t, msgpack::object> > r;
+    msgpack::projection_visitor<collector> v(p, z, collector(r));
+    EXPECT_TRUE(msgpack::parse(sbuf.data(), sbuf.size(), v));
+
+    ASSERT_EQ(4u, r.size());
+    EXPECT_EQ(user, r[0].first);
+    EXPECT_EQ(msgpack::type::MAP, r[0].second.type);
+    EXPECT_EQ(3u, r[0].second.via.map.size);
+    EXPECT_EQ(name, r[1].first);
+    EXPECT_EQ("alice", r[1].second.as<std::string>());
+    EXPECT_EQ(tag, r[2].first);
+    EXPECT_EQ("t", r[2].second.as<std::string>());
+    EXPECT_EQ(qty, r[3].first);
+    EXPECT_EQ(2, r[3].second.as<int>());
+}
+
+TEST(projection, root)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, std::string("abc"));
+    msgpack::pack(sbuf, 2);
+
+    msgpack::projection p;
+    p.add("");
+
+    msgpack::zone z;
+    std::vector<std::pair<std::size_t, msgpack::object> > r;
+    msgpack::projection_visitor<collector> v(p, z, collector(r));
+    std::size_t off = 0;
+    EXPECT_TRUE(msgpack::parse(sbuf.data(), sbuf.size(), off, v));
+    EXPECT_TRUE(msgpack::parse(sbuf.data(), sbuf.size(), off, v));
+    EXPECT_EQ(sbuf.size(), off);
+    ASSERT_EQ(2u, r.size());
+    EXPECT_EQ("abc", r[0].second.as<std::string>());
+    EXPECT_EQ(2, r[1].second.as<int>());
+}
+
+TEST(projection, reuse)
+{
+    msgpack::sbuffer sbuf;
+    pack_message(sbuf);
+    pack_message(sbuf);
+
+    msgpack::projection p;
+    p.add("meta.seq");
+
+    msgpack::zone z;
+    std::vector<std::pair<std::size_t, msgpack::object> > r;
+    msgpack::projection_visitor<collector> v(p, z, collector(r));
+    std::size_t off = 0;
+    EXPECT_TRUE(msgpack::parse(sbuf.data(), sbuf.size(), off, v));
+    EXPECT_TRUE(msgpack::parse(sbuf.data(), sbuf.size(), off, v));
+    ASSERT_EQ(2u, r.size());
+    EXPECT_EQ(7, r[0].second.as<int>());
+    EXPECT_EQ(7, r[1].second.as<int>());
+}
+
+TEST(projection, type_mismatch)
+{
+    msgpack::sbuffer sbuf;
+    pack_message(sbuf);
+
+    msgpack::projection p;
+    p.add("user.id.x");
+    p.add("user[0]");
+    p.add("meta[*]");
+    p.add("items.price");
+
+    msgpack::zone z;
+    std::vector<std::pair<std::size_t, msgpack::object> > r;
+    msgpack::projection_visitor<collector> v(p, z, collector(r));
+    EXPECT_TRUE(msgpack::parse(sbuf.data(), sbuf.size(), v));
+    EXPECT_TRUE(r.empty());
+}
+
+TEST(projection, insufficient_bytes)
+{
+    msgpack::sbuffer sbuf;
+    pack_message(sbuf);
+
+    msgpack::projection p;
+    p.add("pad2");
+
+    msgpack::zone z;
+    std::vector<std::pair<std::size_t, msgpack::object> > r;
+    msgpack::projection_visitor<collector> v(p, z, collector(r));
+    EXPECT_FALSE(msgpack::parse(sbuf.data(), 20, v));
+}
+
+TEST(projection, parse_error)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::packer<msgpack::sbuffer> pk(sbuf);
+    pk.pack_map(2);
+    pk.pack(std::string("a"));
+    pk.pack_array(1);
+    sbuf.write("\xc1", 1);
+    pk.pack(std::string("b"));
+    pk.pack(1);
+
+    msgpack::projection p;
+    p.add("b");
+
+    msgpack::zone z;
+    std::vector<std::pair<std::size_t, msgpack::object> > r;
+    msgpack::projection_visitor<collector> v(p, z, collector(r));
+    EXPECT_FALSE(msgpack::parse(sbuf.data(), sbuf.size(), v));
+}
+
+TEST(projection, invalid_path)
+{
+    msgpack::projection p;
+    EXPECT_THROW(p.add("a..b"), std::invalid_argument);
+    EXPECT_THROW(p.add(".a"), std::invalid_argument);
+    EXPECT_THROW(p.add("a."), std::invalid_argument);
+    EXPECT_THROW(p.add("a[]"), std::invalid_argument);
+    EXPECT_THROW(p.add("a[1"), std::invalid_argument);
+    EXPECT_THROW(p.add("a[x]"), std::invalid_argument);
+    EXPECT_THROW(p.add("a[4294967296]"), std::invalid_argument);
+    EXPECT_THROW(p.add("a[0]b"), std::invalid_argument);
+    p.add("a[0]");
+    EXPECT_THROW(p.add("a[*]"), std::invalid_argument);
+    EXPECT_EQ(1u, p.size());
+}
+
+#if !defined(MSGPACK_USE_CPP03)
+
+struct skip_map_value_visitor : msgpack::null_visitor {
+    skip_map_value_visitor():m_skip(false), m_count(0) {}
+    bool skip_value() const { return m_skip; }
+    bool visit_positive_integer(uint64_t) {
+        ++m_count;
+        return true;
+    }
+    bool start_map_value() {
+        m_skip = true;
+        return true;
+    }
+    bool end_map_value() {
+        m_skip = false;
+        return true;
+    }
+    bool m_skip;
+    int m_count;
+};
+
+TEST(projection, skip_value)
+{
+    std::map<int, std::vector<int> > m;
+    m[1] = std::vector<int>(3, 2);
+    m[2] = std::vector<int>(4, 3);
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, m);
+
+    skip_map_value_visitor v;
+    EXPECT_TRUE(msgpack::parse(sbuf.data(), sbuf.size(), v));
+    // only the keys are visited
+    EXPECT_EQ(2, v.m_count);
+
+    EXPECT_FALSE(msgpack::parse(sbuf.data(), sbuf.size() - 1, v));
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
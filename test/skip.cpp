@@ -0,0 +1,131 @@
+#include <msgpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <sstream>
+#include <string>
+
+// To avoid link error
+TEST(skip, dummy)
+{
+}
+
+#if MSGPACK_DEFAULT_API_VERSION >= 2
+
+namespace {
+
+std::string make_all_types()
+{
+    std::stringstream ss;
+    msgpack::packer<std::stringstream> pk(ss);
+    pk.pack_nil();
+    pk.pack_true();
+    pk.pack_false();
+    pk.pack_fix_uint8(1);
+    pk.pack_uint8(200);
+    pk.pack_uint16(60000);
+    pk.pack_uint32(4000000000u);
+    pk.pack_uint64(1ULL << 40);
+    pk.pack_fix_int8(-1);
+    pk.pack_int8(-100);
+    pk.pack_int16(-30000);
+    pk.pack_int32(-2000000000);
+    pk.pack_int64(-(1LL << 40));
+    pk.pack_float(1.5f);
+    pk.pack_double(-2.5);
+    pk.pack(std::string("abc"));
+    pk.pack(std::string(300, 'x'));
+    pk.pack(std::string(70000, 'y'));
+    pk.pack_bin(2);
+    pk.pack_bin_body("\x01\x02", 2);
+    pk.pack_ext(1, 1);
+    pk.pack_ext_body("\x01", 1);
+    pk.pack_ext(3, 1);
+    pk.pack_ext_body("\x01\x02\x03", 3);
+    pk.pack_array(3);
+    pk.pack_map(1);
+    pk.pack(std::string(""));
+    pk.pack_array(0);
+    pk.pack_array(20);
+    for (int i = 0; i != 20; ++i) pk.pack(i);
+    pk.pack_map(0);
+    pk.pack_map(20);
+    for (int i = 0; i != 20; ++i) {
+        pk.pack(i);
+        pk.pack_array(1);
+        pk.pack_nil();
+    }
+    return ss.str();
+}
+
+} // anonymous namespace
+
+TEST(skip, same_as_parse)
+{
+    std::string str = make_all_types();
+    std::size_t parse_off = 0;
+    std::size_t skip_off = 0;
+    while (parse_off != str.size()) {
+        msgpack::null_visitor v;
+        EXPECT_TRUE(msgpack::parse(str.data(), str.size(), parse_off, v));
+        msgpack::parse_return ret = msgpack::skip(str.data(), str.size(), skip_off);
+        EXPECT_TRUE(ret == msgpack::PARSE_EXTRA_BYTES || ret == msgpack::PARSE_SUCCESS);
+        EXPECT_EQ(parse_off, skip_off);
+    }
+}
+
+TEST(skip, insufficient_bytes)
+{
+    std::string str = make_all_types();
+    std::size_t off = 0;
+    while (off != str.size()) {
+        std::size_t next = off;
+        msgpack::skip(str.data(), str.size(), next);
+        for (std::size_t len = off; len != next; ++len) {
+            std::size_t noff = off;
+            EXPECT_EQ(msgpack::PARSE_CONTINUE, msgpack::skip(str.data(), len, noff));
+            EXPECT_EQ(off, noff);
+        }
+        EXPECT_EQ(msgpack::PARSE_SUCCESS, msgpack::skip(str.data(), next, off));
+        EXPECT_EQ(next, off);
+    }
+}
+
+TEST(skip, parse_error)
+{
+    char const data[] = { static_cast<char>(0x92u), 0x01, static_cast<char>(0xc1u) };
+    std::size_t off = 0;
+    EXPECT_EQ(msgpack::PARSE_PARSE_ERROR, msgpack::skip(data, sizeof(data), off));
+    EXPECT_EQ(0u, off);
+    EXPECT_THROW(msgpack::encoded_size(data, sizeof(data)), msgpack::parse_error);
+}
+
+TEST(skip, deep_nesting)
+{
+    // No stack is used, so there is no depth limit.
+    std::string str(100000, static_cast<char>(0x91u));
+    str.push_back(static_cast<char>(0xc0u));
+    EXPECT_EQ(str.size(), msgpack::encoded_size(str.data(), str.size()));
+    EXPECT_THROW(msgpack::encoded_size(str.data(), str.size() - 1), msgpack::insufficient_bytes);
+}
+
+TEST(skip, encoded_size)
+{
+    std::stringstream ss;
+    msgpack::pack(ss, std::string(100, 'a'));
+    msgpack::pack(ss, 1);
+    std::string str = ss.str();
+    EXPECT_EQ(str.size() - 1, msgpack::encoded_size(str.data(), str.size()));
+    EXPECT_THROW(msgpack::encoded_size(str.data(), 0), msgpack::insufficient_bytes);
+}
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2
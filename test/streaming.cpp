@@ -11,7 +11,11 @@
 #pragma GCC diagnostic pop
 #endif //defined(__GNUC__)
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
+#include <string>
+#include <vector>
 
 TEST(streaming, basic)
 {
@@ -169,6 +173,170 @@ TEST(streaming, move)
 
 #endif // !defined(MSGPACK_USE_CPP03)
 
+#if MSGPACK_DEFAULT_API_VERSION >= 2 && !defined(MSGPACK_USE_CPP03)
+
+static void count_release(void* user_data)
+{
+    ++*static_cast<int*>(user_data);
+}
+
+static bool in_buffer(msgpack::sbuffer const& buffer, const char* p)
+{
+    return buffer.data() <= p && p < buffer.data() + buffer.size();
+}
+
+TEST(streaming, feed)
+{
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> pk(buffer);
+    pk.pack(1);
+    pk.pack(std::string(300, 'a'));
+    pk.pack_array(3);
+    pk.pack(std::string("abc"));
+    pk.pack(2.5);
+    pk.pack(std::vector<char>(70000, 'b'));
+
+    for (std::size_t chunk_size = 1; chunk_size <= buffer.size(); chunk_size = chunk_size * 3 + 1) {
+        std::vector<int> released((buffer.size() + chunk_size - 1) / chunk_size);
+        {
+            msgpack::unpacker pac;
+            std::vector<msgpack::object_handle> ohs;
+            for (std::size_t i = 0; i < released.size(); ++i) {
+                std::size_t off = i * chunk_size;
+                pac.feed(buffer.data() + off, std::min(chunk_size, buffer.size() - off),
+                         count_release, &released[i]);
+                msgpack::object_handle oh;
+                while (pac.next(oh)) {
+                    ohs.push_back(msgpack::move(oh));
+                }
+            }
+            EXPECT_EQ(0u, pac.fed_size());
+            ASSERT_EQ(3u, ohs.size());
+            EXPECT_EQ(1, ohs[0]->as<int>());
+            EXPECT_EQ(std::string(300, 'a'), ohs[1]->as<std::string>());
+            msgpack::object const& arr = ohs[2].get();
+            ASSERT_EQ(3u, arr.via.array.size);
+            EXPECT_EQ("abc", arr.via.array.ptr[0].as<std::string>());
+            EXPECT_EQ(2.5, arr.via.array.ptr[1].as<double>());
+            EXPECT_EQ(std::vector<char>(70000, 'b'), arr.via.array.ptr[2].as<std::vector<char> >());
+            if (chunk_size == buffer.size()) {
+                // no value spans buffers
+                EXPECT_TRUE(in_buffer(buffer, ohs[1]->via.str.ptr));
+                EXPECT_TRUE(in_buffer(buffer, arr.via.array.ptr[2].via.bin.ptr));
+            }
+        }
+        for (std::size_t i = 0; i < released.size(); ++i) {
+            EXPECT_EQ(1, released[i]);
+        }
+    }
+}
+
+TEST(streaming, feed_reference)
+{
+    msgpack::sbuffer buffer;
+    msgpack::pack(buffer, std::string("hello"));
+    std::size_t first = buffer.size();
+    msgpack::pack(buffer, std::string("spanning"));
+
+    int released1 = 0;
+    int released2 = 0;
+    msgpack::unpacker pac;
+    pac.feed(buffer.data(), first + 3, count_release, &released1);
+
+    msgpack::object_handle oh1;
+    bool referenced = false;
+    EXPECT_TRUE(pac.next(oh1, referenced));
+    EXPECT_TRUE(referenced);
+    EXPECT_EQ(buffer.data() + 1, oh1->via.str.ptr);
+
+    msgpack::object_handle oh2;
+    EXPECT_FALSE(pac.next(oh2));
+    EXPECT_EQ(0u, pac.fed_size());
+    EXPECT_EQ(2u, pac.nonparsed_size());
+
+    pac.feed(buffer.data() + first + 3, buffer.size() - first - 3, count_release, &released2);
+    EXPECT_TRUE(pac.next(oh2));
+    EXPECT_EQ("spanning", oh2->as<std::string>());
+    EXPECT_FALSE(in_buffer(buffer, oh2->via.str.ptr));
+    // only copied from the second buffer
+    EXPECT_EQ(1, released2);
+    EXPECT_EQ(0, released1);
+
+    oh1 = msgpack::object_handle();
+    EXPECT_EQ(1, released1);
+    EXPECT_EQ("spanning", oh2->as<std::string>());
+}
+
+TEST(streaming, feed_and_buffer)
+{
+    msgpack::sbuffer buffer;
+    msgpack::pack(buffer, 1);
+    msgpack::pack(buffer, std::string("abcd"));
+
+    msgpack::unpacker pac;
+    pac.reserve_buffer(buffer.size());
+    std::memcpy(pac.buffer(), buffer.data(), 3);
+    pac.buffer_consumed(3);
+    int released = 0;
+    pac.feed(buffer.data() + 3, buffer.size() - 3, count_release, &released);
+    pac.feed(buffer.data(), 0, count_release, &released);
+    EXPECT_EQ(1, released);
+
+    msgpack::object_handle oh;
+    EXPECT_TRUE(pac.next(oh));
+    EXPECT_EQ(1, oh->as<int>());
+    EXPECT_TRUE(pac.next(oh));
+    EXPECT_EQ("abcd", oh->as<std::string>());
+    EXPECT_FALSE(pac.next(oh));
+    EXPECT_EQ(2, released);
+}
+
+// The hook that can't take fed buffers, like the ones written before feed().
+struct char_only_hook {
+    void operator()(char*) {}
+};
+
+class int_sum_parser : public msgpack::parser<int_sum_parser, char_only_hook>,
+                       public msgpack::null_visitor {
+    typedef msgpack::parser<int_sum_parser, char_only_hook> parser_t;
+public:
+    int_sum_parser():parser_t(m_hook, 16), sum(0), m_ref(false) {}
+    int_sum_parser& visitor() { return *this; }
+    bool visit_positive_integer(uint64_t v) {
+        sum += v;
+        return true;
+    }
+    void set_referenced(bool ref) { m_ref = ref; }
+    bool referenced() const { return m_ref; }
+    uint64_t sum;
+private:
+    char_only_hook m_hook;
+    bool m_ref;
+};
+
+TEST(streaming, feed_char_only_hook)
+{
+    EXPECT_FALSE(msgpack::v2::detail::has_fed_buffer_hook<char_only_hook>::value);
+    msgpack::sbuffer buffer;
+    for (int i = 1; i <= 100; ++i) {
+        msgpack::pack(buffer, i * 1000);
+    }
+    int_sum_parser p;
+    int released = 0;
+    int parsed = 0;
+    // the fed buffers are copied, and released by feed()
+    for (std::size_t off = 0; off < buffer.size(); off += 7) {
+        p.feed(buffer.data() + off, std::min<std::size_t>(7, buffer.size() - off), count_release, &released);
+        EXPECT_EQ(0u, p.fed_size());
+        while (p.next()) ++parsed;
+    }
+    EXPECT_EQ(static_cast<int>((buffer.size() + 6) / 7), released);
+    EXPECT_EQ(100, parsed);
+    EXPECT_EQ(5050000u, p.sum);
+}
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2 && !defined(MSGPACK_USE_CPP03)
+
 class event_handler {
 public:
     event_handler(std::istream& input) : input(input) { }
@@ -0,0 +1,231 @@
+#include <msgpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <sstream>
+#include <vector>
+#include <map>
+#include <string>
+
+#if !defined(MSGPACK_USE_CPP03)
+
+template <typename T>
+struct element_counter_visitor : msgpack::null_visitor {
+    element_counter_visitor()
+        :m_typed(0), m_items(0) {}
+    bool visit_positive_integer(uint64_t v) {
+        m_v.push_back(static_cast<T>(v));
+        return true;
+    }
+    bool visit_float64(double v) {
+        m_v.push_back(static_cast<T>(v));
+        return true;
+    }
+    bool start_array_item() {
+        ++m_items;
+        return true;
+    }
+    std::vector<T> m_v;
+    int m_typed;
+    int m_items;
+};
+
+struct float64_array_visitor : element_counter_visitor<double> {
+    bool visit_float64_array(const char* data, uint32_t num_elements) {
+        ++m_typed;
+        m_v.resize(num_elements);
+        msgpack::decode_float64_array(m_v.data(), data, num_elements);
+        return true;
+    }
+};
+
+template <typename T>
+struct positive_integer_array_visitor : element_counter_visitor<T> {
+    bool visit_positive_integer_array(const char* data, std::size_t size, uint32_t num_elements) {
+        ++this->m_typed;
+        this->m_v.resize(num_elements);
+        msgpack::decode_positive_integer_array(this->m_v.data(), data, size, num_elements);
+        return true;
+    }
+};
+
+struct float32_array_visitor : msgpack::null_visitor {
+    bool visit_float32_array(const char* data, uint32_t num_elements) {
+        m_v.resize(num_elements);
+        msgpack::decode_float32_array(m_v.data(), data, num_elements);
+        return true;
+    }
+    std::vector<float> m_v;
+};
+
+TEST(typed_array, has_typed_array_visitor)
+{
+    EXPECT_FALSE(msgpack::detail::has_typed_array_visitor<msgpack::null_visitor>::value);
+    EXPECT_TRUE(msgpack::detail::has_typed_array_visitor<float64_array_visitor>::value);
+    EXPECT_TRUE(msgpack::detail::has_visit_float32_array<float32_array_visitor>::value);
+    EXPECT_FALSE(msgpack::detail::has_visit_float64_array<float32_array_visitor>::value);
+}
+
+TEST(typed_array, float64)
+{
+    std::vector<double> v;
+    for (int i = 0; i != 1000; ++i) v.push_back(i * 0.25 - 100.0);
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string const& str = ss.str();
+    float64_array_visitor tv;
+    EXPECT_TRUE(msgpack::parse(str.data(), str.size(), tv));
+    EXPECT_EQ(1, tv.m_typed);
+    EXPECT_EQ(0, tv.m_items);
+    EXPECT_EQ(v, tv.m_v);
+}
+
+TEST(typed_array, float32)
+{
+    std::vector<float> v;
+    for (int i = 0; i != 100; ++i) v.push_back(static_cast<float>(i) * 0.5f);
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string const& str = ss.str();
+    float32_array_visitor tv;
+    EXPECT_TRUE(msgpack::parse(str.data(), str.size(), tv));
+    EXPECT_EQ(v, tv.m_v);
+}
+
+TEST(typed_array, uint32_mixed_width)
+{
+    std::vector<uint32_t> v;
+    for (uint32_t i = 0; i != 1000; ++i) v.push_back(i * i * 97);
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string const& str = ss.str();
+    positive_integer_array_visitor<uint32_t> tv;
+    EXPECT_TRUE(msgpack::parse(str.data(), str.size(), tv));
+    EXPECT_EQ(1, tv.m_typed);
+    EXPECT_EQ(0, tv.m_items);
+    EXPECT_EQ(v, tv.m_v);
+}
+
+template <typename T>
+void check_fixint_array()
+{
+    // 16 elements per a vector register and the rest
+    std::vector<uint16_t> v;
+    for (uint16_t i = 0; i != 100; ++i) v.push_back(i);
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string const& str = ss.str();
+    positive_integer_array_visitor<T> tv;
+    EXPECT_TRUE(msgpack::parse(str.data(), str.size(), tv));
+    EXPECT_EQ(1, tv.m_typed);
+    ASSERT_EQ(v.size(), tv.m_v.size());
+    for (std::size_t i = 0; i != v.size(); ++i) {
+        EXPECT_EQ(static_cast<T>(v[i]), tv.m_v[i]);
+    }
+}
+
+TEST(typed_array, fixint)
+{
+    check_fixint_array<uint8_t>();
+    check_fixint_array<uint16_t>();
+    check_fixint_array<uint32_t>();
+    check_fixint_array<uint64_t>();
+    check_fixint_array<int32_t>();
+    check_fixint_array<double>();
+}
+
+TEST(typed_array, positive_integer_overflow)
+{
+    std::vector<uint32_t> v;
+    v.push_back(1);
+    v.push_back(256);
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string const& str = ss.str();
+    positive_integer_array_visitor<uint8_t> tv;
+    EXPECT_THROW(msgpack::parse(str.data(), str.size(), tv), msgpack::type_error);
+}
+
+TEST(typed_array, mixed_types)
+{
+    msgpack::type::tuple<int, double, int> t(1, 2.5, 3);
+    std::stringstream ss;
+    msgpack::pack(ss, t);
+    std::string const& str = ss.str();
+    float64_array_visitor tv;
+    EXPECT_TRUE(msgpack::parse(str.data(), str.size(), tv));
+    EXPECT_EQ(0, tv.m_typed);
+    EXPECT_EQ(3, tv.m_items);
+    ASSERT_EQ(3u, tv.m_v.size());
+    EXPECT_EQ(2.5, tv.m_v[1]);
+}
+
+TEST(typed_array, nested)
+{
+    std::map<std::string, std::vector<double> > m;
+    m["a"].push_back(1.5);
+    m["a"].push_back(2.5);
+    m["b"].push_back(3.5);
+    std::stringstream ss;
+    msgpack::pack(ss, m);
+    msgpack::pack(ss, 42);
+    std::string const& str = ss.str();
+    float64_array_visitor tv;
+    std::size_t off = 0;
+    EXPECT_TRUE(msgpack::parse(str.data(), str.size(), off, tv));
+    EXPECT_EQ(2, tv.m_typed);
+    // the map and its elements are visited as usual
+    msgpack::object_handle oh = msgpack::unpack(str.data(), str.size(), off);
+    EXPECT_EQ(42, oh.get().as<int>());
+    EXPECT_EQ(str.size(), off);
+}
+
+TEST(typed_array, insufficient_bytes)
+{
+    std::vector<double> v(10, 1.0);
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string const& str = ss.str();
+    float64_array_visitor tv;
+    std::size_t off = 0;
+    EXPECT_FALSE(msgpack::parse(str.data(), str.size() - 1, off, tv));
+    EXPECT_EQ(0, tv.m_typed);
+}
+
+struct stop_typed_array_visitor : msgpack::null_visitor {
+    bool visit_float64_array(const char* /*data*/, uint32_t /*num_elements*/) {
+        return false;
+    }
+};
+
+TEST(typed_array, stop_visitor)
+{
+    std::vector<double> v(10, 1.0);
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string const& str = ss.str();
+    stop_typed_array_visitor tv;
+    std::size_t off = 0;
+    EXPECT_FALSE(msgpack::parse(str.data(), str.size(), off, tv));
+}
+
+TEST(typed_array, unpack_is_not_affected)
+{
+    std::vector<double> v(100, 1.0);
+    std::stringstream ss;
+    msgpack::pack(ss, v);
+    std::string const& str = ss.str();
+    msgpack::object_handle oh = msgpack::unpack(str.data(), str.size());
+    EXPECT_EQ(v, oh.get().as<std::vector<double> >());
+}
+
+#endif // !defined(MSGPACK_USE_CPP03)
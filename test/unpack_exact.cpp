@@ -0,0 +1,111 @@
+#include <msgpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <map>
+#include <string>
+#include <vector>
+
+typedef std::map<std::string, std::vector<std::string> > map_type;
+
+static map_type make_map()
+{
+    map_type m;
+    for (int i = 0; i != 20; ++i) {
+        std::string key(static_cast<std::size_t>(i % 7 + 1), static_cast<char>('a' + i));
+        for (int j = 0; j != i; ++j) {
+            m[key].push_back(std::string(static_cast<std::size_t>(j * 13), 'x'));
+        }
+    }
+    return m;
+}
+
+TEST(unpack_exact, one_chunk)
+{
+    msgpack::sbuffer sbuf;
+    map_type m = make_map();
+    msgpack::pack(sbuf, m);
+    msgpack::pack(sbuf, 1);
+
+    std::size_t off = 0;
+    bool referenced = true;
+    msgpack::object_handle oh = msgpack::unpack_exact(sbuf.data(), sbuf.size(), off, referenced);
+    EXPECT_FALSE(referenced);
+    EXPECT_TRUE(oh.get().as<map_type>() == m);
+    msgpack::zone_stats s = oh.zone()->stats();
+    EXPECT_EQ(1u, s.chunks);
+    EXPECT_EQ(s.reserved, s.requested + s.padding);
+    EXPECT_EQ(s.reserved, msgpack::unpacked_zone_size(sbuf.data(), sbuf.size()));
+
+    oh = msgpack::unpack_exact(sbuf.data(), sbuf.size(), off);
+    EXPECT_EQ(1, oh.get().as<int>());
+    EXPECT_EQ(sbuf.size(), off);
+    EXPECT_EQ(0u, oh.zone()->stats().reserved);
+}
+
+static bool reference_long(msgpack::type::object_type, std::size_t size, void*)
+{
+    return size >= 100;
+}
+
+TEST(unpack_exact, reference)
+{
+    msgpack::sbuffer sbuf;
+    map_type m = make_map();
+    msgpack::pack(sbuf, m);
+
+    bool referenced = false;
+    msgpack::object_handle oh = msgpack::unpack_exact(sbuf.data(), sbuf.size(), referenced, reference_long);
+    EXPECT_TRUE(referenced);
+    EXPECT_TRUE(oh.get().as<map_type>() == m);
+    msgpack::zone_stats s = oh.zone()->stats();
+    EXPECT_EQ(1u, s.chunks);
+    EXPECT_EQ(s.reserved, s.requested + s.padding);
+    EXPECT_GT(msgpack::unpacked_zone_size(sbuf.data(), sbuf.size()), s.reserved);
+}
+
+TEST(unpack_exact, bin_ext_and_empty)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::packer<msgpack::sbuffer> pk(sbuf);
+    pk.pack_array(5);
+    pk.pack_bin(3);
+    pk.pack_bin_body("abc", 3);
+    pk.pack_ext(1, 2);
+    pk.pack_ext_body("d", 1);
+    pk.pack_array(0);
+    pk.pack_map(0);
+    pk.pack_str(0);
+
+    msgpack::object_handle oh = msgpack::unpack_exact(sbuf.data(), sbuf.size());
+    msgpack::object const& o = oh.get();
+    EXPECT_EQ(5u, o.via.array.size);
+    EXPECT_EQ(std::string("abc"), std::string(o.via.array.ptr[0].via.bin.ptr, 3));
+    EXPECT_EQ(2, o.via.array.ptr[1].via.ext.type());
+    msgpack::zone_stats s = oh.zone()->stats();
+    EXPECT_EQ(1u, s.chunks);
+    EXPECT_EQ(s.reserved, s.requested + s.padding);
+}
+
+TEST(unpack_exact, error)
+{
+    msgpack::sbuffer sbuf;
+    msgpack::pack(sbuf, make_map());
+    EXPECT_THROW(msgpack::unpack_exact(sbuf.data(), sbuf.size() - 1), msgpack::insufficient_bytes);
+    EXPECT_THROW(msgpack::unpack_exact("\xc1", 1), msgpack::parse_error);
+    EXPECT_THROW(msgpack::unpack_exact(sbuf.data(), sbuf.size(), MSGPACK_NULLPTR, MSGPACK_NULLPTR,
+                                       msgpack::unpack_limit(100, 10)),
+                 msgpack::map_size_overflow);
+    EXPECT_THROW(msgpack::unpacked_zone_size(sbuf.data(), sbuf.size(), 0, MSGPACK_NULLPTR, MSGPACK_NULLPTR,
+                                             msgpack::unpack_limit(100, 100, 10)),
+                 msgpack::str_size_overflow);
+}
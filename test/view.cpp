@@ -0,0 +1,192 @@
+#include <msgpack.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+
+// To avoid link error
+TEST(view, dummy)
+{
+}
+
+#if MSGPACK_DEFAULT_API_VERSION >= 2
+
+namespace {
+
+std::string make_message()
+{
+    std::stringstream ss;
+    msgpack::packer<std::stringstream> pk(ss);
+    pk.pack_map(4);
+    pk.pack(std::string("id"));
+    pk.pack(12345);
+    pk.pack(std::string("user"));
+    pk.pack_map(2);
+    pk.pack(std::string("name"));
+    pk.pack(std::string("alice"));
+    pk.pack(std::string("age"));
+    pk.pack(-20);
+    pk.pack(std::string("items"));
+    std::vector<int> items;
+    for (int i = 0; i != 100; ++i) items.push_back(i * 1000);
+    pk.pack(items);
+    pk.pack(std::string("payload"));
+    pk.pack(std::string(1000, 'x'));
+    return ss.str();
+}
+
+} // anonymous namespace
+
+TEST(view, type_and_size)
+{
+    std::string str = make_message();
+    msgpack::view v(str.data(), str.size());
+    EXPECT_TRUE(v.valid());
+    EXPECT_EQ(msgpack::type::MAP, v.type());
+    EXPECT_EQ(4u, v.size());
+    EXPECT_EQ(msgpack::type::POSITIVE_INTEGER, v.find("id").type());
+    EXPECT_EQ(msgpack::type::NEGATIVE_INTEGER, v.find("user").find("age").type());
+    EXPECT_EQ(msgpack::type::ARRAY, v.find("items").type());
+    EXPECT_EQ(100u, v.find("items").size());
+    EXPECT_EQ(msgpack::type::STR, v.find("payload").type());
+    EXPECT_EQ(1000u, v.find("payload").size());
+    EXPECT_THROW(v.find("id").size(), msgpack::type_error);
+}
+
+TEST(view, find)
+{
+    std::string str = make_message();
+    msgpack::view v(str.data(), str.size());
+    EXPECT_EQ(12345, v.find("id").as<int>());
+    EXPECT_EQ("alice", v.find(std::string("user")).find("name").as<std::string>());
+    EXPECT_EQ(-20, v.find("user").find("age", 3).as<int>());
+    EXPECT_FALSE(v.find("none").valid());
+    EXPECT_FALSE(v.find("i").valid());
+    EXPECT_THROW(v.find("id").find("x"), msgpack::type_error);
+}
+
+TEST(view, array)
+{
+    std::string str = make_message();
+    msgpack::view v(str.data(), str.size());
+    msgpack::view items = v.find("items");
+    EXPECT_EQ(99000, items[99].as<int>());
+    EXPECT_EQ(0, items[0].as<int>());
+    EXPECT_EQ(50000, items[50].as<int>());
+    EXPECT_THROW(items[100], std::out_of_range);
+    EXPECT_THROW(v[0], msgpack::type_error);
+    std::vector<int> vec = items.as<std::vector<int> >();
+    EXPECT_EQ(100u, vec.size());
+    EXPECT_EQ(1000, vec[1]);
+}
+
+TEST(view, key_value)
+{
+    std::string str = make_message();
+    msgpack::view v(str.data(), str.size());
+    EXPECT_EQ("id", v.key(0).as<std::string>());
+    EXPECT_EQ(12345, v.value(0).as<int>());
+    EXPECT_EQ("payload", v.key(3).as<std::string>());
+    EXPECT_THROW(v.key(4), std::out_of_range);
+    std::map<std::string, std::string> m;
+    EXPECT_THROW(v.find("user").convert(m), msgpack::type_error);
+}
+
+TEST(view, to_object_refers_buffer)
+{
+    std::string str = make_message();
+    msgpack::view v(str.data(), str.size());
+    msgpack::zone z;
+    msgpack::object obj = v.find("user").to_object(z);
+    EXPECT_EQ(msgpack::type::MAP, obj.type);
+    EXPECT_EQ(msgpack::type::STR, obj.via.map.ptr[0].val.type);
+    EXPECT_TRUE(obj.via.map.ptr[0].val.via.str.ptr >= str.data());
+    EXPECT_TRUE(obj.via.map.ptr[0].val.via.str.ptr < str.data() + str.size());
+    msgpack::object scalar = v.find("payload").to_object(z);
+    EXPECT_EQ(str.data() + str.size() - 1000, scalar.via.str.ptr);
+}
+
+TEST(view, same_as_unpack)
+{
+    std::string str = make_message();
+    msgpack::object_handle oh = msgpack::unpack(str.data(), str.size());
+    msgpack::view v(str.data(), str.size());
+    msgpack::zone z;
+    EXPECT_EQ(oh.get(), v.to_object(z));
+    for (uint32_t i = 0; i != v.size(); ++i) {
+        EXPECT_EQ(oh.get().via.map.ptr[i].key, v.key(i).to_object(z));
+        EXPECT_EQ(oh.get().via.map.ptr[i].val, v.value(i).to_object(z));
+    }
+}
+
+TEST(view, signed_encoding)
+{
+    std::stringstream ss;
+    msgpack::packer<std::stringstream> pk(ss);
+    pk.pack_fix_int8(5);
+    pk.pack_fix_int16(-300);
+    std::string str = ss.str();
+    msgpack::view v1(str.data(), 2);
+    EXPECT_EQ(msgpack::type::POSITIVE_INTEGER, v1.type());
+    EXPECT_EQ(5u, v1.as<unsigned int>());
+    msgpack::view v2(str.data() + 2, 3);
+    EXPECT_EQ(msgpack::type::NEGATIVE_INTEGER, v2.type());
+    EXPECT_EQ(-300, v2.as<int>());
+}
+
+TEST(view, lazy)
+{
+    std::string str = make_message();
+    // The last value is truncated. The preceding values can be read.
+    msgpack::view v(str.data(), str.size() - 1);
+    EXPECT_EQ(12345, v.find("id").as<int>());
+    EXPECT_EQ(99000, v.find("items")[99].as<int>());
+    EXPECT_THROW(v.find("payload"), msgpack::insufficient_bytes);
+    // The truncated value is not touched.
+    EXPECT_FALSE(v.find("none").valid());
+}
+
+TEST(view, parse_error)
+{
+    char const data[] = { static_cast<char>(0x92u), 0x01, static_cast<char>(0xc1u) };
+    msgpack::view v(data, sizeof(data));
+    EXPECT_EQ(1, v[0].as<int>());
+    EXPECT_THROW(v[1], msgpack::parse_error);
+    msgpack::view empty(data, 0);
+    EXPECT_THROW(empty.type(), msgpack::insufficient_bytes);
+}
+
+TEST(view, ext_bin)
+{
+    std::stringstream ss;
+    msgpack::packer<std::stringstream> pk(ss);
+    pk.pack_array(2);
+    pk.pack_bin(3);
+    pk.pack_bin_body("abc", 3);
+    pk.pack_ext(4, 1);
+    pk.pack_ext_body("wxyz", 4);
+    std::string str = ss.str();
+    msgpack::view v(str.data(), str.size());
+    EXPECT_EQ(msgpack::type::BIN, v[0].type());
+    EXPECT_EQ(3u, v[0].size());
+    EXPECT_EQ(msgpack::type::EXT, v[1].type());
+    EXPECT_EQ(4u, v[1].size());
+    msgpack::zone z;
+    msgpack::object obj = v[1].to_object(z);
+    EXPECT_EQ(1, obj.via.ext.type());
+    EXPECT_EQ(0, std::memcmp(obj.via.ext.data(), "wxyz", 4));
+}
+
+#endif // MSGPACK_DEFAULT_API_VERSION >= 2
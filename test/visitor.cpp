@@ -494,4 +494,86 @@ TEST(visitor, return_false_end_map0)
     EXPECT_EQ(0u, off);
 }
 
+struct insuf_bytes_offset_visitor : msgpack::null_visitor {
+    insuf_bytes_offset_visitor(std::size_t& error_offset):m_error_offset(error_offset) {}
+    void insufficient_bytes(size_t /*parsed_offset*/, size_t error_offset) {
+        m_error_offset = error_offset;
+    }
+    std::size_t& m_error_offset;
+};
+
+TEST(visitor, insuf_bytes_fixed_trail)
+{
+    std::size_t error_offset = 0;
+    insuf_bytes_offset_visitor v(error_offset);
+    std::size_t off = 0;
+    // uint32 that has only 2 bytes of the trail
+    char const data[] = { static_cast<char>(0x92u), 0x01u, static_cast<char>(0xceu), 0x01u, 0x02u };
+    bool ret = msgpack::parse(data, sizeof(data), off, v);
+    EXPECT_FALSE(ret);
+    EXPECT_EQ(3u, error_offset);
+    EXPECT_EQ(3u, off);
+}
+
+TEST(visitor, insuf_bytes_str_body)
+{
+    std::size_t error_offset = 0;
+    insuf_bytes_offset_visitor v(error_offset);
+    std::size_t off = 0;
+    // str8 that has only 1 byte of 3 bytes body
+    char const data[] = { static_cast<char>(0x92u), 0x01u, static_cast<char>(0xd9u), 0x03u, 'a' };
+    bool ret = msgpack::parse(data, sizeof(data), off, v);
+    EXPECT_FALSE(ret);
+    EXPECT_EQ(4u, error_offset);
+    EXPECT_EQ(4u, off);
+}
+
+TEST(visitor, parse_same_as_stream)
+{
+    std::stringstream ss;
+    msgpack::packer<std::stringstream> pk(ss);
+    pk.pack_array(20);
+    pk.pack_nil();
+    pk.pack_true();
+    pk.pack_false();
+    pk.pack_fix_uint8(1);
+    pk.pack_uint8(200);
+    pk.pack_uint16(60000);
+    pk.pack_uint32(4000000000u);
+    pk.pack_uint64(1ULL << 40);
+    pk.pack_fix_int8(-1);
+    pk.pack_int8(-100);
+    pk.pack_int16(-30000);
+    pk.pack_int32(-2000000000);
+    pk.pack_int64(-(1LL << 40));
+    pk.pack_float(1.5f);
+    pk.pack_double(-2.5);
+    pk.pack(std::string("abc"));
+    pk.pack(std::string(300, 'x'));
+    pk.pack_bin(2);
+    pk.pack_bin_body("\x01\x02", 2);
+    pk.pack_ext(3, 1);
+    pk.pack_ext_body("\x01\x02\x03", 3);
+    pk.pack_map(1);
+    pk.pack(std::string(""));
+    pk.pack_array(0);
+    std::string const& str = ss.str();
+
+    msgpack::unpacker unp;
+    for (std::size_t i = 0; i != str.size(); ++i) {
+        std::size_t off = 0;
+        std::size_t error_offset = 0;
+        insuf_bytes_offset_visitor v(error_offset);
+        EXPECT_FALSE(msgpack::parse(str.data(), i, off, v));
+
+        unp.reserve_buffer(1);
+        unp.buffer()[0] = str[i];
+        unp.buffer_consumed(1);
+    }
+    msgpack::object_handle stream_oh;
+    EXPECT_TRUE(unp.next(stream_oh));
+    msgpack::object_handle oh = msgpack::unpack(str.data(), str.size());
+    EXPECT_EQ(stream_oh.get(), oh.get());
+}
+
 #endif // MSGPACK_DEFAULT_API_VERSION >= 1
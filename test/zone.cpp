@@ -101,3 +101,235 @@ TEST(zone, allocate_no_align)
     char* buf2 = (char*)z.allocate_no_align(4);
     EXPECT_EQ(buf1+4, buf2);
 }
+
+
+TEST(zone, buffer)
+{
+    char buffer[1024];
+    msgpack::zone z(buffer, sizeof(buffer));
+    char* p = static_cast<char*>(z.allocate_align(100));
+    EXPECT_TRUE(p >= buffer && p + 100 <= buffer + sizeof(buffer));
+
+    // spill to the heap, and back to the buffer after clear
+    p = static_cast<char*>(z.allocate_align(sizeof(buffer)));
+    EXPECT_TRUE(p < buffer || p >= buffer + sizeof(buffer));
+    z.clear();
+    p = static_cast<char*>(z.allocate_align(sizeof(buffer) / 2));
+    EXPECT_TRUE(p >= buffer && p < buffer + sizeof(buffer));
+}
+
+
+TEST(zone, inline_zone)
+{
+    msgpack::sbuffer sbuf;
+    std::map<std::string, std::vector<int> > m;
+    m["a"].push_back(1);
+    m["bcd"].push_back(2);
+    m["bcd"].push_back(3);
+    msgpack::pack(sbuf, m);
+
+    msgpack::inline_zone<2048> z;
+    const char* begin = reinterpret_cast<const char*>(&z);
+    const char* end = begin + sizeof(z);
+    msgpack::object obj = msgpack::unpack(z, sbuf.data(), sbuf.size());
+    typedef std::map<std::string, std::vector<int> > map_type;
+    EXPECT_TRUE(obj.as<map_type>() == m);
+    const char* p = reinterpret_cast<const char*>(obj.via.map.ptr);
+    EXPECT_TRUE(p >= begin && p < end);
+    p = reinterpret_cast<const char*>(obj.via.map.ptr[1].val.via.array.ptr);
+    EXPECT_TRUE(p >= begin && p < end);
+
+    myclass* mc = z.allocate<myclass>(1, "inline");
+    EXPECT_EQ(1, mc->num);
+    p = reinterpret_cast<const char*>(mc);
+    EXPECT_TRUE(p >= begin && p < end);
+
+    p = static_cast<const char*>(z.allocate_align(4096));
+    EXPECT_TRUE(p < begin || p >= end);
+    z.clear();
+    p = static_cast<const char*>(z.allocate_align(16));
+    EXPECT_TRUE(p >= begin && p < end);
+}
+
+
+TEST(zone, growth)
+{
+    msgpack::zone fixed(1024);
+    fixed.allocate_no_align(1024);
+    fixed.allocate_no_align(1);
+    fixed.allocate_no_align(1024);
+    EXPECT_EQ(3u, fixed.stats().chunks);
+    EXPECT_EQ(3u * 1024, fixed.stats().reserved);
+
+    msgpack::zone geometric(1024);
+    geometric.set_growth(msgpack::ZONE_GROWTH_GEOMETRIC);
+    geometric.allocate_no_align(1024);
+    geometric.allocate_no_align(1);
+    geometric.allocate_no_align(2048);
+    geometric.allocate_no_align(1);
+    EXPECT_EQ(3u, geometric.stats().chunks);
+    EXPECT_EQ(1024u + 2048 + 4096, geometric.stats().reserved);
+
+    msgpack::zone capped(1024);
+    capped.set_growth(msgpack::ZONE_GROWTH_CAPPED_GEOMETRIC, 2048);
+    for (int i = 0; i != 4; ++i) {
+        capped.allocate_no_align(2048);
+    }
+    EXPECT_EQ(5u, capped.stats().chunks);
+    EXPECT_EQ(1024u + 4 * 2048, capped.stats().reserved);
+
+    // the growth restarts after clear
+    geometric.clear();
+    geometric.allocate_no_align(1024);
+    geometric.allocate_no_align(1);
+    EXPECT_EQ(1024u + 2048, geometric.stats().reserved);
+}
+
+
+struct counting_allocator {
+    counting_allocator():blocks(0), bytes(0) {}
+    static void* allocate(void* user_data, size_t size)
+    {
+        counting_allocator* self = static_cast<counting_allocator*>(user_data);
+        ++self->blocks;
+        self->bytes += size;
+        return ::malloc(size);
+    }
+    static void deallocate(void* user_data, void* p, size_t size)
+    {
+        counting_allocator* self = static_cast<counting_allocator*>(user_data);
+        --self->blocks;
+        self->bytes -= size;
+        ::free(p);
+    }
+    size_t blocks;
+    size_t bytes;
+};
+
+TEST(zone, allocator)
+{
+    counting_allocator a;
+    {
+        msgpack::zone z(msgpack::zone_allocator(&counting_allocator::allocate,
+                                                &counting_allocator::deallocate, &a), 1024);
+        EXPECT_EQ(1u, a.blocks);
+        z.allocate_no_align(4096);
+        EXPECT_EQ(2u, a.blocks);
+        EXPECT_LT(1024u + 4096, a.bytes);
+        z.clear();
+        EXPECT_EQ(1u, a.blocks);
+        z.allocate_no_align(4096);
+    }
+    EXPECT_EQ(0u, a.blocks);
+    EXPECT_EQ(0u, a.bytes);
+}
+
+TEST(zone, allocator_half_set)
+{
+    counting_allocator a;
+    EXPECT_THROW(msgpack::zone(msgpack::zone_allocator(&counting_allocator::allocate, MSGPACK_NULLPTR, &a)),
+                 std::invalid_argument);
+    EXPECT_THROW(msgpack::zone(msgpack::zone_allocator(MSGPACK_NULLPTR, &counting_allocator::deallocate, &a)),
+                 std::invalid_argument);
+    EXPECT_EQ(0u, a.blocks);
+    // neither is set, the default is used
+    msgpack::zone z((msgpack::zone_allocator()));
+    EXPECT_TRUE(z.allocate_no_align(1) != MSGPACK_NULLPTR);
+}
+
+
+TEST(zone, stats)
+{
+    msgpack::zone z(1024);
+    msgpack::zone_stats s = z.stats();
+    EXPECT_EQ(0u, s.requested);
+    EXPECT_EQ(1024u, s.reserved);
+    EXPECT_EQ(1u, s.chunks);
+    EXPECT_EQ(0u, s.padding);
+    EXPECT_EQ(0u, s.finalizers);
+
+    z.allocate_no_align(1);
+    z.allocate_align(8, 8);
+    z.allocate<myclass>();
+    z.allocate_no_align(2000);
+    s = z.stats();
+    EXPECT_EQ(1u + 8 + sizeof(myclass) + 2000, s.requested);
+    EXPECT_EQ(1024u + 2048, s.reserved);
+    EXPECT_EQ(2u, s.chunks);
+    EXPECT_EQ(7u, s.padding);
+    EXPECT_EQ(1u, s.finalizers);
+
+    z.clear();
+    s = z.stats();
+    EXPECT_EQ(0u, s.requested);
+    EXPECT_EQ(1024u, s.reserved);
+    EXPECT_EQ(1u, s.chunks);
+    EXPECT_EQ(0u, s.finalizers);
+}
+
+
+struct zone_pod {
+    int a;
+    double b;
+};
+
+TEST(zone, allocate_trivially_destructible)
+{
+    msgpack::zone z;
+    zone_pod* p = z.allocate<zone_pod>();
+    int* i = z.allocate<int>(7);
+    EXPECT_EQ(7, *i);
+    p->a = 1;
+    EXPECT_EQ(0u, z.stats().finalizers);
+    z.allocate<myclass>();
+    EXPECT_EQ(1u, z.stats().finalizers);
+}
+
+
+struct zone_counted {
+    zone_counted() {
+        if (limit == 0) throw std::runtime_error("limit");
+        --limit;
+        ++alive;
+    }
+    ~zone_counted() {
+        --alive;
+    }
+    static int alive;
+    static int limit;
+};
+int zone_counted::alive = 0;
+int zone_counted::limit = 0;
+
+TEST(zone, allocate_array)
+{
+    {
+        msgpack::zone z;
+        zone_pod* p = z.allocate_array<zone_pod>(100);
+        EXPECT_EQ(0, p[99].a);
+        EXPECT_EQ(0u, reinterpret_cast<std::size_t>(p) % MSGPACK_ZONE_ALIGNOF(zone_pod));
+        EXPECT_EQ(0u, z.stats().finalizers);
+
+        zone_counted::limit = 100;
+        zone_counted* c = z.allocate_array<zone_counted>(10);
+        EXPECT_EQ(0u, reinterpret_cast<std::size_t>(c) % MSGPACK_ZONE_ALIGNOF(zone_counted));
+        EXPECT_EQ(10, zone_counted::alive);
+        EXPECT_EQ(1u, z.stats().finalizers);
+
+        myclass* m = z.allocate_array<myclass>(3);
+        EXPECT_EQ("default", m[2].str);
+        EXPECT_EQ(2u, z.stats().finalizers);
+    }
+    EXPECT_EQ(0, zone_counted::alive);
+}
+
+
+TEST(zone, allocate_array_exception)
+{
+    msgpack::zone z;
+    zone_counted::limit = 5;
+    EXPECT_THROW(z.allocate_array<zone_counted>(10), std::runtime_error);
+    EXPECT_EQ(0, zone_counted::alive);
+    EXPECT_EQ(0u, z.stats().finalizers);
+    EXPECT_EQ(0u, z.stats().requested);
+}
@@ -0,0 +1,146 @@
+#include <msgpack.hpp>
+#include <msgpack/zbuffer.hpp>
+#include <msgpack/zunpacker.hpp>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wconversion"
+#endif //defined(__GNUC__)
+
+#include <gtest/gtest.h>
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif //defined(__GNUC__)
+
+#include <string>
+#include <vector>
+
+static void pack_objects(msgpack::zbuffer& zbuf, int begin, int end)
+{
+    for (int i = begin; i != end; ++i) {
+        msgpack::pack(zbuf, i);
+        msgpack::pack(zbuf, std::string(static_cast<size_t>(i % 100), 'a'));
+    }
+    zbuf.flush();
+}
+
+static void expect_objects(msgpack::zunpacker& zunp, msgpack::unpacker& unp, int& i)
+{
+    msgpack::object_handle oh;
+    while (zunp.next(unp, oh)) {
+        if (oh.get().type == msgpack::type::POSITIVE_INTEGER) {
+            EXPECT_EQ(i, oh.get().as<int>());
+        } else {
+            EXPECT_EQ(std::string(static_cast<size_t>(i % 100), 'a'), oh.get().as<std::string>());
+            ++i;
+        }
+    }
+}
+
+TEST(zunpacker, zlib)
+{
+    msgpack::zbuffer zbuf;
+    pack_objects(zbuf, 0, 1000);
+
+    // fed by small pieces
+    msgpack::unpacker unp;
+    msgpack::zunpacker zunp;
+    int i = 0;
+    for (size_t off = 0; off < zbuf.size(); off += 7) {
+        zunp.feed(zbuf.data() + off, std::min<size_t>(7, zbuf.size() - off));
+        expect_objects(zunp, unp, i);
+    }
+    EXPECT_EQ(1000, i);
+    EXPECT_EQ(zbuf.size(), zunp.total_in());
+}
+
+TEST(zunpacker, raw_deflate)
+{
+    msgpack::sbuffer sbuf;
+    for (int i = 0; i != 1000; ++i) {
+        msgpack::pack(sbuf, i);
+        msgpack::pack(sbuf, std::string(static_cast<size_t>(i % 100), 'a'));
+    }
+
+    z_stream s;
+    s.zalloc = Z_NULL;
+    s.zfree = Z_NULL;
+    s.opaque = Z_NULL;
+    ASSERT_EQ(Z_OK, deflateInit2(&s, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY));
+    std::vector<char> raw(deflateBound(&s, static_cast<uLong>(sbuf.size())));
+    s.next_in = reinterpret_cast<Bytef*>(sbuf.data());
+    s.avail_in = static_cast<uInt>(sbuf.size());
+    s.next_out = reinterpret_cast<Bytef*>(&raw[0]);
+    s.avail_out = static_cast<uInt>(raw.size());
+    ASSERT_EQ(Z_STREAM_END, deflate(&s, Z_FINISH));
+    raw.resize(s.total_out);
+    deflateEnd(&s);
+
+    msgpack::unpacker unp;
+    msgpack::zunpacker zunp(-MAX_WBITS);
+    zunp.feed(&raw[0], raw.size());
+    int i = 0;
+    expect_objects(zunp, unp, i);
+    EXPECT_EQ(1000, i);
+    EXPECT_EQ(sbuf.size(), zunp.total_out());
+}
+
+TEST(zunpacker, concatenated_streams)
+{
+    msgpack::zbuffer zbuf;
+    pack_objects(zbuf, 0, 10);
+    std::string data(zbuf.data(), zbuf.size());
+    zbuf.reset();
+    pack_objects(zbuf, 10, 20);
+    data.append(zbuf.data(), zbuf.size());
+
+    msgpack::unpacker unp;
+    msgpack::zunpacker zunp;
+    zunp.feed(data.data(), data.size());
+    int i = 0;
+    expect_objects(zunp, unp, i);
+    EXPECT_EQ(20, i);
+}
+
+TEST(zunpacker, bounded_buffer)
+{
+    // about 1MB of nils is compressed to about 1KB
+    msgpack::zbuffer zbuf;
+    for (int i = 0; i != 1000000; ++i) {
+        msgpack::pack(zbuf, msgpack::type::nil_t());
+    }
+    zbuf.flush();
+    EXPECT_GT(10000u, zbuf.size());
+
+    msgpack::unpacker unp;
+    msgpack::zunpacker zunp;
+    zunp.feed(zbuf.data(), zbuf.size());
+    msgpack::object_handle oh;
+    int n = 0;
+    while (zunp.next(unp, oh)) {
+        ++n;
+    }
+    EXPECT_EQ(1000000, n);
+    EXPECT_GE(2u * MSGPACK_UNPACKER_INIT_BUFFER_SIZE, unp.buffer_capacity());
+}
+
+TEST(zunpacker, parse_error)
+{
+    msgpack::zbuffer zbuf;
+    pack_objects(zbuf, 0, 10);
+    std::string data(zbuf.data(), zbuf.size());
+    data[0] = 0;
+
+    msgpack::unpacker unp;
+    msgpack::zunpacker zunp;
+    zunp.feed(data.data(), data.size());
+    msgpack::object_handle oh;
+    EXPECT_THROW(zunp.next(unp, oh), msgpack::parse_error);
+
+    zunp.reset();
+    zunp.feed(zbuf.data(), zbuf.size());
+    int i = 0;
+    expect_objects(zunp, unp, i);
+    EXPECT_EQ(10, i);
+}